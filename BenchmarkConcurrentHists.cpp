@@ -0,0 +1,164 @@
+//File: BenchmarkConcurrentHists.cpp
+//Brief: Times the two ways util/ConcurrentHist.h lets threads Fill() the same histograms:
+//       Sharded<> copies per thread and Atomic adds to one shared copy.  Runs every
+//       combination of thread count and bin count, and compares each against a
+//       single-threaded FlatHistWrapper<> to make sure they got the same answer.
+//
+//       Usage:
+//       BenchmarkConcurrentHists [nEvents=1000000] [nUniverses=100] [maxThreads=<every core>]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/ConcurrentHist.h"
+
+//ROOT includes
+#include "TH1.h"
+
+//c++ includes
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#define USAGE "USAGE: BenchmarkConcurrentHists [nEvents=1000000] [nUniverses=100] [maxThreads=<every core>]\n"
+
+namespace
+{
+  //Just enough of a universe for UniverseLayout
+  struct Universe
+  {
+    bool IsVerticalOnly() const { return true; }
+    std::string ShortName() const { return "benchmark"; }
+  };
+
+  using timer = std::chrono::steady_clock;
+
+  double secondsSince(const timer::time_point start)
+  {
+    return std::chrono::duration<double>(timer::now() - start).count();
+  }
+
+  struct Timing
+  {
+    double fill;
+    double write;
+  };
+
+  //Fill every universe for every event, splitting events among nThreads threads
+  //the same way RebinSelectionTable does.  Then, time adding up the universes.
+  template <class HIST>
+  Timing run(HIST& hist, const std::vector<Universe>& univs, const std::vector<double>& values, const std::vector<double>& weights, const size_t nThreads)
+  {
+    const auto fillStart = timer::now();
+    std::vector<std::thread> threads;
+    for(size_t whichThread = 0; whichThread < nThreads; ++whichThread)
+    {
+      threads.emplace_back([&, whichThread]()
+                           {
+                             util::ShardScope shard(whichThread);
+                             for(size_t event = whichThread; event < values.size(); event += nThreads)
+                             {
+                               for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv)
+                               {
+                                 hist.FillUniverse(univs[whichUniv], values[event], weights[event] * (1. + 0.001 * whichUniv));
+                               }
+                             }
+                           });
+    }
+    for(auto& thread: threads) thread.join();
+    const double fill = secondsSince(fillStart);
+
+    const auto writeStart = timer::now();
+    hist.SyncCVHistos();
+    return Timing{fill, secondsSince(writeStart)};
+  }
+
+  //Largest relative difference in any CV bin
+  double maxDifference(const TH1& result, const TH1& expected)
+  {
+    double worst = 0;
+    for(int bin = 0; bin <= expected.GetNbinsX() + 1; ++bin)
+    {
+      const double scale = std::max(std::fabs(expected.GetBinContent(bin)), 1e-12);
+      worst = std::max(worst, std::fabs(result.GetBinContent(bin) - expected.GetBinContent(bin)) / scale);
+    }
+    return worst;
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  TH1::AddDirectory(kFALSE);
+
+  if(argc > 4)
+  {
+    std::cerr << "Expected at most 3 arguments, but you passed " << argc - 1 << ".\n\n" << USAGE;
+    return 1;
+  }
+
+  const size_t nEvents = (argc > 1)?std::stoul(argv[1]):1000000,
+               nUniverses = (argc > 2)?std::stoul(argv[2]):100,
+               maxThreads = (argc > 3)?std::stoul(argv[3]):std::max(1u, std::thread::hardware_concurrency());
+  if(nEvents == 0 || nUniverses == 0 || maxThreads == 0)
+  {
+    std::cerr << "Every argument has to be at least 1.\n\n" << USAGE;
+    return 1;
+  }
+
+  util::ShardScope::setNShards(maxThreads);
+
+  std::vector<Universe> univs(nUniverses);
+  std::map<std::string, std::vector<Universe*>> bands{{"cv", {&univs.front()}}};
+  for(auto univ = std::next(univs.begin()); univ != univs.end(); ++univ) bands["Benchmark"].push_back(&*univ);
+
+  //Same events for every test
+  std::mt19937 generator(20211019);
+  std::uniform_real_distribution<double> value(-0.1, 1.1), weight(0.5, 1.5);
+  std::vector<double> values(nEvents), weights(nEvents);
+  for(size_t event = 0; event < nEvents; ++event)
+  {
+    values[event] = value(generator);
+    weights[event] = weight(generator);
+  }
+
+  std::vector<size_t> threadCounts;
+  for(size_t nThreads = 1; nThreads < maxThreads; nThreads *= 2) threadCounts.push_back(nThreads);
+  threadCounts.push_back(maxThreads);
+
+  std::cout << "#" << nEvents << " events filling " << nUniverses << " universes each.  Times in seconds.  Differences are relative to 1 thread without sharing.\n"
+            << std::setw(8) << "bins" << std::setw(8) << "threads"
+            << std::setw(14) << "serial fill" << std::setw(14) << "serial write"
+            << std::setw(14) << "sharded fill" << std::setw(14) << "sharded write" << std::setw(14) << "sharded diff"
+            << std::setw(14) << "atomic fill" << std::setw(14) << "atomic write" << std::setw(14) << "atomic diff" << "\n";
+
+  for(const int nBins: {10, 100, 1000, 10000})
+  {
+    util::FlatHistWrapper<Universe> serial("serial", "serial", nBins, 0, 1, bands);
+    const auto serialTime = run(serial, univs, values, weights, 1);
+
+    for(const size_t nThreads: threadCounts)
+    {
+      util::FlatHistWrapper<Universe, util::Sharded<>> sharded("sharded", "sharded", nBins, 0, 1, bands);
+      const auto shardedTime = run(sharded, univs, values, weights, nThreads);
+
+      util::FlatHistWrapper<Universe, util::Atomic> atomic("atomic", "atomic", nBins, 0, 1, bands);
+      const auto atomicTime = run(atomic, univs, values, weights, nThreads);
+
+      std::cout << std::setw(8) << nBins << std::setw(8) << nThreads
+                << std::setw(14) << serialTime.fill << std::setw(14) << serialTime.write
+                << std::setw(14) << shardedTime.fill << std::setw(14) << shardedTime.write << std::setw(14) << maxDifference(*sharded.hist, *serial.hist)
+                << std::setw(14) << atomicTime.fill << std::setw(14) << atomicTime.write << std::setw(14) << maxDifference(*atomic.hist, *serial.hist) << "\n";
+
+      delete sharded.hist;
+      delete atomic.hist;
+    }
+
+    delete serial.hist;
+  }
+
+  return 0;
+}
@@ -9,6 +9,7 @@
 
 //util includes
 #include "util/GetIngredient.h"
+#include "util/HistIndex.h"
 
 //UnfoldUtils includes
 #pragma GCC diagnostic push
@@ -24,7 +25,6 @@
 //ROOT includes
 #include "TH1D.h"
 #include "TFile.h"
-#include "TKey.h"
 #include "TParameter.h"
 #include "TCanvas.h"
 
@@ -51,19 +51,6 @@ namespace
                                                                  {"2p2h Tune", {"Low_Recoil_2p2h_Tune"}}};
 }
 
-//Convince the STL to talk to TIter so I can use std::find_if()
-namespace std
-{
-  template <>
-  struct iterator_traits<TIter>
-  {
-    using value_type = TObject;
-    using pointer = TObject*;
-    using reference = TObject&;
-    using iterator_category = forward_iterator_tag;
-  };
-}
-
 //Plot a step in cross section extraction.
 void Plot(PlotUtils::MnvH1D& hist, const std::string& stepName, const std::string& prefix)
 {
@@ -271,62 +258,60 @@ int main(const int argc, const char** argv)
     return 3;
   }
 
-  std::vector<std::string> crossSectionPrefixes;
-  for(auto key: *dataFile->GetListOfKeys())
-  {
-    const std::string keyName = key->GetName();
-    const size_t endOfPrefix = keyName.find("_Signal");
-    if(endOfPrefix != std::string::npos) crossSectionPrefixes.push_back(keyName.substr(0, endOfPrefix));
-  }
+  using Role = util::HistIndex::Role;
+  const util::HistIndex dataIndex(*dataFile), mcIndex(*mcFile);
 
   const double mcPOT = util::GetIngredient<TParameter<double>>(*mcFile, "POTUsed")->GetVal(),
                dataPOT = util::GetIngredient<TParameter<double>>(*dataFile, "POTUsed")->GetVal();
 
-  for(const auto& prefix: crossSectionPrefixes)
+  //Quick-look jobs are already scaled up to their full POT.  Their statistical uncertainties are from the sampled entries.
+  for(const auto file: {dataFile.get(), mcFile.get()})
   {
+    const auto fraction = dynamic_cast<TParameter<double>*>(file->Get("SamplingFraction"));
+    if(fraction) std::cout << file->GetName() << " only sampled " << fraction->GetVal() * 100 << "% of its AnaTuples, so its statistical uncertainties are larger than the full sample's.\n";
+  }
+
+  for(const auto& fiducial: dataIndex.fiducials())
+  {
+    //Only cross section Studies make a Signal histogram
+    const std::string selection = dataIndex.selection(fiducial);
+    if(dataIndex.findAll(fiducial, selection, Role::Signal).empty()) continue;
+    const std::string prefix = util::HistIndex::prefix(fiducial, selection);
+
     try
     {
-      auto flux = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, "reweightedflux_integrated", prefix);
-      auto folded = util::GetIngredient<PlotUtils::MnvH1D>(*dataFile, "Signal", prefix);
+      auto flux = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, mcIndex.find(fiducial, selection, Role::Flux).key);
+      auto folded = util::GetIngredient<PlotUtils::MnvH1D>(*dataFile, dataIndex.find(fiducial, selection, Role::Signal).key);
       Plot(*folded, "data", prefix);
-      auto migration = util::GetIngredient<PlotUtils::MnvH2D>(*mcFile, "Migration", prefix);
-      auto effNum = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, "EfficiencyNumerator", prefix);
-      auto effDenom = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, "EfficiencyDenominator", prefix);
+      auto migration = util::GetIngredient<PlotUtils::MnvH2D>(*mcFile, mcIndex.find(fiducial, selection, Role::Migration).key);
+      auto effNum = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, mcIndex.find(fiducial, selection, Role::EfficiencyNumerator).key);
+      auto effDenom = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, mcIndex.find(fiducial, selection, Role::EfficiencyDenominator).key);
       auto simEventRate = effDenom->Clone(); //Make a copy for later
 
-      const auto fiducialFound = std::find_if(mcFile->GetListOfKeys()->begin(), mcFile->GetListOfKeys()->end(),
-                                              [&prefix](const auto key)
-                                              {
-                                                const std::string keyName = key->GetName();
-                                                const size_t fiducialEnd = keyName.find("_FiducialNucleons");
-                                                return (fiducialEnd != std::string::npos) && (prefix.find(keyName.substr(0, fiducialEnd)) != std::string::npos);
-                                              });
-      if(fiducialFound == mcFile->GetListOfKeys()->end()) throw std::runtime_error("Failed to find a number of nucleons that matches prefix " + prefix);
+      const auto nNucleons = expandBinning(util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, mcIndex.find(fiducial, "", Role::FiducialNucleons).key), effNum); //Dan: Use the same truth fiducial volume for all extractions.  The acceptance correction corrects data back to this fiducial even if the reco fiducial cut is different.
 
-      const auto nNucleons = expandBinning(util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, (*fiducialFound)->GetName()), effNum); //Dan: Use the same truth fiducial volume for all extractions.  The acceptance correction corrects data back to this fiducial even if the reco fiducial cut is different.
-
-      //Look for backgrounds with <prefix>_<analysis>_Background_<name>
       std::vector<PlotUtils::MnvH1D*> backgrounds;
-      for(auto key: *mcFile->GetListOfKeys())
+      for(const auto background: mcIndex.findAll(fiducial, selection, Role::Background))
       {
-        if(std::string(key->GetName()).find(prefix + "_Background_") != std::string::npos)
-        {
-          backgrounds.push_back(util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, key->GetName()));
-        }
+        backgrounds.push_back(util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, background->key));
       }
+      if(backgrounds.empty()) std::cerr << "Warning: There are no Backgrounds to subtract in " << mcFile->GetName() << ".  Going on without subtracting any.\n";
 
       //There are no error bands in the data, but I need somewhere to put error bands on the results I derive from it.
       folded->AddMissingErrorBandsAndFillWithCV(*migration);
 
       //Basing my unfolding procedure for a differential cross section on Alex's MINERvA 101 talk at https://minerva-docdb.fnal.gov/cgi-bin/private/RetrieveFile?docid=27438&filename=whatsACrossSection.pdf&version=1
 
-      auto toSubtract = std::accumulate(std::next(backgrounds.begin()), backgrounds.end(), (*backgrounds.begin())->Clone(),
-                                        [](auto sum, const auto hist)
-                                        {
-                                          sum->Add(hist);
-                                          return sum;
-                                        });
-      Plot(*toSubtract, "BackgroundSum", prefix);
+      if(!backgrounds.empty())
+      {
+        auto toSubtract = std::accumulate(std::next(backgrounds.begin()), backgrounds.end(), (*backgrounds.begin())->Clone(),
+                                          [](auto sum, const auto hist)
+                                          {
+                                            sum->Add(hist);
+                                            return sum;
+                                          });
+        Plot(*toSubtract, "BackgroundSum", prefix);
+      }
 
       auto bkgSubtracted = std::accumulate(backgrounds.begin(), backgrounds.end(), folded->Clone(),
                                            [mcPOT, dataPOT](auto sum, const auto hist)
@@ -14,6 +14,7 @@
 //util includes
 #include "util/mathWithUnits.h"
 #include "util/GetIngredient.h"
+#include "util/HistIndex.h"
 #include "util/Factory.cpp"
 
 //PlotUtils includes
@@ -39,49 +40,39 @@
 
 namespace
 {
-  std::string findSelectionName(TDirectoryFile& dir)
+  using Role = util::HistIndex::Role;
+
+  //Fiducial and Study of the first selected region with cross section histograms
+  std::pair<std::string, std::string> findSelection(const util::HistIndex& index)
   {
-    const std::string selectionTag = "_Signal";
-    for(auto key: *dir.GetListOfKeys())
+    for(const auto& fiducial: index.fiducials())
     {
-      std::string keyName = key->GetName();
-      const size_t selectionLocation = keyName.find(selectionTag);
-      if(selectionLocation != std::string::npos) return keyName.substr(0, selectionLocation);
+      const std::string selection = index.selection(fiducial);
+      if(!index.findAll(fiducial, selection, Role::Signal).empty()) return std::make_pair(fiducial, selection);
     }
 
-    throw std::runtime_error("Failed to find a histogram whose name ends in " + selectionTag + " in " + dir.GetName());
-    return "";
+    throw std::runtime_error("Failed to find a selected region with a Signal histogram.");
+    return std::make_pair("", "");
   }
 
-  std::vector<std::string> findSidebandNames(TDirectoryFile& dir, const std::string& selectionName)
+  //Sidebands that have Backgrounds to fit in a Fiducial
+  std::vector<std::string> findSidebandNames(const util::HistIndex& index, const std::string& fiducial)
   {
-    std::set<std::string> uniquePrefixes;
-    for(auto key: *dir.GetListOfKeys())
+    std::vector<std::string> prefixes;
+    for(const auto& sideband: index.sidebands(fiducial))
     {
-      std::string keyName = key->GetName();
-      const size_t bkgLocation = keyName.find("_Background_");
-      if(bkgLocation != std::string::npos && keyName.find(selectionName) == std::string::npos) uniquePrefixes.insert(keyName.substr(0, bkgLocation));
+      if(!index.findAll(fiducial, sideband, Role::Background).empty()) prefixes.push_back(util::HistIndex::prefix(fiducial, sideband));
     }
 
-    return std::vector<std::string>(uniquePrefixes.begin(), uniquePrefixes.end());
+    return prefixes;
   }
 
-  std::vector<std::string> findBackgroundNames(TDirectoryFile& dir)
+  std::vector<std::string> findBackgroundNames(const util::HistIndex& index, const std::string& fiducial, const std::string& selection)
   {
-    const std::string tag = "_Background_";
-    std::set<std::string> uniqueBackgrounds;
-    for(auto key: *dir.GetListOfKeys())
-    {
-      std::string keyName = key->GetName();
-      const size_t bkgLocation = keyName.find(tag);
-      if(bkgLocation != std::string::npos)
-      {
-        const std::string bkgName = keyName.substr(bkgLocation + tag.length(), std::string::npos);
-        uniqueBackgrounds.insert(bkgName);
-      }
-    }
+    std::vector<std::string> names;
+    for(const auto background: index.findAll(fiducial, selection, Role::Background)) names.push_back(background->category);
 
-    return std::vector<std::string>(uniqueBackgrounds.begin(), uniqueBackgrounds.end());
+    return names;
   }
 }
 
@@ -221,8 +212,19 @@ int main(const int argc, const char** argv)
   }
 
   //Configure this program using the input YAML file
-  const std::string dummySelectionName = findSelectionName(*mcFile);
-  const auto exampleHist = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, dummySelectionName + "_SelectedMCEvents");
+  const util::HistIndex index(*mcFile);
+  std::pair<std::string, std::string> fiducialAndSelection;
+  try
+  {
+    fiducialAndSelection = findSelection(index);
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cerr << "Failed to find histograms to fit in " << mcFile->GetName() << ": " << e.what() << "\n";
+    return 5;
+  }
+  const std::string& fiducial = fiducialAndSelection.first;
+  const auto exampleHist = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, index.find(fiducial, fiducialAndSelection.second, Role::SelectedMCEvents).key);
 
   bool fitToSelection = false;
   int firstBin = 1, lastBin = exampleHist->GetXaxis()->GetNbins() + 1;
@@ -251,7 +253,7 @@ int main(const int argc, const char** argv)
 
   //const auto crossSectionPrefixes = findCrossSectionPrefixes(*dataFile); //TODO: Maybe this is the longest unique string at the beginning of all keys?
 
-  const auto allBackgrounds = findBackgroundNames(*mcFile);
+  const auto allBackgrounds = findBackgroundNames(index, fiducial, fiducialAndSelection.second);
 
   //Figure out sum of bin widths in fit region in case I want to use a linearly scaled background
   const double sumBinWidths = exampleHist->GetBinLowEdge(lastBin) - exampleHist->GetBinLowEdge(firstBin);
@@ -291,8 +293,8 @@ int main(const int argc, const char** argv)
 
   /*for(const auto& prefix: crossSectionPrefixes) //Usually a loop over fiducial volumes
   {*/
-    const std::string selectionName = findSelectionName(*mcFile);
-    /*const*/ std::vector<std::string> sidebandNames = findSidebandNames(*mcFile, selectionName);
+    const std::string selectionName = util::HistIndex::prefix(fiducial, fiducialAndSelection.second);
+    /*const*/ std::vector<std::string> sidebandNames = findSidebandNames(index, fiducial);
 
     for(const auto nameToIgnore: config["ignoreSidebands"])
     {
@@ -334,7 +336,7 @@ int main(const int argc, const char** argv)
     if(!fitToSelection) objectiveFunction.scale(cvSelection, *minimizer);
 
     //Get the list of error bands to loop over
-    auto referenceHist = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, selectionName + "_Signal");
+    auto referenceHist = util::GetIngredient<PlotUtils::MnvH1D>(*mcFile, index.find(fiducial, fiducialAndSelection.second, Role::Signal).key);
     auto errorBandNames = referenceHist->GetErrorBandNames();
 
     //Sometimes, it's useful to not fit one or more error bands
@@ -29,6 +29,7 @@
 "PlotUtils::MnvH2D\n"\
 "TH1D and any other ROOT histogram\n"\
 "TParameter<double>\n"\
+"SamplingFraction from quick-look jobs is averaged weighted by POT\n"\
 "Any TNamed will be ignored (but not objects derived from it)\n"\
 "*****************************************************************************\n"
 
@@ -101,6 +102,13 @@ double getMyPOT(TFile& mcFile)
   return myPOT->GetVal();
 }
 
+//Fraction of its AnaTuples a quick-look job read.  Files from jobs that read everything don't have one.
+double getSamplingFraction(TFile& file)
+{
+  const auto fraction = dynamic_cast<TParameter<double>*>(file.Get("SamplingFraction"));
+  return fraction?fraction->GetVal():1.;
+}
+
 bool checkMetadata(TFile& lhs, TFile& rhs, const std::map<std::string, PlotUtils::MnvH1D*>& fiducials)
 {
   //Check NucCCNeutrons commit hash
@@ -201,6 +209,7 @@ int main(const int argc, const char** argv)
   {
     auto key = static_cast<TKey*>(entry);
     const std::string keyName = key->GetName();
+    if(keyName == "SamplingFraction") continue; //Averaged separately below
     auto obj = key->ReadObj()->Clone();
 
     if(keyName.find("_FiducialNucleons") != std::string::npos)
@@ -240,6 +249,10 @@ int main(const int argc, const char** argv)
   std::map<std::string, double> playlistToDataPOT;
   double totalMCPOT = 0;
 
+  //POT-weighted sum of each file's SamplingFraction and the POT it's weighted by
+  double sampledPOT = getMyPOT(*firstFile) * getSamplingFraction(*firstFile),
+         sampledFromPOT = getMyPOT(*firstFile);
+
   //Scale the copied input file to the data POT
   if(scaleToDataPOT)
   {
@@ -334,6 +347,9 @@ int main(const int argc, const char** argv)
 
     if(!checkMetadata(*firstFile, *inFile, mergedNucleons)) return badMetadata;
 
+    sampledPOT += getMyPOT(*inFile) * getSamplingFraction(*inFile);
+    sampledFromPOT += getMyPOT(*inFile);
+
     //Merge histograms
     for(auto& entry: mergedSamples)
     {
@@ -446,6 +462,7 @@ int main(const int argc, const char** argv)
     entry.second->Write();  
   }
   for(auto entry: mergedPOT) entry.second->Write();
+  if(sampledPOT < sampledFromPOT) TParameter<double>("SamplingFraction", sampledPOT / sampledFromPOT).Write();
   for(auto entry: mergedNucleons) entry.second->Write();
   for(auto entry: mergedMetadata) entry.second->Write();
   for(auto entry: mergedFlux)
@@ -0,0 +1,206 @@
+//File: PrecomputeWeights.cpp
+//Brief: Evaluate the "model" in every systematic universe once per AnaTuple entry and save
+//       the results as friend TTrees indexed by entry number.  ProcessAnaTuples reads them
+//       back when app: precomputedWeights: names this program's output file and it was
+//       made with the same model, systematics, and playlist.  Otherwise, ProcessAnaTuples
+//       just evaluates the model itself.
+//
+//       Usage:
+//       PrecomputeWeights <yourCuts.yaml> [moreConfigsInOrder.yaml]... <yourTuple.root> [moreTuples.root]...
+//
+//       Takes exactly the same YAML files as ProcessAnaTuples, but it only reads the
+//       "model", "systematics", and "app" blocks.  Writes <lastYAML>WeightsMC.root.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#define PLOTUTILS_THROW_EXCEPTIONS
+
+//utility includes
+#include "util/Factory.cpp"
+
+//reweighters includes
+#include "reweighters/RegisterReweighters.h"
+#include "systematics/RegisterVerticalSystematics.h"
+#include "PlotUtils/Model.h"
+
+//app includes
+#include "app/CmdLine.h"
+#include "app/IsMC.h"
+#include "app/SetupPlugins.h"
+#include "app/PrecomputedWeights.h"
+
+//PlotUtils includes
+#include "PlotUtils/CrashOnROOTMessage.h"
+
+//YAML-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TNamed.h"
+
+//Cintex is only needed for older ROOT versions like the GPVMs.
+//Let CMake decide whether it's needed.
+#ifndef NCINTEX
+#include "Cintex/Cintex.h"
+#endif
+
+//c++ includes
+#include <iostream>
+
+namespace
+{
+  //Fill one weight TTree with a row of weights for every entry in tuple
+  void fillWeights(PlotUtils::TreeWrapper& tuple, TTree& weightTree, std::vector<float>& row,
+                   const std::vector<std::pair<std::string, evt::Universe*>>& columns,
+                   const std::vector<std::vector<evt::Universe*>>& groupedUnivs,
+                   evt::Universe& cv, PlotUtils::Model<evt::Universe>& model)
+  {
+    weight_hadron<PlotUtils::TreeWrapper*>(&tuple).setDataTree(tuple.GetTree());
+    for(auto& compat: groupedUnivs)
+    {
+      for(auto univ: compat) univ->SetTreeMC(&tuple);
+    }
+
+    const size_t nEntries = tuple.GetEntries();
+    for(size_t entry = 0; entry < nEntries; ++entry)
+    {
+      //Same order of operations as ProcessAnaTuples so that stateful Reweighters agree
+      cv.SetEntry(entry);
+      PlotUtils::detail::empty shared;
+      model.SetEntry(cv, shared);
+
+      for(auto& compat: groupedUnivs)
+      {
+        for(auto univ: compat) univ->SetEntry(entry);
+      }
+
+      for(size_t whichColumn = 0; whichColumn < columns.size(); ++whichColumn) row[whichColumn] = model.GetWeight(*columns[whichColumn].second, shared);
+      weightTree.Fill();
+    }
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  #ifndef NCINTEX
+  ROOT::Cintex::Cintex::Enable(); //Needed to look up dictionaries for PlotUtils classes like MnvH1D
+  #endif
+
+  TH1::AddDirectory(kFALSE);
+
+  std::unique_ptr<app::CmdLine> options;
+  std::map<std::string, std::vector<evt::Universe*>> universes;
+  std::vector<std::vector<evt::Universe*>> groupedUnivs;
+  std::vector<std::unique_ptr<PlotUtils::Reweighter<evt::Universe>>> reweighters;
+  std::string anaTupleName;
+
+  try
+  {
+    options.reset(new app::CmdLine(argc, argv, "Weights"));
+    if(!options->isMC())
+    {
+      std::cerr << "Data events all have a weight of 1.  There's nothing to precompute.\n";
+      return app::CmdLine::MixedMCAndData;
+    }
+
+    anaTupleName = options->ConfigFile()["app"]["AnaTupleName"].as<std::string>("NucCCNeutron");
+
+    //MnvHadronReweight needs a TreeWrapper because it tries to connect to the tree as soon as it is created.
+    PlotUtils::ChainWrapper exampleTuple(anaTupleName.c_str());
+    exampleTuple.Add(options->TupleFileNames().front());
+
+    universes = app::getSystematics(&exampleTuple, *options, options->isMC());
+    groupedUnivs = app::groupCompatibleUniverses(universes);
+    reweighters = app::setupReweighters(options->ConfigFile()["model"]); //This MUST come after setting up universes because of the static variables that DefaultUniverse relies on
+  }
+  catch(const app::CmdLine::exception& e)
+  {
+    std::cerr << e.what() << "\n";
+    return e.reason;
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cerr << e.what() << "\n";
+    return app::CmdLine::YAMLError;
+  }
+
+  PlotUtils::Model<evt::Universe> model(std::move(reweighters));
+  auto& cv = *universes["cv"].front();
+
+  const auto columns = app::weightColumns(universes);
+  std::vector<float> row(columns.size(), 1); //Single precision is plenty for weights and halves the file size
+  const std::string leafList = std::string(app::weightBranchName) + "[" + std::to_string(columns.size()) + "]/F";
+
+  //Metadata that PrecomputedWeights checks before it trusts these weights
+  options->HistFile->cd();
+  std::string columnNames;
+  for(const auto& column: columns) columnNames += column.first + "\n";
+  TNamed(app::weightColumnsName, columnNames.c_str()).Write();
+  TNamed(app::weightHashName, app::weightConfigHash(options->ConfigFile(), options->playlist()).c_str()).Write();
+
+  try
+  {
+    for(const auto& fName: options->TupleFileNames())
+    {
+      std::unique_ptr<TFile> tupleFile(TFile::Open(fName.c_str()));
+      if(tupleFile == nullptr)
+      {
+        std::cerr << fName << ": No such file or directory.  Skipping this file name.\n";
+        continue;
+      }
+
+      if(!app::IsMC(fName))
+      {
+        std::cerr << fName << " is a data file.  Skipping this file!\n";
+        continue;
+      }
+
+      auto recoTree = dynamic_cast<TTree*>(tupleFile->Get(anaTupleName.c_str()));
+      auto truthTree = dynamic_cast<TTree*>(tupleFile->Get("Truth"));
+      if(!recoTree || !truthTree)
+      {
+        std::cerr << "Failed to find both an AnaTuple named " << anaTupleName << " and a Truth tree in " << fName << ".  Skipping this file name.\n";
+        continue;
+      }
+
+      auto weightDir = options->HistFile->mkdir(app::weightDirName(fName).c_str());
+      if(!weightDir) throw std::runtime_error("Failed to make a directory for " + fName + "'s weights.  Was it listed twice?");
+      weightDir->cd();
+
+      TTree recoWeights(app::recoWeightTreeName, ("Weights for each entry in " + fName + "'s " + anaTupleName + " tree").c_str());
+      recoWeights.Branch(app::weightBranchName, row.data(), leafList.c_str());
+      PlotUtils::TreeWrapper anaTuple(recoTree);
+      PlotUtils::MinervaUniverse::SetTruth(false);
+      fillWeights(anaTuple, recoWeights, row, columns, groupedUnivs, cv, model);
+      recoWeights.Write();
+
+      TTree truthWeights(app::truthWeightTreeName, ("Weights for each entry in " + fName + "'s Truth tree").c_str());
+      truthWeights.Branch(app::weightBranchName, row.data(), leafList.c_str());
+      PlotUtils::TreeWrapper truthTuple(truthTree);
+      PlotUtils::MinervaUniverse::SetTruth(true); //Don't try to get MINOS weights in the truth tree
+      fillWeights(truthTuple, truthWeights, row, columns, groupedUnivs, cv, model);
+      truthWeights.Write();
+
+      options->HistFile->cd();
+    }
+  }
+  catch(const ROOT::warning& e)
+  {
+    std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
+    return app::CmdLine::ExitCode::IOError;
+  }
+  catch(const ROOT::error& e)
+  {
+    std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
+    return app::CmdLine::ExitCode::IOError;
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cerr << "Got a fatal std::runtime_error while precomputing weights:\n"
+              << e.what() << "\nExiting immediately, so you probably got incomplete results!\n";
+    return app::CmdLine::ExitCode::AnalysisError;
+  }
+
+  return app::CmdLine::ExitCode::Success;
+}
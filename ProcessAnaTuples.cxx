@@ -16,12 +16,18 @@
 
 //fiducials includes
 #include "fiducials/Fiducial.h"
+#include "fiducials/Router.h"
 
 //utility includes
 #include "util/Factory.cpp"
 #include "util/Table.h"
 #include "util/StreamRedirection.h"
 #include "util/SafeROOTName.h"
+#include "util/MemoryBudget.h"
+#include "util/AsyncWriter.h"
+#include "util/HistIndex.h"
+#include "util/SetupCache.h"
+#include "util/BatchModel.h"
 
 //analysis includes
 #include "analyses/base/Study.h"
@@ -30,6 +36,8 @@
 //Cuts includes
 #include "cuts/truth/Cut.h"
 #include "cuts/reco/Cut.h"
+#include "cuts/reco/SharedCut.h"
+#include "cuts/reco/BlockEvaluator.h"
 #include "PlotUtils/Cutter.h"
 
 //models includes
@@ -45,11 +53,15 @@
 #include "app/CmdLine.h"
 #include "app/IsMC.h"
 #include "app/SetupPlugins.h"
+#include "app/PrecomputedWeights.h"
+#include "app/GetPlaylist.h"
+#include "app/Sampling.h"
 
 //PlotUtils includes
 #include "PlotUtils/CrashOnROOTMessage.h"
 #include "PlotUtils/GenieSystematics.h"
 #include "PlotUtils/FluxSystematics.h"
+#include "PlotUtils/FluxReweighter.h"
 
 //YAML-cpp includes
 #include "yaml-cpp/yaml.h"
@@ -58,6 +70,8 @@
 #include "TFile.h"
 #include "TTree.h"
 #include "TParameter.h"
+#include "TList.h"
+#include "TSystem.h"
 
 //Cintex is only needed for older ROOT versions like the GPVMs.
 //Let CMake decide whether it's needed.
@@ -71,6 +85,8 @@
 #include <unordered_map>
 #include <bitset>
 #include <fstream>
+#include <sstream>
+#include <cmath>
 
 //Macro to centralize how I print out debugging messages
 //TODO: Decide how I want this macro to work and centralize it.
@@ -94,49 +110,126 @@ namespace
     return result;
   }
 
-  std::unique_ptr<ana::Background> null(nullptr); //TODO: This is a horrible hack so I can hold a reference to a nullptr
+  /*events getWeight(const std::vector<std::unique_ptr<model::Model>>& models, const evt::Universe& event)
+  {
+    return std::accumulate(models.begin(), models.end(), 1., [&event](const double product, const auto& model) { return product * model->GetWeight(event).template in<events>(); });
+  }*/
 
-  template <class ITERATOR>
-  auto derefOrNull(const ITERATOR it, const ITERATOR end) -> decltype(*it)
+  //Take every object out of file's list so that nothing this thread does afterwards, like
+  //finishing another Fiducial's histograms, touches file while a writer writes them.  Histograms
+  //forget their directory.  TTrees keep it because their baskets are already in file.  Objects
+  //are grouped by the longest of prefixes that their names start with.  The last group has
+  //everything that doesn't start with any of prefixes.
+  std::vector<std::vector<TObject*>> detach(TFile& file, const std::vector<std::string>& prefixes)
   {
-    if(it == end) return ::null;
-    return *it;
+    std::vector<std::vector<TObject*>> groups(prefixes.size() + 1);
+    TIter next(file.GetList());
+    while(auto obj = next())
+    {
+      const std::string name = obj->GetName();
+      size_t whichGroup = prefixes.size(), longest = 0;
+      for(size_t whichPrefix = 0; whichPrefix < prefixes.size(); ++whichPrefix)
+      {
+        const auto& prefix = prefixes[whichPrefix];
+        if(prefix.size() > longest && name.compare(0, prefix.size(), prefix) == 0)
+        {
+          whichGroup = whichPrefix;
+          longest = prefix.size();
+        }
+      }
+      groups[whichGroup].push_back(obj);
+    }
+    file.GetList()->Clear("nodelete");
+
+    for(auto& group: groups)
+    {
+      for(auto obj: group)
+      {
+        auto hist = dynamic_cast<TH1*>(obj);
+        if(hist) hist->SetDirectory(nullptr);
+      }
+    }
+
+    return groups;
   }
 
-  template <class CUT, class ...ARGS>
-  bool requireAll(const std::vector<std::unique_ptr<CUT>>& cuts, const evt::Universe& event, ARGS... args)
+  //Write() and then delete objects on writer's thread.  They must have been detach()ed from file
+  //first, and nothing else may touch them afterwards.
+  void writeAsync(TFile& file, std::vector<TObject*>&& objects, util::AsyncWriter& writer)
   {
-    return std::all_of(cuts.begin(), cuts.end(),
-                       [&event, args...](const auto& cut)
-                       {
-                         return cut->passes(event, args...);
-                       });
+    writer.push([&file, objects]()
+                {
+                  TDirectory::TContext context(&file);
+                  for(auto obj: objects)
+                  {
+                    obj->Write();
+                    delete obj;
+                  }
+                });
   }
 
-  /*events getWeight(const std::vector<std::unique_ptr<model::Model>>& models, const evt::Universe& event)
+  //Another model block from alternateModels.  Its weights fill copies of every
+  //Study that are written to their own file.
+  struct AlternateModel
   {
-    return std::accumulate(models.begin(), models.end(), 1., [&event](const double product, const auto& model) { return product * model->GetWeight(event).template in<events>(); });
-  }*/
+    std::string name;
+    bool universes; //Fill every systematic universe instead of just the CV
+    std::unique_ptr<TFile> file;
+    util::HistIndex index;
+    std::unique_ptr<PlotUtils::Model<evt::Universe>> model;
+  };
+
+  //Number of nucleons only depends on a Fiducial's configuration, the playlist, MAT-MINERvA, and
+  //which error bands it's made for, so it can come from the SetupCache.
+  PlotUtils::MnvH1D* cachedNNucleons(const YAML::Node& config, const fid::Fiducial& fid, const std::string& playlist, const bool isMC,
+                                     std::map<std::string, std::vector<evt::Universe*>>& universes)
+  {
+    std::stringstream key;
+    key << "NNucleons\n" << util::SetupCache::libraryTag() << "\n" << playlist << "\n" << YAML::Dump(config) << "\n" << isMC << "\n";
+    for(const auto& band: universes) key << band.first << ":" << band.second.size() << " ";
 
-  //Given a cut map, passedCuts, find the Study that this event fits in.
-  ana::Study* findSelectedOrSideband(const std::bitset<64> passedCuts, fid::Fiducial& fid, evt::Universe& univ)
+    if(auto cached = util::SetupCache::get<PlotUtils::MnvH1D>(key.str())) return cached;
+
+    auto nNucleons = fid.NNucleons(isMC, universes);
+    util::SetupCache::store(key.str(), *nNucleons);
+    return nNucleons;
+  }
+
+  //AnaTuple files from the same playlist.  They share a flux and an output file.
+  struct Playlist
+  {
+    std::string name;
+    std::vector<std::string> files;
+  };
+
+  //PlotUtils::flux_reweighter() is made for the first playlist it's asked about and ignores the playlist
+  //after that.  So flux weights and flux integrals for every playlist in one job come from the first playlist.
+  //That's only right if every playlist has the same flux.  Build each playlist's own FluxReweighter to check.
+  void checkFluxesMatch(const std::vector<Playlist>& playlists, const evt::Universe& cv)
   {
-    if(passedCuts.all()) return fid.study.get();
-    else if(!passedCuts.none())
+    std::vector<double> integrals;
+    for(const auto& playlist: playlists)
+    {
+      PlotUtils::FluxReweighter flux(cv.GetAnalysisNuPDG(), cv.UseNuEConstraint(), playlist.name, PlotUtils::FluxReweighter::gen2thin,
+                                     PlotUtils::FluxReweighter::g4numiv6, cv.GetNFluxUniverses());
+      integrals.push_back(flux.GetFluxReweighted(cv.GetAnalysisNuPDG())->Integral());
+    }
+
+    std::stringstream differ;
+    for(size_t whichPlaylist = 1; whichPlaylist < playlists.size(); ++whichPlaylist)
     {
-      const auto foundSidebands = fid.sidebands.find(passedCuts);
-      if(foundSidebands != fid.sidebands.end())
+      if(std::fabs(integrals[whichPlaylist] - integrals.front()) > 1e-9 * std::fabs(integrals.front()))
       {
-        const auto firstSideband = std::find_if(foundSidebands->second.begin(), foundSidebands->second.end(),
-                                                [&univ](const auto& sideband)
-                                                { return sideband->passesCuts(univ); });
-        if(firstSideband != foundSidebands->second.end())
-        {
-          return firstSideband->get();
-        }
-      } //If found a sideband and passed all of its reco constraints
-    } //If passed all cuts not related to sidebands
-    return nullptr;
+        differ << playlists[whichPlaylist].name << "'s flux integral is " << integrals[whichPlaylist] << ", but "
+               << playlists.front().name << "'s is " << integrals.front() << ".\n";
+      }
+    }
+
+    if(!differ.str().empty())
+    {
+      throw std::runtime_error("multiplePlaylists can only combine playlists with the same flux because MAT-MINERvA's flux_reweighter() "
+                               "only ever uses the first playlist.\n" + differ.str() + "Process these playlists in separate jobs like forEachPlaylist.sh does.");
+    }
   }
 }
 
@@ -148,17 +241,33 @@ int main(const int argc, const char** argv)
 
   TH1::AddDirectory(kFALSE); //Needed so that MnvH1D gets to clean up its own MnvLatErrorBands (which are TH1Ds).
 
-  //Components I need for the event loop
+  //Components I need for the event loop that every playlist shares
   std::vector<std::vector<evt::Universe*>> groupedUnivs;
   evt::Universe* cv;
+  std::map<std::string, std::vector<evt::Universe*>> universes;
+  std::map<std::string, std::vector<evt::Universe*>> cvOnly; //For alternate models without universes
   //std::vector<std::unique_ptr<model::Model>> reweighters;
   std::vector<std::unique_ptr<PlotUtils::Reweighter<evt::Universe>>> reweighters;
-  std::vector<std::unique_ptr<fid::Fiducial>> fiducials;
+  std::vector<AlternateModel> alternateModels; //Each fills copies of every Fiducial's Studies
   std::string anaTupleName;
+  bool overrideTruthCuts = false;
+
+  //AnaTuple files grouped by playlist.  Just one group unless the configuration asks for multiplePlaylists.
+  std::vector<Playlist> playlists;
+  bool splitByPlaylist = false;
+  std::string histFileName; //Name of the output file in each playlist's directory
+  std::unique_ptr<app::Sampling> sampling; //Which entries or files a quick-look job processes
 
   //TODO: Move these parameters somehwere that can be shared between applications?
   std::unique_ptr<app::CmdLine> options;
 
+  bool dryRunMemory = false;
+  std::map<std::string, double> dryRunBandScales; //How many times more memory each error band will need than a dry run allocates
+
+  //Fills TTrees and writes histograms on another thread if the configuration asks for it.
+  //Destroyed before options so that it's done before the output file is closed.
+  std::unique_ptr<util::AsyncWriter> writer;
+
   try
   {
     options.reset(new app::CmdLine(argc, argv)); //Parses the command line for input and configuration file, assembles a
@@ -167,7 +276,19 @@ int main(const int argc, const char** argv)
 
     //Name of the AnaTuple to read
     anaTupleName = options->ConfigFile()["app"]["AnaTupleName"].as<std::string>("NucCCNeutron");
-    const bool overrideTruthCuts = options->ConfigFile()["app"]["overrideTruthCuts"].as<bool>(false);
+    overrideTruthCuts = options->ConfigFile()["app"]["overrideTruthCuts"].as<bool>(false);
+    dryRunMemory = options->ConfigFile()["app"]["dryRunMemory"].as<bool>(false);
+
+    //Flux integrals and numbers of nucleons from earlier jobs with the same configuration.
+    //A dry run's are made with fewer universes, so they'd never be used again.
+    if(!dryRunMemory) util::SetupCache::setDirectory(options->ConfigFile()["app"]["setupCache"].as<std::string>(""));
+
+    const size_t asyncOutputQueue = options->ConfigFile()["app"]["asyncOutputQueue"].as<size_t>(0);
+    if(asyncOutputQueue > 0)
+    {
+      writer.reset(new util::AsyncWriter(asyncOutputQueue));
+      if(!writer->isAsync()) std::cerr << "This version of ROOT can't write from another thread, so asyncOutputQueue is ignored.\n";
+    }
 
     //MnvHadronReweight needs a TreeWrapper because it tries to connect to the tree as soon as it is created.
     //TODO: Lots of error checking :(
@@ -182,93 +303,92 @@ int main(const int argc, const char** argv)
     if(exampleRecoTree == nullptr) throw std::runtime_error("There is no TTree named " + anaTupleName + " in " + options->TupleFileNames().front() + ".");
     PlotUtils::TreeWrapper exampleTuple(exampleRecoTree);*/
 
-    auto universes = app::getSystematics(&exampleTuple, *options, options->isMC());
+    universes = app::getSystematics(&exampleTuple, *options, options->isMC());
+
+    //A dry run only needs one universe per error band to find out how big each histogram is.
+    //The MemoryBudget scales them back up, so no other universe's histograms are ever allocated.
+    if(dryRunMemory)
+    {
+      for(auto& band: universes)
+      {
+        if(band.first == "cv" || band.first == "Flux" || band.second.size() < 2) continue; //Flux integrals need every flux universe
+        dryRunBandScales[band.first] = (band.second.size() + 1.) / 2.;
+        band.second.resize(1);
+      }
+    }
+    cvOnly = {{"cv", universes["cv"]}};
 
     //Send whatever noise PlotUtils makes during setup to a file in the current working directory
     #ifdef NDEBUG
       util::StreamRedirection silencePlotUtils(std::cout, "NSFNoise.txt");
     #endif
 
-    //The file where I will put histrograms I produce.
-    util::Directory histDir(*options->HistFile);
-    options->HistFile->cd();
-
-    //Assemble Fiducials
-    auto& fiducialFactory = plgn::Factory<fid::Fiducial>::instance();
-    for(auto& config: options->ConfigFile()["fiducials"])
+    //Each playlist gets its own flux, POT, and output file in a directory named after it like forEachPlaylist.sh
+    //makes.  Universes and models are only set up once for all of them.
+    splitByPlaylist = options->ConfigFile()["app"]["multiplePlaylists"].as<bool>(false);
+    if(splitByPlaylist)
     {
-      auto dirForFid = histDir.mkdir(config.first.as<std::string>());
-
-      auto fid = fiducialFactory.Get(config.second);
-      fid->name = config.first.as<std::string>();
-      fid->backgrounds = app::setupBackgrounds(options->ConfigFile()["backgrounds"]);
-
-      //N.B.: There's a technical reason why it's really hard to use util::Directory for a TParameter.
-      auto nNucleons = fid->NNucleons(options->isMC(), universes);
-      nNucleons->SetName((config.first.as<std::string>() + "_FiducialNucleons").c_str());
-      nNucleons->Write();
-
-      try
+      for(const auto& fName: options->TupleFileNames())
       {
-        fid->study = app::setupSignal(options->ConfigFile()["signal"], dirForFid, fid->backgrounds, universes);
-      } 
-      catch(const std::runtime_error& e)
-      {
-        throw std::runtime_error(std::string("Failed to set up the signal Study:\n") + e.what());
-      }
-
-      PlotUtils::constraints_t<evt::Universe> truthPhaseSpace, truthSignal;
-      PlotUtils::cuts_t<evt::Universe> recoCuts;
+        std::string name;
+        try
+        {
+          name = app::GetPlaylist(fName, options->isMC());
+        }
+        catch(const std::runtime_error& e)
+        {
+          std::cerr << e.what() << "\nSkipping this file.\n";
+          continue;
+        }
 
-      try
-      {
-        truthPhaseSpace = app::setupTruthConstraints(options->ConfigFile()["cuts"]["truth"]["phaseSpace"]);
-      }
-      catch(const std::runtime_error& e)
-      {
-        throw std::runtime_error(std::string("Failed to set up a phase space constraint:\n") + e.what());
+        auto found = std::find_if(playlists.begin(), playlists.end(), [&name](const auto& playlist) { return playlist.name == name; });
+        if(found == playlists.end()) found = playlists.insert(playlists.end(), Playlist{name, {}});
+        found->files.push_back(fName);
       }
+      if(playlists.empty()) throw std::runtime_error("Couldn't find the playlist of any AnaTuple file.");
+      if(options->isMC() && playlists.size() > 1 && !universes["cv"].empty()) ::checkFluxesMatch(playlists, *universes["cv"].front());
+
+      //The output file CmdLine made would never be filled
+      histFileName = options->HistFile->GetName();
+      options->HistFile->Close();
+      options->HistFile.reset();
+      gSystem->Unlink(histFileName.c_str());
+    }
+    else playlists.push_back(Playlist{options->playlist(), options->TupleFileNames()});
 
-      try
-      {
-        truthSignal = app::setupTruthConstraints(options->ConfigFile()["cuts"]["truth"]["signal"]);
-      }
-      catch(const std::runtime_error& e)
-      {
-        throw std::runtime_error(std::string("Failed to set up a signal definition constraint:\n") + e.what());
-      }
+    //Quick-look jobs only process part of each playlist.  Their weights are scaled up to make up for it.
+    sampling.reset(new app::Sampling(options->ConfigFile()["app"]["sample"]));
+    for(auto& playlist: playlists) playlist.files = sampling->chooseFiles(playlist.files, options->isMC());
 
-      try
-      {
-        recoCuts = app::setupRecoCuts(options->ConfigFile()["cuts"]["reco"]);
-      }
-      catch(const std::runtime_error& e)
+    //Other models are evaluated on the same selected events.  Data isn't reweighted.
+    const auto alternateConfig = options->ConfigFile()["alternateModels"];
+    if(alternateConfig && !options->isMC()) std::cerr << "Ignoring alternateModels because data isn't reweighted.\n";
+    else
+    {
+      for(const auto& config: alternateConfig)
       {
-        throw std::runtime_error(std::string("Failed to set up a reco Cut:\n") + e.what());
-      }
-
-      //Merge with Fiducial-specific Cuts
-      for(auto constraint: fid->phaseSpace) truthPhaseSpace.emplace(truthPhaseSpace.begin(), constraint);
-      for(auto sig: fid->signalDef) truthSignal.emplace(truthSignal.begin(), sig);
-      for(auto cut: fid->recoCuts) recoCuts.emplace(recoCuts.begin(), cut);
+        AlternateModel alt;
+        alt.name = config.first.as<std::string>();
+        alt.universes = config.second["universes"].as<bool>(false);
 
-      if(overrideTruthCuts)
-      {
-        truthSignal.clear();
-        truthPhaseSpace.clear();
+        try
+        {
+          auto altReweighters = app::setupReweighters(config.second["model"]);
+          if(sampling->enabled()) altReweighters.emplace_back(new app::SampleWeight(*sampling));
+          alt.model.reset(new util::BatchModel<evt::Universe>(std::move(altReweighters)));
+        }
+        catch(const std::runtime_error& e)
+        {
+          throw std::runtime_error("Failed to set up alternate model " + alt.name + ":\n" + e.what());
+        }
+        alternateModels.push_back(std::move(alt));
       }
-
-      decltype(recoCuts) sidebandCuts;
-      fid->sidebands = app::setupSidebands(options->ConfigFile()["sidebands"], dirForFid, fid->backgrounds, universes, recoCuts, sidebandCuts);
-
-      fid->selection.reset(new PlotUtils::Cutter<evt::Universe, PlotUtils::detail::empty>(std::move(recoCuts), std::move(sidebandCuts), std::move(truthSignal), std::move(truthPhaseSpace)));
-
-      fiducials.push_back(std::move(fid));
     }
 
     cv = universes["cv"].front();
     groupedUnivs = app::groupCompatibleUniverses(universes);
     reweighters = app::setupReweighters(options->ConfigFile()["model"]); //This MUST come after setting up universes because of the static variables that DefaultUniverse relies on
+    if(sampling->enabled()) reweighters.emplace_back(new app::SampleWeight(*sampling));
   }
   catch(const std::runtime_error& e)
   {
@@ -276,295 +396,729 @@ int main(const int argc, const char** argv)
     return app::CmdLine::YAMLError;
   }
 
-  PlotUtils::Model<evt::Universe> cvModel(std::move(reweighters));
+  util::BatchModel<evt::Universe> cvModel(std::move(reweighters)); //Studies that fill many universes at once get their weights together
+  const std::vector<evt::Universe*> cvGroup{cv}; //What alternate models without universes fill
 
-  //End the job and warn the user if there are no Fiducials to process.
-  if(fiducials.empty())
+  //The group of compatible universes that the CV is in.  Every Fiducial's cut table sees it, and
+  //alternate models without universes are only filled from it.
+  const auto groupWithCV = std::find_if(groupedUnivs.begin(), groupedUnivs.end(),
+                                        [cv](const auto& group) { return std::find(group.begin(), group.end(), cv) != group.end(); });
+  if(groupWithCV == groupedUnivs.end())
   {
-    std::cerr << "No fiducials to process.  Write a \"fiducials\" block in your YAML file and try again.\n";
+    std::cerr << "The CV isn't in any group of compatible universes.  I don't know which universes to fill the cut tables with.\n";
     return app::CmdLine::YAMLError;
   }
 
-  const bool anyoneWantsTruth = std::any_of(fiducials.begin(), fiducials.end(), [](const auto& fid) { return fid->study->wantsTruthLoop(); });
-
-  //Accumulate POT from each good file
-  double pot_used = 0;
-
-  //Loop over files
-  LOG_DEBUG("Beginning loop over files.")
-  try
+  for(const auto& playlist: playlists)
   {
-    for(const auto& fName: options->TupleFileNames())
+    //Components I need for this playlist's event loop
+    std::vector<std::unique_ptr<fid::Fiducial>> fiducials;
+    reco::SharedCut::caches_t sharedRecoCuts; //Each reco Cut that's the same in every Fiducial is only checked once
+    fid::Router router; //Which Fiducials an event's vertex could be in
+    std::unique_ptr<reco::BlockEvaluator> blocks; //Checks simple Cuts on many CV entries at once
+    std::unique_ptr<PlotUtils::Model<evt::Universe>> precomputedModel; //Only set when weights were precomputed with this configuration
+    app::PrecomputedWeights* precomputed = nullptr; //Owned by precomputedModel
+
+    //Every histogram the Studies make so I can project how much memory they'll need
+    //and report which ones were never filled.
+    util::MemoryBudget memoryBudget;
+    memoryBudget.scaleBands(dryRunBandScales);
+
+    //What every histogram is for so that post-processing programs can look them up
+    util::HistIndex histIndex;
+
+    try
     {
-      LOG_DEBUG("Loading " << fName)
-      //Sanity checks on AnaTuple files
-      double thisFilesPOT = 0;
-      std::unique_ptr<TFile> tupleFile(TFile::Open(fName.c_str()));
-      if(tupleFile == nullptr)
+      //MINOS efficiency and the SetupCache depend on the playlist.  checkFluxesMatch() already made sure
+      //that the flux doesn't change even though flux_reweighter() would ignore this.
+      PlotUtils::MinervaUniverse::SetPlaylist(playlist.name);
+
+      if(splitByPlaylist)
       {
-        std::cerr << fName << ": No such file or directory.  Skipping this "
-                  << "file name.\n";
-        continue; //TODO: Don't use break if I can help it
+        gSystem->mkdir(playlist.name.c_str(), true);
+        const std::string fileName = playlist.name + "/" + histFileName;
+        try
+        {
+          options->HistFile.reset(TFile::Open(fileName.c_str(), "CREATE"));
+        }
+        catch(const ROOT::exception& /*e*/)
+        {
+          options->HistFile.reset(); //Same message as below
+        }
+        if(!options->HistFile) throw std::runtime_error("Couldn't create a TFile named " + fileName + " for playlist " + playlist.name + ".  If it already exists, I refuse to overwrite it!");
       }
 
-      //TODO: Doesn't my ROOT error checking function throw an exception here?
-      if(app::IsMC(fName) != options->isMC())
+      #ifdef NDEBUG
+        util::StreamRedirection silencePlotUtils(std::cout, (splitByPlaylist?playlist.name + "/":std::string()) + "NSFNoise.txt");
+      #endif
+
+      //The file where I will put histrograms I produce.
+      util::Directory histDir(*options->HistFile);
+      histDir.track(memoryBudget);
+      histDir.indexWith(histIndex);
+      histIndex.setSelection(options->ConfigFile()["signal"]["name"].as<std::string>());
+      if(writer) histDir.writeWith(*writer);
+
+      //Each alternate model gets a file next to this playlist's output file
+      std::string fileStem = options->HistFile->GetName();
+      fileStem = fileStem.substr(0, fileStem.find('.'));
+      for(auto& alt: alternateModels)
       {
-        std::cerr << "This job " << (options->isMC()?"is":"is not")
-                  << " processing MC files, but " << fName << " is a "
-                  << (app::IsMC(fName)?"MC":"data")
-                  << "file.  Skipping this file!\n";
-        continue; //TODO: Don't use break if I can help it
+        const std::string fileName = fileStem + "_" + util::SafeROOTName(alt.name) + ".root";
+        try
+        {
+          alt.file.reset(TFile::Open(fileName.c_str(), "CREATE"));
+        }
+        catch(const ROOT::exception& /*e*/)
+        {
+          alt.file.reset(); //Same message as below
+        }
+        if(!alt.file) throw std::runtime_error("Couldn't create a TFile named " + fileName + " for alternate model " + alt.name + ".  If it already exists, I refuse to overwrite it!");
+
+        alt.index = util::HistIndex();
+        alt.index.setSelection(options->ConfigFile()["signal"]["name"].as<std::string>());
       }
-  
-      auto metaTree = dynamic_cast<TTree*>(tupleFile->Get("Meta"));
-      if(!metaTree)
+      options->HistFile->cd();
+
+      //Assemble Fiducials
+      auto& fiducialFactory = plgn::Factory<fid::Fiducial>::instance();
+      for(auto& config: options->ConfigFile()["fiducials"])
       {
-        std::cerr << fName << " does not contain POT information!  This might be a merging failure.  Skipping this file.\n";
-        continue; //TODO: Don't use break if I can help it
+        auto dirForFid = histDir.mkdir(config.first.as<std::string>());
+
+        auto fid = fiducialFactory.Get(config.second);
+        fid->name = config.first.as<std::string>();
+        fid->backgrounds = app::setupBackgrounds(options->ConfigFile()["backgrounds"]);
+
+        //N.B.: There's a technical reason why it's really hard to use util::Directory for a TParameter.
+        auto nNucleons = ::cachedNNucleons(config.second, *fid, playlist.name, options->isMC(), universes);
+        nNucleons->SetName((config.first.as<std::string>() + "_FiducialNucleons").c_str());
+        nNucleons->Write();
+        histIndex.add({util::SafeROOTName(fid->name)}, util::HistIndex::toString(util::HistIndex::Role::FiducialNucleons), nNucleons->GetName());
+
+        for(auto& alt: alternateModels)
+        {
+          alt.file->cd();
+          auto altNucleons = ::cachedNNucleons(config.second, *fid, playlist.name, options->isMC(), alt.universes?universes:cvOnly);
+          altNucleons->SetName(nNucleons->GetName());
+          altNucleons->Write();
+          alt.index.add({util::SafeROOTName(fid->name)}, util::HistIndex::toString(util::HistIndex::Role::FiducialNucleons), altNucleons->GetName());
+        }
+        options->HistFile->cd();
+
+        try
+        {
+          fid->study = app::setupSignal(options->ConfigFile()["signal"], dirForFid, fid->backgrounds, universes);
+        } 
+        catch(const std::runtime_error& e)
+        {
+          throw std::runtime_error(std::string("Failed to set up the signal Study:\n") + e.what());
+        }
+
+        PlotUtils::constraints_t<evt::Universe> truthPhaseSpace, truthSignal;
+        PlotUtils::cuts_t<evt::Universe> recoCuts;
+
+        try
+        {
+          truthPhaseSpace = app::setupTruthConstraints(options->ConfigFile()["cuts"]["truth"]["phaseSpace"]);
+        }
+        catch(const std::runtime_error& e)
+        {
+          throw std::runtime_error(std::string("Failed to set up a phase space constraint:\n") + e.what());
+        }
+
+        try
+        {
+          truthSignal = app::setupTruthConstraints(options->ConfigFile()["cuts"]["truth"]["signal"]);
+        }
+        catch(const std::runtime_error& e)
+        {
+          throw std::runtime_error(std::string("Failed to set up a signal definition constraint:\n") + e.what());
+        }
+
+        try
+        {
+          recoCuts = app::setupRecoCuts(options->ConfigFile()["cuts"]["reco"], &sharedRecoCuts);
+        }
+        catch(const std::runtime_error& e)
+        {
+          throw std::runtime_error(std::string("Failed to set up a reco Cut:\n") + e.what());
+        }
+
+        //Merge with Fiducial-specific Cuts
+        for(auto constraint: fid->phaseSpace) truthPhaseSpace.emplace(truthPhaseSpace.begin(), constraint);
+        for(auto sig: fid->signalDef) truthSignal.emplace(truthSignal.begin(), sig);
+        for(auto cut: fid->recoCuts)
+        {
+          //Fiducial-specific Cuts get their own caches so that they can be checked in blocks too
+          auto recoCut = dynamic_cast<reco::Cut*>(cut);
+          if(recoCut)
+          {
+            auto& cache = sharedRecoCuts["Fiducial " + fid->name + "\n" + cut->getName()];
+            cache.reset(new reco::SharedCut::Cache(std::unique_ptr<reco::Cut>(recoCut)));
+            recoCuts.emplace(recoCuts.begin(), new reco::SharedCut(cut->getName(), cache));
+          }
+          else recoCuts.emplace(recoCuts.begin(), cut);
+        }
+
+        if(overrideTruthCuts)
+        {
+          truthSignal.clear();
+          truthPhaseSpace.clear();
+        }
+
+        std::vector<std::string> recoCutNames; //Before setupSidebands() moves some of them
+        for(const auto& cut: recoCuts) recoCutNames.push_back(cut->getName());
+
+        decltype(recoCuts) sidebandCuts;
+        fid->sidebands = app::setupSidebands(options->ConfigFile()["sidebands"], dirForFid, fid->backgrounds, universes, recoCuts, sidebandCuts);
+
+        //Copies of every Study for each alternate model.  They share this Fiducial's cuts and Backgrounds.
+        for(auto& alt: alternateModels)
+        {
+          try
+          {
+            util::Directory altDir(*alt.file);
+            altDir.track(memoryBudget);
+            altDir.indexWith(alt.index);
+            auto altDirForFid = altDir.mkdir(fid->name);
+            auto& altUnivs = alt.universes?universes:cvOnly;
+
+            fid::Fiducial::ModelStudies copies;
+            copies.study = app::setupSignal(options->ConfigFile()["signal"], altDirForFid, fid->backgrounds, altUnivs);
+
+            //Sideband patterns only depend on cut names, so these Cuts are never checked
+            decltype(recoCuts) namesOnly, unusedCuts;
+            for(const auto& name: recoCutNames) namesOnly.emplace_back(new reco::SharedCut(name, nullptr));
+            copies.sidebands = app::setupSidebands(options->ConfigFile()["sidebands"], altDirForFid, fid->backgrounds, altUnivs, namesOnly, unusedCuts);
+
+            copies.byNominal[fid->study.get()] = copies.study.get();
+            for(const auto& pattern: fid->sidebands)
+            {
+              for(size_t whichSideband = 0; whichSideband < pattern.second.size(); ++whichSideband)
+              {
+                copies.byNominal[pattern.second[whichSideband].get()] = copies.sidebands.at(pattern.first)[whichSideband].get();
+              }
+            }
+
+            fid->alternateModels.push_back(std::move(copies));
+          }
+          catch(const std::runtime_error& e)
+          {
+            throw std::runtime_error("Failed to set up Studies for alternate model " + alt.name + ":\n" + e.what());
+          }
+        }
+        options->HistFile->cd();
+
+        //The Cutter is about to own these cuts, but they stay at the same addresses
+        std::vector<fid::Regions::cut_t*> required, sidebandCutsInOrder;
+        for(const auto& cut: recoCuts) required.push_back(cut.get());
+        for(const auto& cut: sidebandCuts) sidebandCutsInOrder.push_back(cut.get());
+        fid->regions = fid::Regions(*fid->study, fid->sidebands, required, sidebandCutsInOrder, fid->backgrounds);
+
+        fid->selection.reset(new PlotUtils::Cutter<evt::Universe, PlotUtils::detail::empty>(std::move(recoCuts), std::move(sidebandCuts), std::move(truthSignal), std::move(truthPhaseSpace)));
+
+        fiducials.push_back(std::move(fid));
       }
+      router = fid::Router(fiducials, !overrideTruthCuts);
+      blocks.reset(new reco::BlockEvaluator(sharedRecoCuts, options->ConfigFile()["app"]["columnarBlockSize"].as<size_t>(0)));
 
-      //Get POT for this file, but don't accumulate it until I've found the
-      //other trees I need.
-      PlotUtils::TreeWrapper meta(metaTree);
-      thisFilesPOT = meta.GetValue("POT_Used", 0);
-  
-      auto recoTree = dynamic_cast<TTree*>(tupleFile->Get(anaTupleName.c_str()));
-      if(!recoTree)
+      //Use weights from PrecomputeWeights instead of evaluating the model in every universe.
+      //A mismatched weight file isn't fatal.  The model just gets evaluated live like usual.
+      if(options->isMC() && options->ConfigFile()["app"]["precomputedWeights"])
       {
-        std::cerr << "Failed to find an AnaTuple named " << anaTupleName
-                  << " in " << fName << ".  Skipping this file name.\n";
-        continue; //TODO: Don't use continue if I can help it
+        const auto weightFileName = options->ConfigFile()["app"]["precomputedWeights"].as<std::string>();
+        try
+        {
+          precomputed = new app::PrecomputedWeights(weightFileName, app::weightConfigHash(options->ConfigFile(), playlist.name), universes);
+          std::vector<std::unique_ptr<PlotUtils::Reweighter<evt::Universe>>> fromFile;
+          fromFile.emplace_back(precomputed);
+          if(sampling->enabled()) fromFile.emplace_back(new app::SampleWeight(*sampling));
+          precomputedModel.reset(new PlotUtils::Model<evt::Universe>(std::move(fromFile)));
+        }
+        catch(const std::runtime_error& e)
+        {
+          precomputed = nullptr;
+          std::cerr << "Not using precomputed weights from " << weightFileName << " because:\n" << e.what() << "\nEvaluating the model for every event instead.\n";
+        }
+      }
+    }
+    catch(const std::runtime_error& e)
+    {
+      std::cerr << e.what() << "\n";
+      return app::CmdLine::YAMLError;
+    }
+
+    //End the job and warn the user if there are no Fiducials to process.
+    if(fiducials.empty())
+    {
+      std::cerr << "No fiducials to process.  Write a \"fiducials\" block in your YAML file and try again.\n";
+      return app::CmdLine::YAMLError;
+    }
+
+    //Stop before reading any events to find out whether this configuration fits in memory.
+    //Don't leave empty output files behind.  They'd stop the next job from creating its own.
+    if(dryRunMemory)
+    {
+      memoryBudget.printProjection(std::cout);
+
+      for(auto& alt: alternateModels)
+      {
+        const std::string altFileName = alt.file->GetName();
+        alt.file->Clear();
+        alt.file->Close();
+        alt.file.reset();
+        gSystem->Unlink(altFileName.c_str());
       }
-      //recoTree->SetCacheSize(1e7); //Read 10MB at a time
-                                   //TODO: I'll bet I could make this 4k blocks or something to be more efficient on modern SSDs
 
-      PlotUtils::TreeWrapper anaTuple(recoTree);
+      const std::string fileName = options->HistFile->GetName();
+      options->HistFile->Clear();
+      options->HistFile->Close();
+      options->HistFile.reset();
+      gSystem->Unlink(fileName.c_str());
+
+      return app::CmdLine::ExitCode::Success;
+    }
+
+    const bool anyoneWantsTruth = std::any_of(fiducials.begin(), fiducials.end(), [](const auto& fid) { return fid->study->wantsTruthLoop(); });
 
-      //Bookkeeping for when there's no efficiency numerator
-      const size_t nEntries = anaTuple.GetEntries();
+    //Accumulate POT from each good file
+    double pot_used = 0;
+    double pot_sampled = 0; //POT in the files a quick-look job actually read
 
-      //On to the event loops
-      if(options->isMC())
+    //Loop over files
+    LOG_DEBUG("Beginning loop over files.")
+    try
+    {
+      for(const auto& fName: playlist.files)
       {
-        //MC reco loop
-        const size_t nMCEntries = anaTuple.GetEntries();
-        weight_hadron<PlotUtils::TreeWrapper*>(&anaTuple).setDataTree(anaTuple.GetTree());
-        for(auto& compat: groupedUnivs)
+        LOG_DEBUG("Loading " << fName)
+        //Sanity checks on AnaTuple files
+        double thisFilesPOT = 0;
+        std::unique_ptr<TFile> tupleFile(TFile::Open(fName.c_str()));
+        if(tupleFile == nullptr)
+        {
+          std::cerr << fName << ": No such file or directory.  Skipping this "
+                    << "file name.\n";
+          continue; //TODO: Don't use break if I can help it
+        }
+
+        //TODO: Doesn't my ROOT error checking function throw an exception here?
+        if(app::IsMC(fName) != options->isMC())
+        {
+          std::cerr << "This job " << (options->isMC()?"is":"is not")
+                    << " processing MC files, but " << fName << " is a "
+                    << (app::IsMC(fName)?"MC":"data")
+                    << "file.  Skipping this file!\n";
+          continue; //TODO: Don't use break if I can help it
+        }
+  
+        auto metaTree = dynamic_cast<TTree*>(tupleFile->Get("Meta"));
+        if(!metaTree)
+        {
+          std::cerr << fName << " does not contain POT information!  This might be a merging failure.  Skipping this file.\n";
+          continue; //TODO: Don't use break if I can help it
+        }
+
+        //Get POT for this file, but don't accumulate it until I've found the
+        //other trees I need.
+        PlotUtils::TreeWrapper meta(metaTree);
+        thisFilesPOT = meta.GetValue("POT_Used", 0);
+  
+        auto recoTree = dynamic_cast<TTree*>(tupleFile->Get(anaTupleName.c_str()));
+        if(!recoTree)
         {
-          for(auto& univ: compat) univ->SetTreeMC(&anaTuple);
+          std::cerr << "Failed to find an AnaTuple named " << anaTupleName
+                    << " in " << fName << ".  Skipping this file name.\n";
+          continue; //TODO: Don't use continue if I can help it
         }
+        //recoTree->SetCacheSize(1e7); //Read 10MB at a time
+                                     //TODO: I'll bet I could make this 4k blocks or something to be more efficient on modern SSDs
+
+        PlotUtils::TreeWrapper anaTuple(recoTree);
 
-        //Get MINOS weights
-        PlotUtils::MinervaUniverse::SetTruth(false);
+        //Bookkeeping for when there's no efficiency numerator
+        const size_t nEntries = anaTuple.GetEntries();
 
-        for(size_t entry = 0; entry < nMCEntries; ++entry)
+        //Scale factors for this file's entries
+        sampling->setFile(fName);
+
+        //On to the event loops
+        if(options->isMC())
         {
-          #ifndef NDEBUG
-            if((entry % printFreq) == 0) std::cout << "Done with MC entry " << entry << "\n";
-          #endif
+          //MC reco loop
+          const size_t nMCEntries = anaTuple.GetEntries();
+          weight_hadron<PlotUtils::TreeWrapper*>(&anaTuple).setDataTree(anaTuple.GetTree());
+          for(auto& compat: groupedUnivs)
+          {
+            for(auto& univ: compat) univ->SetTreeMC(&anaTuple);
+          }
+
+          //Get MINOS weights
+          PlotUtils::MinervaUniverse::SetTruth(false);
+
+          const bool recoWeightsPrecomputed = precomputed && precomputed->SetTuple(fName, false, nMCEntries);
+          auto& recoModel = recoWeightsPrecomputed?*precomputedModel:cvModel;
+          if(precomputed && !recoWeightsPrecomputed) std::cerr << "No precomputed weights for " << fName << "'s " << anaTupleName << " tree.  Evaluating the model instead.\n";
+          blocks->setTree(*recoTree, nMCEntries);
 
-          for(auto& fid: fiducials)
+          for(size_t entry = 0; entry < nMCEntries; ++entry)
           {
+            #ifndef NDEBUG
+              if((entry % printFreq) == 0) std::cout << "Done with MC entry " << entry << "\n";
+            #endif
+
+            if(!sampling->keep(entry, false)) continue;
+
+            if(recoWeightsPrecomputed) precomputed->SetEntry(entry);
+
             cv->SetEntry(entry);
+            reco::SharedCut::nextEvent();
+            blocks->setEntry(entry, *cv);
+            for(auto& fid: fiducials) fid->regions.forgetTruth();
 
             //Fill "fake data" by treating MC exactly like data but using a weight.
             //This is useful for closure tests and warping studies.
             PlotUtils::detail::empty CVShared;
-            cvModel.SetEntry(*cv, CVShared);
-            const double cvWeight = cvModel.GetWeight(*cv, CVShared);
-            const auto CVPassedReco = fid->selection->isMCSelectedCV(*cv, CVShared, cvWeight);
-            const auto CVStudy = findSelectedOrSideband(CVPassedReco, *fid, *cv);
-            if(CVStudy) CVStudy->data(*cv, cvWeight);
+            recoModel.SetEntry(*cv, CVShared);
+            const double cvWeight = recoModel.GetWeight(*cv, CVShared);
+            std::vector<double> alternateCVWeights;
+            for(auto& alt: alternateModels)
+            {
+              alt.model->SetEntry(*cv, CVShared);
+              alternateCVWeights.push_back(alt.model->GetWeight(*cv, CVShared));
+            }
+
+            for(auto& fid: fiducials)
+            {
+              const auto CVPassedReco = fid->selection->isMCSelectedCV(*cv, CVShared, cvWeight);
+              const auto CVStudy = fid->regions.find(CVPassedReco, *cv);
+              if(CVStudy)
+              {
+                CVStudy->data(*cv, cvWeight);
+                for(size_t whichModel = 0; whichModel < alternateModels.size(); ++whichModel)
+                {
+                  fid->alternateModels[whichModel].byNominal.at(CVStudy)->data(*cv, alternateCVWeights[whichModel]);
+                }
+              }
+            } //For each Fiducial
 
+            //Other universes only go to Fiducials whose z range this vertex could be in
+            const auto& candidates = router.reco(cv->GetVtx().z());
             for(const auto& compat: groupedUnivs)
             {
-              auto& event = *compat.front(); //All compatible universes pass the same cuts
-	      PlotUtils::detail::empty shared;
-	      for(const auto univ: compat) univ->SetEntry(entry); //I still need to GetWeight() for entry
+              if(candidates.empty()) break; //Skip universe work entirely
 
-              //Bitfields encoding which reco cuts I passed.  Effectively, this hashes sidebands in a way that works even
-              //for sidebands defined by multiple cuts.
-              const auto passedReco = fid->selection->isSelectedWithNoStats(compat, shared);
+              auto& event = *compat.front(); //All compatible universes pass the same cuts
+              PlotUtils::detail::empty shared;
+              for(const auto univ: compat) univ->SetEntry(entry); //I still need to GetWeight() for entry
 
-              //All compatible universes are in the same selected/sideband region because they pass the same Cuts
-              auto whichStudy = findSelectedOrSideband(passedReco, *fid, *compat.front()); 
-              if(whichStudy)
+              //Cuts shared between Fiducials are only checked for the first Fiducial
+              for(const size_t whichFid: candidates)
               {
-                //Categorize by whether this is signal or some background
-                if(fid->selection->isSignal(event)) whichStudy->mcSignal(compat, cvModel, shared); //for(const auto univ: compat) whichStudy->mcSignal(*univ, cvModel.GetWeight(*univ, shared));
-                else //If not truthSignal
+                auto& fid = fiducials[whichFid];
+                //All compatible universes are in the same selected/sideband region because they pass the same Cuts.
+                //Stops checking cuts as soon as no Study could accept this event.
+                auto whichStudy = fid->regions.find(event, shared);
+                if(whichStudy)
                 {
-                  const auto foundBackground = std::find_if(fid->backgrounds.begin(), fid->backgrounds.end(),
-                                                            [&event](const auto& background)
-                                                            { return ::requireAll(background->passes, event); });
+                  //Categorize by whether this is signal or some background.  Only checked once per entry.
+                  const auto truth = fid->regions.classify(event, *fid->selection);
+                  if(truth.isSignal) whichStudy->mcSignal(compat, recoModel, shared); //for(const auto univ: compat) whichStudy->mcSignal(*univ, recoModel.GetWeight(*univ, shared));
+                  else whichStudy->mcBackground(compat, *truth.background, recoModel, shared); //If not truthSignal
+
+                  //Same Study under each alternate model.  Only the weights are different.
+                  for(size_t whichModel = 0; whichModel < alternateModels.size(); ++whichModel)
+                  {
+                    const auto& alt = alternateModels[whichModel];
+                    if(!alt.universes && &compat != &*groupWithCV) continue;
+
+                    auto altStudy = fid->alternateModels[whichModel].byNominal.at(whichStudy);
+                    const auto& altUnivs = alt.universes?compat:cvGroup;
+                    if(truth.isSignal) altStudy->mcSignal(altUnivs, *alt.model, shared);
+                    else altStudy->mcBackground(altUnivs, *truth.background, *alt.model, shared);
+                  }
+                } //If found a Study to fill.  Could be either signal or sideband.  Means that at least some cuts passed.
+              } //For each Fiducial
+            } //For each error band
+          } //For each entry in the MC tree
+
+          //Truth loop
+          if(anyoneWantsTruth)
+          {
+            auto truthTree = dynamic_cast<TTree*>(tupleFile->Get("Truth"));
+            if(!truthTree)
+            {
+              std::cerr << "Failed to find an AnaTuple named Truth "
+                        << " in " << fName << ".  Skipping this file name.\n";
+              continue; //TODO: Don't use continue if I can help it
+            }
+            //truthTree->SetCacheSize(1e7); //Read 10MB at a time
+            PlotUtils::TreeWrapper truthTuple(truthTree);
+
+            const size_t nTruthEntries = truthTuple.GetEntries();
+            weight_hadron<PlotUtils::TreeWrapper*>(&truthTuple).setDataTree(truthTuple.GetTree());
+            for(auto& compat: groupedUnivs)
+            {
+              for(auto univ: compat) univ->SetTreeMC(&truthTuple); //TODO: Is MnvHadronReweight even compatible with the truth tree?
+            }
 
-                  whichStudy->mcBackground(compat, ::derefOrNull(foundBackground, fid->backgrounds.end()), cvModel, shared);
-                } //If not truthSignal
-              } //If found a Study to fill.  Could be either signal or sideband.  Means that at least some cuts passed.
-            } //For each Fiducial
-          } //For each error band
-        } //For each entry in the MC tree
+            //Don't try to get MINOS weights in the truth tree loop
+            PlotUtils::MinervaUniverse::SetTruth(true);
 
-        //Truth loop
-        if(anyoneWantsTruth)
-        {
-          auto truthTree = dynamic_cast<TTree*>(tupleFile->Get("Truth"));
-          if(!truthTree)
-          {
-            std::cerr << "Failed to find an AnaTuple named Truth "
-                      << " in " << fName << ".  Skipping this file name.\n";
-            continue; //TODO: Don't use continue if I can help it
-          }
-          //truthTree->SetCacheSize(1e7); //Read 10MB at a time
-          PlotUtils::TreeWrapper truthTuple(truthTree);
+            const bool truthWeightsPrecomputed = precomputed && precomputed->SetTuple(fName, true, nTruthEntries);
+            auto& truthModel = truthWeightsPrecomputed?*precomputedModel:cvModel;
+            if(precomputed && !truthWeightsPrecomputed) std::cerr << "No precomputed weights for " << fName << "'s Truth tree.  Evaluating the model instead.\n";
 
-          const size_t nTruthEntries = truthTuple.GetEntries();
-          weight_hadron<PlotUtils::TreeWrapper*>(&truthTuple).setDataTree(truthTuple.GetTree());
-          for(auto& compat: groupedUnivs)
-          {
-            for(auto univ: compat) univ->SetTreeMC(&truthTuple); //TODO: Is MnvHadronReweight even compatible with the truth tree?
-          }
+            for(size_t entry = 0; entry < nTruthEntries; ++entry)
+            {
+              #ifndef NDEBUG
+                if((entry % printFreq) == 0) std::cout << "Done with truth entry " << entry << "\n";
+              #endif
 
-          //Don't try to get MINOS weights in the truth tree loop
-          PlotUtils::MinervaUniverse::SetTruth(true);
+              if(!sampling->keep(entry, true)) continue;
 
-          for(size_t entry = 0; entry < nTruthEntries; ++entry)
-          {
-            #ifndef NDEBUG
-              if((entry % printFreq) == 0) std::cout << "Done with truth entry " << entry << "\n";
-            #endif
+              if(truthWeightsPrecomputed) precomputed->SetEntry(entry);
 
-            for(auto& fid: fiducials)
-            {
               cv->SetEntry(entry);
               PlotUtils::detail::empty shared;
-              cvModel.SetEntry(*cv, shared);
-              const double truthCVWeightForCuts = cvModel.GetWeight(*cv, shared);
+              truthModel.SetEntry(*cv, shared);
+              const double truthCVWeightForCuts = truthModel.GetWeight(*cv, shared);
+              for(auto& alt: alternateModels) alt.model->SetEntry(*cv, shared);
 
+              //Every Fiducial's cut table sees the CV group, but other universes only go to
+              //Fiducials whose z range this vertex could be in.
+              const auto& candidates = router.truth(cv->GetTruthVtx().z());
               for(const auto& compat: groupedUnivs)
               {
+                const bool isCVGroup = (&compat == &*groupWithCV);
+                if(!isCVGroup && candidates.empty()) continue; //Skip universe work entirely
+
                 auto& event = *compat.front(); //All compatible universes pass the same cuts
-                for(auto univ: compat) univ->SetEntry(entry); //TODO: This could be moved to the loop over compatible universes below.
-  
-                if(fid->selection->isEfficiencyDenom(event, truthCVWeightForCuts))
+                for(auto univ: compat) univ->SetEntry(entry);
+
+                for(const size_t whichFid: isCVGroup?router.all():candidates)
                 {
-                  fid->study->truth(compat, cvModel, shared);
-                } //If event passes all truth cuts
+                  auto& fid = fiducials[whichFid];
+                  if(fid->selection->isEfficiencyDenom(event, truthCVWeightForCuts))
+                  {
+                    fid->study->truth(compat, truthModel, shared);
+
+                    for(size_t whichModel = 0; whichModel < alternateModels.size(); ++whichModel)
+                    {
+                      const auto& alt = alternateModels[whichModel];
+                      if(alt.universes) fid->alternateModels[whichModel].study->truth(compat, *alt.model, shared);
+                      else if(isCVGroup) fid->alternateModels[whichModel].study->truth(cvGroup, *alt.model, shared);
+                    }
+                  } //If event passes all truth cuts
+                } //For each Fiducial
               } //For each error band
+            } //For each entry in Truth tree
+          } //If wantsTruthLoop
+        } //If isThisJobMC
+        else
+        {
+          //Data loop
+          cv->SetTree(&anaTuple);
+          blocks->setTree(*recoTree, nEntries);
+
+          for(size_t entry = 0; entry < nEntries; ++entry)
+          {
+            #ifndef NDEBUG
+              if((entry % printFreq) == 0) std::cout << "Done with data entry " << entry << "\n";
+            #endif
+
+            if(!sampling->keep(entry, false)) continue;
+
+            cv->SetEntry(entry);
+            reco::SharedCut::nextEvent();
+            blocks->setEntry(entry, *cv);
+
+            PlotUtils::detail::empty shared;
+
+            for(auto& fid: fiducials)
+            {
+              const auto passedCuts = fid->selection->isDataSelected(*cv, shared);
+              auto whichStudy = fid->regions.find(passedCuts, *cv);
+              if(whichStudy) whichStudy->data(*cv, sampling->weight());
             } //For each Fiducial
-          } //For each entry in Truth tree
-        } //If wantsTruthLoop
-      } //If isThisJobMC
-      else
+          } //For each entry in data tree
+        } //If not isThisJobMC
+
+        //I've finished with this file, so I guess I read it sucessfully.  Time to count its POT.
+        pot_used += thisFilesPOT * sampling->potScale();
+        pot_sampled += thisFilesPOT;
+      } //For each AnaTuple file
+    } //try-catch on whole event loop
+      //histFile gets destroyed and writes its histograms here
+    //If I ever want to handle ROOT warnings differently, this is
+    //the place to implement that behavior.
+    catch(const ROOT::warning& e)
+    {
+      std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
+    catch(const ROOT::error& e)
+    {
+      std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
+    catch(const std::runtime_error& e)
+    {
+      std::cerr << "Got a fatal std::runtime_error while running the analysis:\n"
+                << e.what() << "\nExiting immediately, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::AnalysisError;
+    }
+
+    //Give Studies a chance to syncCVHistos()
+    try
+    {
+      //Each Fiducial's objects go to the writer as soon as its afterAllFiles() is done.  The writer
+      //has the output file to itself from now on, so nothing made on this thread goes in any directory.
+      std::vector<std::vector<TObject*>> toWrite;
+      if(writer)
       {
-        //Data loop
-        cv->SetTree(&anaTuple);
+        writer->drain(); //Every TTree::Fill() from the event loop
+        memoryBudget.freezeFilled(); //Histograms will be deleted once they're written
 
-        for(size_t entry = 0; entry < nEntries; ++entry)
-        {
-          #ifndef NDEBUG
-            if((entry % printFreq) == 0) std::cout << "Done with data entry " << entry << "\n";
-          #endif
+        std::vector<std::string> fidPrefixes;
+        for(const auto& fid: fiducials) fidPrefixes.push_back(util::SafeROOTName(fid->name) + "_");
+        toWrite = ::detach(*options->HistFile, fidPrefixes);
+      }
+      TDirectory::TContext noDirectory(writer?nullptr:gDirectory);
 
-          cv->SetEntry(entry);
+      for(size_t whichFid = 0; whichFid < fiducials.size(); ++whichFid)
+      {
+        auto& fid = fiducials[whichFid];
+        const events totalPassedCuts = fid->selection->totalWeightPassed();
 
-          PlotUtils::detail::empty shared;
+        fid->study->afterAllFiles(totalPassedCuts);
+        for(auto& cutGroup: fid->sidebands)
+        {
+          for(auto& sideband: cutGroup.second) sideband->afterAllFiles(totalPassedCuts);
+        }
 
-          for(auto& fid: fiducials)
+        for(auto& copies: fid->alternateModels)
+        {
+          copies.study->afterAllFiles(totalPassedCuts);
+          for(auto& cutGroup: copies.sidebands)
           {
-            const auto passedCuts = fid->selection->isDataSelected(*cv, shared);
-            auto whichStudy = findSelectedOrSideband(passedCuts, *fid, *cv);
-            if(whichStudy) whichStudy->data(*cv);
-          } //For each Fiducial
-        } //For each entry in data tree
-      } //If not isThisJobMC
-
-      //I've finished with this file, so I guess I read it sucessfully.  Time to count its POT.
-      pot_used += thisFilesPOT;
-    } //For each AnaTuple file
-  } //try-catch on whole event loop
-    //histFile gets destroyed and writes its histograms here
-  //If I ever want to handle ROOT warnings differently, this is
-  //the place to implement that behavior.
-  catch(const ROOT::warning& e)
-  {
-    std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::IOError;
-  }
-  catch(const ROOT::error& e)
-  {
-    std::cerr << e.what() << "\nInterrupting the event loop, so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::IOError;
-  }
-  catch(const std::runtime_error& e)
-  {
-    std::cerr << "Got a fatal std::runtime_error while running the analysis:\n"
-              << e.what() << "\nExiting immediately, so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::AnalysisError;
-  }
+            for(auto& sideband: cutGroup.second) sideband->afterAllFiles(totalPassedCuts);
+          }
+        }
 
-  //Give Studies a chance to syncCVHistos()
-  try
-  {
-    for(auto& fid: fiducials)
+        //Compress and write this Fiducial's objects while the next Fiducial finishes its histograms
+        if(writer) ::writeAsync(*options->HistFile, std::move(toWrite[whichFid]), *writer);
+      }
+
+      if(writer) ::writeAsync(*options->HistFile, std::move(toWrite.back()), *writer);
+    }
+    catch(const ROOT::warning& e)
     {
-      const events totalPassedCuts = fid->selection->totalWeightPassed();
+      std::cerr << e.what() << "\nInterrupting afterAllFiles(), so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
+    catch(const ROOT::error& e)
+    {
+      std::cerr << e.what() << "\nInterrupting afterAllFiles(), so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
+    catch(const std::runtime_error& e)
+    {
+      std::cerr << "Got a fatal std::runtime_error while running afterAllFiles():\n"
+                << e.what() << "\nExiting immediately, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::AnalysisError;
+    }
 
-      fid->study->afterAllFiles(totalPassedCuts);
-      for(auto& cutGroup: fid->sidebands)
-      {
-        for(auto& sideband: cutGroup.second) sideband->afterAllFiles(totalPassedCuts);
-      }
+    //Fraction of the AnaTuples a quick-look job read.  Histograms, cut tables, and POT are scaled up to the whole sample.
+    double samplingFraction = 1;
+    std::string samplingNote;
+    if(sampling->enabled())
+    {
+      samplingFraction = sampling->byFiles()?((pot_used > 0)?pot_sampled / pot_used:1):sampling->fraction();
+      samplingNote = "#Sampled " + std::to_string(samplingFraction) + " of the " + (sampling->byFiles()?"POT":"entries") + ".  Weights and POT are scaled up to the full sample.\n";
     }
-  }
-  catch(const ROOT::warning& e)
-  {
-    std::cerr << e.what() << "\nInterrupting afterAllFiles(), so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::IOError;
-  }
-  catch(const ROOT::error& e)
-  {
-    std::cerr << e.what() << "\nInterrupting afterAllFiles(), so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::IOError;
-  }
-  catch(const std::runtime_error& e)
-  {
-    std::cerr << "Got a fatal std::runtime_error while running afterAllFiles():\n"
-              << e.what() << "\nExiting immediately, so you probably got incomplete results!\n";
-    return app::CmdLine::ExitCode::AnalysisError;
-  }
 
-  //Print the cut table for the first Fiducial to STDOUT
-  assert(fiducials.size() > 0 && "No Fiducials to print at the end of the event loop!");
-  std::cout << "#" << pot_used << " POT\n" << fiducials.front()->name << "\n#Selection:\n" << *fiducials.front()->selection << "\n\n";
-  std::cout << "#Git commit hash: " << git::commitHash() << "\n";
+    //Print the cut table for the first Fiducial to STDOUT
+    assert(fiducials.size() > 0 && "No Fiducials to print at the end of the event loop!");
+    std::cout << "#" << playlist.name << "\n#" << pot_used << " POT\n" << samplingNote << fiducials.front()->name << "\n#Selection:\n" << *fiducials.front()->selection << "\n\n";
+    std::cout << "#Git commit hash: " << git::commitHash() << "\n";
 
-  for(const auto& fid: fiducials)
-  {
-    std::string tableName = options->HistFile->GetName();
-    tableName = tableName.substr(0, tableName.find('.'));
-    tableName += util::SafeROOTName(fid->name);
-    tableName += ".md"; //Markdown
-    std::ofstream tableFile(tableName);
+    for(const auto& fid: fiducials)
+    {
+      std::string tableName = options->HistFile->GetName();
+      tableName = tableName.substr(0, tableName.find('.'));
+      tableName += util::SafeROOTName(fid->name);
+      tableName += ".md"; //Markdown
+      std::ofstream tableFile(tableName);
+
+      tableFile << "#" << fid->name << "\n";
+      tableFile << "#" << playlist.name << "\n";
+      tableFile << "#" << pot_used << " POT\n";
+      tableFile << samplingNote;
+
+      tableFile << "#Selection:\n" << *fid->selection << "\n";
+    }
 
-    tableFile << "#" << fid->name << "\n";
-    tableFile << "#" << options->playlist() << "\n";
-    tableFile << "#" << pot_used << " POT\n";
+    //List histograms that were never filled so they can be pruned from the configuration
+    {
+      std::string unfilledName = options->HistFile->GetName();
+      unfilledName = unfilledName.substr(0, unfilledName.find('.')) + "NeverFilled.txt";
+      std::ofstream unfilledFile(unfilledName);
+      const size_t nNeverFilled = memoryBudget.printNeverFilled(unfilledFile);
+      std::cout << "#" << nNeverFilled << " histograms were never filled.  They're listed in " << unfilledName << "\n";
+    }
 
-    tableFile << "#Selection:\n" << *fid->selection << "\n";
-  }
+    //Metadata for every output file
+    auto pot = new TParameter<double>("POTUsed", pot_used);
+    auto fraction = new TParameter<double>("SamplingFraction", samplingFraction);
+    auto commitHash = new TNamed("NucCCNeutronsGitCommitHash", git::commitHash());
+    auto playlistName = new TNamed("playlist", playlist.name.c_str());
 
-  //Write metadata to output file
-  options->HistFile->cd();
-  auto pot = new TParameter<double>("POTUsed", pot_used);
-  pot->Write();
+    try
+    {
+      //The writer may still be writing the output file while this thread writes the alternate models' files.
+      //Each alternate model's file has everything a separate job's file would except cut tables
+      for(auto& alt: alternateModels)
+      {
+        alt.file->cd();
+        pot->Write();
+        if(sampling->enabled()) fraction->Write();
+        commitHash->Write();
+        playlistName->Write();
+        TNamed("model", alt.name.c_str()).Write();
+        alt.index.write(*alt.file);
+        alt.file->Write();
+      }
 
-  auto commitHash = new TNamed("NucCCNeutronsGitCommitHash", git::commitHash());
-  commitHash->Write();
+      if(writer) writer->drain();
+    }
+    catch(const ROOT::warning& e)
+    {
+      std::cerr << e.what() << "\nFailed to write histograms, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
+    catch(const ROOT::error& e)
+    {
+      std::cerr << e.what() << "\nFailed to write histograms, so you probably got incomplete results!\n";
+      return app::CmdLine::ExitCode::IOError;
+    }
 
-  auto playlist = new TNamed("playlist", options->playlist().c_str());
-  playlist->Write();
+    //Write metadata to output file
+    options->HistFile->cd();
+    pot->Write();
+    if(sampling->enabled()) fraction->Write();
+    commitHash->Write();
+    playlistName->Write();
+    histIndex.write(*options->HistFile);
+
+    //Done with this playlist's output file.  CmdLine writes the last one otherwise.
+    if(splitByPlaylist)
+    {
+      options->HistFile->Write();
+      options->HistFile.reset();
+    }
+  } //For each playlist
 
   return app::CmdLine::ExitCode::Success;
 }
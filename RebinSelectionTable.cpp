@@ -0,0 +1,566 @@
+//File: RebinSelectionTable.cpp
+//Brief: Turn the per-event tables written by SelectionTable into the same histograms
+//       that CrossSectionSignal and CrossSectionSideband would have made with any binning.
+//       All rows are read into memory once, then split among threads that each fill
+//       their own flat arrays of bin contents for every universe.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#define USAGE \
+"USAGE: RebinSelectionTable <binning.yaml> <tables.root> [moreTables.root]...\n"\
+"******************************** Explanation ********************************\n"\
+"Fills histograms from every SelectionTable in each <tables.root> using the bins\n"\
+"in <binning.yaml>.  Writes a file named after each <tables.root> with\n"\
+"\"_rebinned\" appended that can be used like ProcessAnaTuples output by\n"\
+"ExtractCrossSection, FitSidebands, and MergeAndScaleByPOT.  Everything in\n"\
+"<tables.root> that isn't a TTree is copied as-is.\n"\
+"*************************** Binning Configuration ***************************\n"\
+"binning: [0, 0.5, 1, 2]      #Reco bins for every table\n"\
+"truthBinning: [0, 1, 2]      #Optional truth bins.  Defaults to binning.\n"\
+"nThreads: 8                  #Optional.  Defaults to every core.\n"\
+"tables:                      #Optional bins for individual tables\n"\
+"  Tracker_Signal:            #Table names without _SelectionTable\n"\
+"    binning: [0, 1, 2]\n"\
+"************************************* I/O ***********************************\n"\
+"Input: 1 or more ROOT files produced by ProcessAnaTuples with SelectionTables\n"\
+"Output: 1 .root file for each input file with \"_rebinned\" in its name\n"\
+"Errors: 0 is returned to the OS on success.  Anything else indicates\n"\
+"        failure.  Error messages are printed to stderr only.\n"\
+"*****************************************************************************\n"
+
+//analyses includes
+#include "analyses/studies/SelectionTableFormat.h"
+
+//util includes
+#include "util/SafeROOTName.h"
+
+//PlotUtils includes
+//No junk from PlotUtils please!  I already
+//know that MnvH1D does horrible horrible things.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverloaded-virtual"
+#include "PlotUtils/MnvH1D.h"
+#include "PlotUtils/MnvH2D.h"
+#pragma GCC diagnostic pop
+
+//YAML-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TList.h"
+
+//Feature needed with pre-ROOT6 PlotUtils.
+#ifndef NCINTEX
+#include "Cintex/Cintex.h"
+#endif
+
+//c++ includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+enum errors
+{
+  success = 0,
+  badCommandLine = 1,
+  badBinning = 2,
+  badOutputFile = 3,
+  inputFileFailed = 4,
+  badTable = 5
+};
+
+namespace
+{
+  const std::string recoTreeSuffix = std::string("_") + ana::table::recoTreeName;
+
+  //One row of a SelectionTable.  Weights for all rows live in Table::weights.
+  struct Row
+  {
+    int category;
+    int group;
+    double reco;
+    double truth;
+    size_t firstWeight;
+    size_t nWeights;
+  };
+
+  struct Table
+  {
+    std::string prefix; //Name of the Directory the SelectionTable was in
+    std::string variable;
+    std::string unit;
+    std::string weightUnit;
+    bool isSideband;
+    std::vector<std::string> categories;
+    std::map<int, std::vector<std::string>> groups; //Universe name of each column by group
+
+    std::vector<Row> recoRows;
+    std::vector<Row> truthRows;
+    std::vector<float> weights;
+  };
+
+  std::vector<std::string> splitLines(const std::string& text)
+  {
+    std::vector<std::string> lines;
+    std::stringstream stream(text);
+    for(std::string line; std::getline(stream, line); ) lines.push_back(line);
+    return lines;
+  }
+
+  std::string getInfo(TTree& tree, const std::string& name)
+  {
+    const auto info = dynamic_cast<TNamed*>(tree.GetUserInfo()->FindObject(name.c_str()));
+    if(!info) throw std::runtime_error(std::string(tree.GetName()) + " doesn't have metadata named " + name + ".  Was ProcessAnaTuples interrupted?");
+    return info->GetTitle();
+  }
+
+  void readRows(TTree& tree, const bool hasReco, std::vector<Row>& rows, std::vector<float>& weights)
+  {
+    int category = 0, group = 0;
+    double reco = 0, truth = 0;
+    std::vector<float>* rowWeights = nullptr;
+
+    tree.SetBranchAddress("category", &category);
+    tree.SetBranchAddress("group", &group);
+    tree.SetBranchAddress("truth", &truth);
+    tree.SetBranchAddress("weights", &rowWeights);
+    if(hasReco) tree.SetBranchAddress("reco", &reco);
+
+    const size_t nEntries = tree.GetEntries();
+    rows.reserve(nEntries);
+    for(size_t entry = 0; entry < nEntries; ++entry)
+    {
+      tree.GetEntry(entry);
+      rows.push_back(Row{category, group, reco, truth, weights.size(), rowWeights->size()});
+      weights.insert(weights.end(), rowWeights->begin(), rowWeights->end());
+    }
+
+    tree.ResetBranchAddresses();
+    delete rowWeights;
+  }
+
+  Table readTable(TFile& file, TTree& recoTree)
+  {
+    Table table;
+    const std::string treeName = recoTree.GetName();
+    table.prefix = treeName.substr(0, treeName.size() - recoTreeSuffix.size());
+    table.variable = getInfo(recoTree, ana::table::variableName);
+    table.unit = getInfo(recoTree, ana::table::unitName);
+    table.weightUnit = getInfo(recoTree, ana::table::weightUnitName);
+    table.isSideband = (getInfo(recoTree, ana::table::roleName) == "sideband");
+    table.categories = splitLines(getInfo(recoTree, ana::table::categoriesName));
+
+    for(const auto obj: *recoTree.GetUserInfo())
+    {
+      const std::string name = obj->GetName();
+      if(name.find(ana::table::groupPrefix) == 0) table.groups[std::stoi(name.substr(std::string(ana::table::groupPrefix).size()))] = splitLines(obj->GetTitle());
+    }
+
+    readRows(recoTree, true, table.recoRows, table.weights);
+    if(!table.isSideband)
+    {
+      auto truthTree = dynamic_cast<TTree*>(file.Get((table.prefix + "_" + ana::table::truthTreeName).c_str()));
+      if(!truthTree) throw std::runtime_error("Signal table " + table.prefix + " doesn't have a " + ana::table::truthTreeName + ".");
+      readRows(*truthTree, false, table.truthRows, table.weights);
+    }
+
+    return table;
+  }
+
+  //Where to find a bin: same answer as TAxis::FindBin() for variable bin widths
+  int findBin(const std::vector<double>& edges, const double x)
+  {
+    return std::distance(edges.begin(), std::upper_bound(edges.begin(), edges.end(), x));
+  }
+
+  //Bin contents for every universe in one contiguous block.  Universe 0 is the CV.
+  struct Accumulator
+  {
+    Accumulator(const size_t nBins, const size_t nUnivs): fNBins(nBins), sumw(nBins * nUnivs, 0), sumw2(nBins * nUnivs, 0) {}
+
+    inline void Fill(const size_t univ, const size_t bin, const double weight)
+    {
+      sumw[univ * fNBins + bin] += weight;
+      sumw2[univ * fNBins + bin] += weight * weight;
+    }
+
+    Accumulator& operator +=(const Accumulator& other)
+    {
+      std::transform(sumw.begin(), sumw.end(), other.sumw.begin(), sumw.begin(), std::plus<double>());
+      std::transform(sumw2.begin(), sumw2.end(), other.sumw2.begin(), sumw2.begin(), std::plus<double>());
+      return *this;
+    }
+
+    size_t fNBins; //Including underflow and overflow
+    std::vector<double> sumw;
+    std::vector<double> sumw2;
+  };
+
+  //Which universe every column of every group of weights goes into
+  struct UniverseLayout
+  {
+    UniverseLayout(const Table& table)
+    {
+      std::map<std::string, size_t> nUnivs;
+      for(const auto& group: table.groups)
+      {
+        for(const auto& column: group.second)
+        {
+          const auto band = column.substr(0, column.rfind('_'));
+          const size_t whichUniv = std::stoul(column.substr(column.rfind('_') + 1));
+          if(band != "cv") nUnivs[band] = std::max(nUnivs[band], whichUniv + 1);
+        }
+      }
+
+      size_t nextSlot = 1; //0 is the CV
+      for(const auto& band: nUnivs)
+      {
+        bands.emplace_back(band.first, nextSlot);
+        nextSlot += band.second;
+      }
+      size = nextSlot;
+
+      for(const auto& group: table.groups)
+      {
+        auto& slots = columns[group.first];
+        for(const auto& column: group.second)
+        {
+          const auto band = column.substr(0, column.rfind('_'));
+          const size_t whichUniv = std::stoul(column.substr(column.rfind('_') + 1));
+          if(band == "cv") slots.push_back(0);
+          else slots.push_back(std::find_if(bands.begin(), bands.end(), [&band](const auto& other) { return other.first == band; })->second + whichUniv);
+        }
+      }
+    }
+
+    std::vector<std::pair<std::string, size_t>> bands; //Name of each error band and the slot of its first universe
+    std::map<int, std::vector<size_t>> columns; //Slot for each column in each group
+    size_t size;
+
+    size_t nUnivs(const size_t whichBand) const
+    {
+      return ((whichBand + 1 < bands.size())?bands[whichBand + 1].second:size) - bands[whichBand].second;
+    }
+  };
+
+  //Everything filled from a Table.  Histograms are in the same order as names().
+  struct Histograms
+  {
+    Histograms(const Table& table, const std::vector<double>& recoBins, const std::vector<double>& truthBins, const size_t nUnivs):
+      fRecoBins(recoBins), fTruthBins(truthBins), data(recoBins.size() + 1, 1),
+      selected(recoBins.size() + 1, nUnivs), effNum(truthBins.size() + 1, nUnivs), effDenom(truthBins.size() + 1, nUnivs),
+      migration((recoBins.size() + 1) * (truthBins.size() + 1), nUnivs)
+    {
+      for(size_t whichBackground = 1; whichBackground < table.categories.size(); ++whichBackground) backgrounds.emplace_back(recoBins.size() + 1, nUnivs);
+    }
+
+    Histograms& operator +=(const Histograms& other)
+    {
+      data += other.data;
+      selected += other.selected;
+      effNum += other.effNum;
+      effDenom += other.effDenom;
+      migration += other.migration;
+      for(size_t whichBackground = 0; whichBackground < backgrounds.size(); ++whichBackground) backgrounds[whichBackground] += other.backgrounds[whichBackground];
+      return *this;
+    }
+
+    void fillReco(const Row& row, const std::vector<float>& weights, const UniverseLayout& layout)
+    {
+      const int recoBin = findBin(fRecoBins, row.reco);
+      if(row.category == ana::table::dataCategory)
+      {
+        data.Fill(0, recoBin, weights[row.firstWeight]);
+        return;
+      }
+
+      const auto& slots = layout.columns.at(row.group);
+      if(row.category == ana::table::signalCategory)
+      {
+        const int truthBin = findBin(fTruthBins, row.truth);
+        const int migrationBin = recoBin + (fRecoBins.size() + 1) * truthBin; //Same layout as TH2::GetBin()
+        for(size_t whichColumn = 0; whichColumn < row.nWeights; ++whichColumn)
+        {
+          const double weight = weights[row.firstWeight + whichColumn];
+          selected.Fill(slots[whichColumn], recoBin, weight);
+          effNum.Fill(slots[whichColumn], truthBin, weight);
+          migration.Fill(slots[whichColumn], migrationBin, weight);
+        }
+      }
+      else
+      {
+        auto& background = backgrounds[row.category - 1];
+        for(size_t whichColumn = 0; whichColumn < row.nWeights; ++whichColumn) background.Fill(slots[whichColumn], recoBin, weights[row.firstWeight + whichColumn]);
+      }
+    }
+
+    void fillTruth(const Row& row, const std::vector<float>& weights, const UniverseLayout& layout)
+    {
+      const int truthBin = findBin(fTruthBins, row.truth);
+      const auto& slots = layout.columns.at(row.group);
+      for(size_t whichColumn = 0; whichColumn < row.nWeights; ++whichColumn) effDenom.Fill(slots[whichColumn], truthBin, weights[row.firstWeight + whichColumn]);
+    }
+
+    const std::vector<double>& fRecoBins;
+    const std::vector<double>& fTruthBins;
+
+    Accumulator data; //CV only just like data() in a CrossSectionSignal
+    Accumulator selected; //Signal events in the reco selection
+    Accumulator effNum;
+    Accumulator effDenom;
+    Accumulator migration;
+    std::vector<Accumulator> backgrounds; //By category - 1
+  };
+
+  //Split rows evenly among nThreads threads that each fill their own Histograms.  Then, add them up.
+  Histograms fillInParallel(const Table& table, const UniverseLayout& layout, const std::vector<double>& recoBins,
+                            const std::vector<double>& truthBins, const size_t nThreads)
+  {
+    std::vector<Histograms> perThread(nThreads, Histograms(table, recoBins, truthBins, layout.size));
+    std::vector<std::thread> threads;
+
+    for(size_t whichThread = 0; whichThread < nThreads; ++whichThread)
+    {
+      threads.emplace_back([&table, &layout, &perThread, whichThread, nThreads]()
+                           {
+                             auto& hists = perThread[whichThread];
+                             for(size_t whichRow = whichThread; whichRow < table.recoRows.size(); whichRow += nThreads) hists.fillReco(table.recoRows[whichRow], table.weights, layout);
+                             for(size_t whichRow = whichThread; whichRow < table.truthRows.size(); whichRow += nThreads) hists.fillTruth(table.truthRows[whichRow], table.weights, layout);
+                           });
+    }
+    for(auto& thread: threads) thread.join();
+
+    for(size_t whichThread = 1; whichThread < nThreads; ++whichThread) perThread.front() += perThread[whichThread];
+    return perThread.front();
+  }
+
+  //Copy univ's contents from sums into a histogram with the same global bin numbers
+  void setContents(TH1& hist, const Accumulator& sums, const size_t univ)
+  {
+    for(size_t whichBin = 0; whichBin < sums.fNBins; ++whichBin)
+    {
+      hist.SetBinContent(whichBin, sums.sumw[univ * sums.fNBins + whichBin]);
+      hist.SetBinError(whichBin, std::sqrt(sums.sumw2[univ * sums.fNBins + whichBin]));
+    }
+  }
+
+  //Same contents and error bands as a SyncCVHistos()ed HistWrapper<>
+  PlotUtils::MnvH1D* makeHist(const std::string& name, const std::string& title, const std::vector<double>& bins,
+                              const Accumulator& sums, const UniverseLayout& layout)
+  {
+    auto hist = new PlotUtils::MnvH1D(name.c_str(), title.c_str(), bins.size() - 1, bins.data());
+    setContents(*hist, sums, 0);
+
+    for(size_t whichBand = 0; whichBand < layout.bands.size(); ++whichBand)
+    {
+      //Data only has a CV, so leave its universes empty like HistWrapper<> does
+      std::vector<TH1D*> univHists;
+      for(size_t whichUniv = 0; whichUniv < layout.nUnivs(whichBand); ++whichUniv)
+      {
+        univHists.push_back(new TH1D((name + "_" + layout.bands[whichBand].first + "_" + std::to_string(whichUniv)).c_str(), title.c_str(), bins.size() - 1, bins.data()));
+        if(sums.sumw.size() > sums.fNBins) setContents(*univHists.back(), sums, layout.bands[whichBand].second + whichUniv);
+      }
+      hist->AddVertErrorBand(layout.bands[whichBand].first, univHists);
+      for(auto univHist: univHists) delete univHist;
+    }
+
+    return hist;
+  }
+
+  PlotUtils::MnvH2D* makeHist2D(const std::string& name, const std::string& title, const std::vector<double>& xBins,
+                                const std::vector<double>& yBins, const Accumulator& sums, const UniverseLayout& layout)
+  {
+    auto hist = new PlotUtils::MnvH2D(name.c_str(), title.c_str(), xBins.size() - 1, xBins.data(), yBins.size() - 1, yBins.data());
+    setContents(*hist, sums, 0);
+
+    for(size_t whichBand = 0; whichBand < layout.bands.size(); ++whichBand)
+    {
+      std::vector<TH2D*> univHists;
+      for(size_t whichUniv = 0; whichUniv < layout.nUnivs(whichBand); ++whichUniv)
+      {
+        univHists.push_back(new TH2D((name + "_" + layout.bands[whichBand].first + "_" + std::to_string(whichUniv)).c_str(), title.c_str(),
+                                     xBins.size() - 1, xBins.data(), yBins.size() - 1, yBins.data()));
+        setContents(*univHists.back(), sums, layout.bands[whichBand].second + whichUniv);
+      }
+      hist->AddVertErrorBand(layout.bands[whichBand].first, univHists);
+      for(auto univHist: univHists) delete univHist;
+    }
+
+    return hist;
+  }
+
+  //Put the one bin flux integral from a signal table into every bin of truthBins
+  PlotUtils::MnvH1D* expandFlux(const PlotUtils::MnvH1D& oneBin, const std::string& name, const std::vector<double>& truthBins)
+  {
+    auto flux = new PlotUtils::MnvH1D(name.c_str(), oneBin.GetTitle(), truthBins.size() - 1, truthBins.data());
+    for(size_t whichBin = 0; whichBin <= truthBins.size(); ++whichBin)
+    {
+      flux->SetBinContent(whichBin, oneBin.GetBinContent(1));
+      flux->SetBinError(whichBin, oneBin.GetBinError(1));
+    }
+
+    for(const auto& bandName: oneBin.GetVertErrorBandNames())
+    {
+      const auto band = oneBin.GetVertErrorBand(bandName);
+      std::vector<TH1D*> univHists;
+      for(size_t whichUniv = 0; whichUniv < band->GetNHists(); ++whichUniv)
+      {
+        univHists.push_back(new TH1D((name + "_" + bandName + "_" + std::to_string(whichUniv)).c_str(), oneBin.GetTitle(), truthBins.size() - 1, truthBins.data()));
+        for(size_t whichBin = 0; whichBin <= truthBins.size(); ++whichBin) univHists.back()->SetBinContent(whichBin, band->GetHist(whichUniv)->GetBinContent(1));
+      }
+      flux->AddVertErrorBand(bandName, univHists);
+      for(auto univHist: univHists) delete univHist;
+    }
+
+    return flux;
+  }
+
+  std::vector<double> getBins(const YAML::Node& config, const std::string& prefix, const std::string& key, const std::vector<double>& defaultBins)
+  {
+    std::vector<double> bins = defaultBins;
+    if(config[key]) bins = config[key].as<std::vector<double>>();
+    if(config["tables"] && config["tables"][prefix] && config["tables"][prefix][key]) bins = config["tables"][prefix][key].as<std::vector<double>>();
+
+    if(bins.size() < 2) throw std::runtime_error("Table " + prefix + " needs at least 2 bin edges for its " + key + ".");
+    if(!std::is_sorted(bins.begin(), bins.end())) throw std::runtime_error("Bin edges for " + prefix + "'s " + key + " must be in increasing order.");
+    return bins;
+  }
+
+  void rebin(const Table& table, TFile& inFile, TFile& outFile, const YAML::Node& config, const size_t nThreads)
+  {
+    const auto recoBins = getBins(config, table.prefix, "binning", {});
+    const auto truthBins = getBins(config, table.prefix, "truthBinning", recoBins);
+    const UniverseLayout layout(table);
+
+    const auto hists = fillInParallel(table, layout, recoBins, truthBins, nThreads);
+    const std::string recoAxis = "Reco " + table.variable + " [" + table.unit + "]",
+                      truthAxis = "Truth " + table.variable + " [" + table.unit + "]",
+                      entries = "entries [" + table.weightUnit + "]";
+    const auto name = [&table](const std::string& hist) { return table.prefix + "_" + hist; };
+
+    std::vector<TH1*> toWrite;
+    for(size_t whichBackground = 0; whichBackground < hists.backgrounds.size(); ++whichBackground)
+    {
+      //Same names and titles as util::Categorized<>
+      const auto& category = table.categories[whichBackground + 1];
+      toWrite.push_back(makeHist(util::SafeROOTName(name("Background_" + category)), category + ";" + recoAxis + ";" + entries,
+                                 recoBins, hists.backgrounds[whichBackground], layout));
+    }
+
+    if(table.isSideband)
+    {
+      toWrite.push_back(makeHist(name("Data"), "Data;" + recoAxis + ";" + entries, recoBins, hists.data, layout));
+      toWrite.push_back(makeHist(name("TruthSignal"), "Truth Signal;" + recoAxis + ";" + entries, recoBins, hists.selected, layout));
+    }
+    else
+    {
+      toWrite.push_back(makeHist2D(name("Migration"), "Migration;" + recoAxis + ";" + truthAxis + ";" + entries, recoBins, truthBins, hists.migration, layout));
+      toWrite.push_back(makeHist(name("Signal"), "Signal;" + recoAxis + ";" + entries, recoBins, hists.data, layout));
+      toWrite.push_back(makeHist(name("EfficiencyNumerator"), "Efficiency Numerator;" + truthAxis + ";" + entries, truthBins, hists.effNum, layout));
+      toWrite.push_back(makeHist(name("EfficiencyDenominator"), "Efficiency Denominator;" + truthAxis + ";" + entries, truthBins, hists.effDenom, layout));
+      toWrite.push_back(makeHist(name("SelectedMCEvents"), "Selected Signal Events;" + recoAxis + ";" + entries, recoBins, hists.selected, layout));
+
+      const auto oneBinFlux = dynamic_cast<PlotUtils::MnvH1D*>(inFile.Get(name(ana::table::fluxName).c_str()));
+      if(oneBinFlux) toWrite.push_back(expandFlux(*oneBinFlux, name("reweightedflux_integrated"), truthBins));
+      else std::cerr << "No flux integral for " << table.prefix << " in " << inFile.GetName() << ".  This is normal for data files.\n";
+    }
+
+    outFile.cd();
+    for(auto hist: toWrite)
+    {
+      hist->Write();
+      delete hist;
+    }
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  #ifndef NCINTEX
+  ROOT::Cintex::Cintex::Enable(); //Needed to look up dictionaries for PlotUtils classes like MnvH1D
+  #endif
+
+  TH1::AddDirectory(kFALSE);
+
+  if(argc < 3)
+  {
+    std::cerr << "Expected at least 2 arguments, but got " << argc - 1 << "\n\n" << USAGE << "\n";
+    return badCommandLine;
+  }
+
+  YAML::Node config;
+  try
+  {
+    config = YAML::LoadFile(argv[1]);
+    if(!config["binning"] && !config["tables"]) throw std::runtime_error(std::string(argv[1]) + " doesn't have a binning or any tables.");
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "Failed to read a binning from " << argv[1] << ":\n" << e.what() << "\n\n" << USAGE << "\n";
+    return badBinning;
+  }
+
+  const size_t nThreads = config["nThreads"].as<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+
+  for(int whichFile = 2; whichFile < argc; ++whichFile)
+  {
+    const std::string inName = argv[whichFile];
+    std::unique_ptr<TFile> inFile(TFile::Open(inName.c_str(), "READ"));
+    if(!inFile)
+    {
+      std::cerr << "Failed to open " << inName << " for reading.\n";
+      return inputFileFailed;
+    }
+
+    const auto outName = inName.substr(0, inName.rfind(".root")) + "_rebinned.root";
+    std::unique_ptr<TFile> outFile(TFile::Open(outName.c_str(), "CREATE"));
+    if(!outFile)
+    {
+      std::cerr << "Failed to create " << outName << ".  Does it already exist?\n";
+      return badOutputFile;
+    }
+
+    try
+    {
+      for(auto key: *inFile->GetListOfKeys())
+      {
+        const std::string name = key->GetName();
+        auto obj = static_cast<TKey*>(key)->ReadObj();
+
+        if(obj->InheritsFrom(TTree::Class()))
+        {
+          if(name.size() > recoTreeSuffix.size() && name.compare(name.size() - recoTreeSuffix.size(), recoTreeSuffix.size(), recoTreeSuffix) == 0)
+          {
+            const auto table = readTable(*inFile, *static_cast<TTree*>(obj));
+            std::cout << "Rebinning " << table.prefix << " with " << table.recoRows.size() << " selected rows and " << table.truthRows.size() << " truth rows...\n";
+            rebin(table, *inFile, *outFile, config, nThreads);
+          }
+        }
+        else if(name.find(ana::table::fluxName) == std::string::npos)
+        {
+          outFile->cd();
+          obj->Write(name.c_str());
+        }
+
+        delete obj;
+      }
+    }
+    catch(const std::exception& e)
+    {
+      std::cerr << "Failed to rebin tables in " << inName << ":\n" << e.what() << "\n";
+      return badTable;
+    }
+  }
+
+  return success;
+}
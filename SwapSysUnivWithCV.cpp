@@ -6,6 +6,9 @@
 
 #define USAGE "SwapSysUnivWithCV <fileToWarp.root> [nameOfErrorBand = all]"
 
+//util includes
+#include "util/HistIndex.h"
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Woverloaded-virtual"
 //PlotUtils includes
@@ -17,6 +20,7 @@
 #include "TFile.h"
 #include "TDirectory.h"
 #include "TKey.h"
+#include "TClass.h"
 
 #include "TParameter.h"
 
@@ -27,39 +31,29 @@
 
 //c++ includes
 #include <iostream>
+#include <set>
 
-//Convince the STL to talk to TIter so I can use std::find_if()
-namespace std
-{
-  template <>
-  struct iterator_traits<TIter>
-  {
-    using value_type = TObject;
-    using pointer = TObject*;
-    using reference = TObject&;
-    using iterator_category = forward_iterator_tag;
-  };
-}
-
-//Think of this like the bash command line utility 'find dir -name "*"',
-//but for TObjects in ROOT files.  It also requires that every object
-//is of type OBJ.  If you're using this with multiple OBJs and performance
-//matters, you should rewrite it.
+//Every OBJ in dir and its subdirectories.  Checks each key's class before reading it, so
+//it only reads the objects it returns.  Scans keys instead of the HistIndex so that objects
+//the index doesn't know about, like TParameters and files without an index, are found too.
 template <class OBJ>
 std::vector<OBJ*> find(TDirectory& dir)
 {
   std::vector<OBJ*> found;
+  std::set<std::string> seen; //Only the latest cycle of each key
 
-  auto& keys = *dir.GetListOfKeys();
-  for(auto obj: keys)
+  TIter next(dir.GetListOfKeys());
+  while(auto key = static_cast<TKey*>(next()))
   {
-    auto key = static_cast<TKey*>(obj);
-    auto asObj = dynamic_cast<OBJ*>(key->ReadObj());
-    auto asDir = dynamic_cast<TDirectory*>(key->ReadObj());
-    if(asObj) found.push_back(asObj);
-    else if(asDir)
+    if(!seen.insert(key->GetName()).second) continue;
+
+    const auto keyClass = TClass::GetClass(key->GetClassName());
+    if(!keyClass) continue;
+
+    if(keyClass->InheritsFrom(OBJ::Class())) found.push_back(static_cast<OBJ*>(key->ReadObj()));
+    else if(keyClass->InheritsFrom(TDirectory::Class()))
     {
-      auto recurse = find<OBJ>(*asDir);
+      auto recurse = find<OBJ>(*static_cast<TDirectory*>(key->ReadObj()));
       found.insert(found.end(), recurse.begin(), recurse.end());
     }
   }
@@ -132,6 +126,7 @@ int main(const int argc, const char** argv)
     return 2;
   }
 
+  const util::HistIndex index(*inFile);
   const auto all1D = find<PlotUtils::MnvH1D>(*inFile);
   const auto all2D = find<PlotUtils::MnvH2D>(*inFile);
 
@@ -190,6 +185,7 @@ int main(const int argc, const char** argv)
 
       //Copy TParameters (POT information) and TStrings (bookkeeping) to the new file.
       for(auto par: allParameters) par->Write();
+      index.write(*outFile);
       //for(auto str: allStrings) str->Write(); //TODO: I need all TNamed that aren't also TH1s
 
       //Write the swapped histograms to a new file.
@@ -22,6 +22,7 @@
 #include "util/WithUnits.h"
 #include "util/units.h"
 #include "util/Directory.h"
+#include "util/FlatHistWrapper.h"
 
 //PlotUtils includes
 //TODO: Someone who maintains this code should deal with these warnings
@@ -45,7 +46,9 @@ namespace ana
       static_assert(std::is_same<UNIT, decltype(std::declval<VARIABLE>().truth(std::declval<evt::Universe>()))>::value,
                     "Reco and truth variable calculations must be in the same units!");
 
-      using HIST = units::WithUnits<HistWrapper<evt::Universe>, UNIT, events>;
+      //Most backgrounds only have a few GENIE categories, so only allocate
+      //universe histograms that get Fill()ed
+      using HIST = units::WithUnits<util::FlatHistWrapper<evt::Universe>, UNIT, events>;
 
     public:
       BackgroundsByGENIECategory(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass,
@@ -81,6 +84,7 @@ namespace ana
       {
         fSignalByGENIEInVar.visit([](auto& hist) { hist.SyncCVHistos(); });
         fBackgroundsByGENIEInVar.visit([](auto& category) { category.visit([](auto& hist) { hist.SyncCVHistos(); }); });
+        fSelectedByGENIEInVar.visit([](auto& hist) { util::materialize(hist); });
       }
 
       //Functions I don't plan to use
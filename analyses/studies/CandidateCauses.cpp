@@ -11,6 +11,9 @@
 //ROOT includes
 #include "TDatabasePDG.h"
 
+//c++ includes
+#include <algorithm>
+
 namespace
 {
   std::vector<util::NamedCategory<int>> pdgToName = {util::NamedCategory<int>{{2212}, "Proton"},
@@ -36,14 +39,38 @@ namespace ana
                                                                          fPDGCodeToCauseEnergy(::pdgToName, dir, "Cause Energy",
                                                                                                "Truth", 30, 0, 50, univs)
   {
-    fCauseNames = dir.make<PlotUtils::HistWrapper<evt::Universe>>("CauseNames", "Particle that Caused a Candidate", 1, 0, -1, univs);
-    fCauseNameVersusEDep = dir.make<PlotUtils::Hist2DWrapper<evt::Universe>>("CauseNamesVsEDep", "Cause Versus Energy Deposit;Reco EDep [MeV];Cause Name;events", 39, 0, 65, 1, 0, -1, univs);
-
     //TDatabasePDG isn't smart enough to handle nuclei easily,
     //and I forgot the name of the class that handles elements.
+    //One bin per cause name so that Fill()s don't have to look up bins by label.
+    //Names can have more than one PDG code.
+    std::vector<std::string> names;
     for(const auto& entry: ::pdgToName)
     {
-      for(const auto pdg: entry.values) fPDGToName[pdg] = entry.name;
+      auto found = std::find(names.begin(), names.end(), entry.name);
+      if(found == names.end()) found = names.insert(names.end(), entry.name);
+      for(const auto pdg: entry.values) fPDGToBin.add(pdg, std::distance(names.begin(), found) + 1);
+    }
+    fPDGToBin.compile();
+    names.push_back("Other");
+    fOtherBin = names.size();
+    const int nBins = names.size();
+
+    fCauseNames = dir.make<PlotUtils::HistWrapper<evt::Universe>>("CauseNames", "Particle that Caused a Candidate", nBins, 0, nBins, univs);
+    fCauseNameVersusEDep = dir.make<PlotUtils::Hist2DWrapper<evt::Universe>>("CauseNamesVsEDep", "Cause Versus Energy Deposit;Reco EDep [MeV];Cause Name;events", 39, 0, 65, nBins, 0, nBins, univs);
+
+    for(size_t whichName = 0; whichName < names.size(); ++whichName)
+    {
+      fCauseNames->hist->GetXaxis()->SetBinLabel(whichName + 1, names[whichName].c_str());
+      fCauseNameVersusEDep->hist->GetYaxis()->SetBinLabel(whichName + 1, names[whichName].c_str());
+
+      for(const auto& band: univs)
+      {
+        for(const auto univ: band.second)
+        {
+          fCauseNames->univHist(univ)->GetXaxis()->SetBinLabel(whichName + 1, names[whichName].c_str());
+          fCauseNameVersusEDep->univHist(univ)->GetYaxis()->SetBinLabel(whichName + 1, names[whichName].c_str());
+        }
+      }
     }
   }
 
@@ -68,9 +95,11 @@ namespace ana
         {
           const auto& cause = causes[whichCause];
 
-          const auto causeName = fPDGToName[cause.pdgCode];
-          fCauseNames->univHist(&event)->Fill(causeName.c_str(), weight.in<events>());
-          fCauseNameVersusEDep->univHist(&event)->Fill(cand.edep.in<MeV>(), causeName.c_str(), weight.in<events>());
+          //Bins are 1 unit wide starting at 0, so the center of bin n is n - 0.5
+          int causeBin = fPDGToBin(cause.pdgCode);
+          if(causeBin < 0) causeBin = fOtherBin;
+          fCauseNames->univHist(&event)->Fill(causeBin - 0.5, weight.in<events>());
+          fCauseNameVersusEDep->univHist(&event)->Fill(cand.edep.in<MeV>(), causeBin - 0.5, weight.in<events>());
           fPDGCodeToCauseEnergy[cause.pdgCode].Fill(&event, cause.energy, weight);
         }
       }
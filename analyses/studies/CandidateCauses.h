@@ -67,7 +67,10 @@ namespace ana
       //TODO: Plot leading Cause and fraction of its energy over all Causes' energies
       util::Categorized<units::WithUnits<PlotUtils::HistWrapper<evt::Universe>, MeV, events>, int> fPDGCodeToCauseEnergy;
 
-      std::map<int, std::string> fPDGToName;
+      //Bin in fCauseNames for each cause PDG code.  Causes that aren't in any
+      //category go in the last bin, "Other".
+      util::detail::CategoryIndex<int> fPDGToBin;
+      int fOtherBin;
   };
 }
 
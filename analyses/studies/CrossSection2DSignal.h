@@ -59,7 +59,7 @@ namespace ana
       static_assert(std::is_same<YUNIT, decltype(std::declval<YVAR>().truth(std::declval<evt::Universe>()))>::value,
                     "Reco and truth y variable calculations must be in the same units!");
 
-      using HIST = units::WithUnits<Hist2DWrapper<evt::Universe>, XUNIT, YUNIT, events>;
+      using HIST = units::WithUnits<util::UnivHist2D<evt::Universe>, XUNIT, YUNIT, events>;
       //using MIGRATION = units::WithUnits<Hist2DWrapper<evt::Universe>, XUNIT, XUNIT, YUNIT, YUNIT, events>;
 
     public:
@@ -122,6 +122,7 @@ namespace ana
         fEfficiencyDenom->SyncCVHistos();
         fBackgrounds.visit([](auto& hist) { hist.SyncCVHistos(); });
         fSelectedMCEvents->SyncCVHistos();
+        util::materialize(*fSignalEvents);
       }
 
       using Registrar = Study::Registrar<CrossSection2DSignal<XVAR, YVAR>>;
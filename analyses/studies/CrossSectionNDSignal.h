@@ -0,0 +1,242 @@
+//File: CrossSectionNDSignal.h
+//Brief: A Study template that produces the plots you need to extract a differential
+//       cross section in any number of dimensions.  Each VARIABLE gets its own axis,
+//       and util::Linearizer numbers the N dimensional bins so that every plot is
+//       a 1D histogram or a 2D migration matrix with the same names CrossSectionSignal
+//       uses.  So, ExtractCrossSection works on it without any changes.  Linear bin
+//       widths are N dimensional bin volumes.
+//
+//       Configure it with one entry per VARIABLE, in order, in "variable" and "binning":
+//       variable:
+//         - <first VARIABLE's configuration>
+//         - <second VARIABLE's configuration>
+//       binning:
+//         - [0, 1, 2]
+//         - [0, 0.5, 1, 2]
+//       "truthBinning" can optionally be configured the same way.
+//
+//       Each axis's binning is saved as an empty TH1D named Axis_<VARIABLE name>
+//       so that plotting scripts can unpack linear bins.  A different truthBinning
+//       is saved the same way as TruthAxis_<VARIABLE name>.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//base includes
+#include "analyses/base/Study.h"
+#include "analyses/base/Background.h"
+
+//cut includes
+#include "cuts/reco/Cut.h"
+
+//evt includes
+#include "evt/Universe.h"
+
+//util includes
+#include "util/FlatHistWrapper.h"
+#include "util/WithUnits.h"
+#include "util/Linearizer.h"
+#include "util/units.h"
+#include "util/Directory.h"
+#include "util/Categorized.h"
+#include "util/SafeROOTName.h"
+
+//ROOT includes
+#include "TH1D.h"
+
+//c++ includes
+#include <tuple>
+#include <array>
+#include <utility>
+
+#ifndef ANA_CROSSSECTIONNDSIGNAL_H
+#define ANA_CROSSSECTIONNDSIGNAL_H
+
+namespace ana
+{
+  //Each VARIABLE shall have:
+  //1) A std::string name() const method that will be used to name all of the plots produced
+  //2) A UNIT reco(const Universe& univ) const method
+  //3) A UNIT truth(const Universe& unix) const method
+  //4) The return type of reco() and truth() must match
+  template <class ...VARIABLES>
+  class CrossSectionNDSignal: public Study
+  {
+    //First, check that VARIABLES make sense
+    private:
+      template <class VARIABLE>
+      using RecoUnit = decltype(std::declval<VARIABLE>().reco(std::declval<evt::Universe>()));
+
+      template <class VARIABLE>
+      using TruthUnit = decltype(std::declval<VARIABLE>().truth(std::declval<evt::Universe>()));
+
+      template <bool ...CONDITIONS>
+      using allTrue = std::is_same<std::integer_sequence<bool, true, CONDITIONS...>, std::integer_sequence<bool, CONDITIONS..., true>>;
+
+      static_assert(allTrue<std::is_same<RecoUnit<VARIABLES>, TruthUnit<VARIABLES>>::value...>::value,
+                    "Reco and truth variable calculations must be in the same units for every VARIABLE!");
+
+      static constexpr size_t NDims = sizeof...(VARIABLES);
+      using values_t = std::array<double, NDims>;
+      using indices_t = std::index_sequence_for<VARIABLES...>;
+
+      //Bins are looked up once per event by fReco and fTruth, so these only need to Fill() bins
+      using HIST = util::FlatHistWrapper<evt::Universe>;
+      using MIGRATION = util::FlatHist2DWrapper<evt::Universe>;
+
+    public:
+      CrossSectionNDSignal(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass, const std::vector<background_t>& backgrounds,
+                           std::map<std::string, std::vector<evt::Universe*>>& universes): Study(config, dir, std::move(mustPass), backgrounds, universes),
+                                                                                             fVars(makeVars(config["variable"], indices_t{})),
+                                                                                             fReco(binning(config["binning"])),
+                                                                                             fTruth(binning(config["truthBinning"]?config["truthBinning"]:config["binning"])),
+                                                                                             fBackgrounds(backgrounds, dir, "Background", "Reco " + names(),
+                                                                                                          fReco.Edges(), universes)
+      {
+        const auto& recoBins = fReco.Edges();
+        const auto& truthBins = fTruth.Edges();
+
+        fMigration = dir.make<MIGRATION>("Migration", ("Migration;Reco " + names() + ";Truth " + names() + ";entries").c_str(),
+                                         recoBins, truthBins, universes);
+        fSignalEvents = dir.make<HIST>("Signal", ("Signal;Reco " + names() + ";entries").c_str(),
+                                       recoBins, universes);
+        fEfficiencyNum = dir.make<HIST>("EfficiencyNumerator", ("Efficiency Numerator;Truth " + names() + ";entries").c_str(),
+                                        truthBins, universes);
+        fEfficiencyDenom = dir.make<HIST>("EfficiencyDenominator", ("Efficiency Denominator;Truth " + names() + ";entries").c_str(),
+                                          truthBins, universes);
+        fSelectedMCEvents = dir.make<HIST>("SelectedMCEvents", ("Selected Signal Events;Reco " + names() + ";entries").c_str(),
+                                           recoBins, universes);
+
+        const auto recoAxes = binning(config["binning"]);
+        saveAxes(dir, "Axis_", recoAxes, indices_t{});
+        if(config["truthBinning"])
+        {
+          const auto truthAxes = binning(config["truthBinning"]);
+          if(truthAxes != recoAxes) saveAxes(dir, "TruthAxis_", truthAxes, indices_t{});
+        }
+
+        //Write out the flux integral.  I want to have each bin in my variable filled
+        //in with the total flux integral so I can just MnvH1D::Divide() by it.
+        auto cv = universes["cv"].front();
+        if(cv) //Only case I can think of where this fails is debugging a specific error band.
+        {
+          auto fluxIntegral = cv->GetFluxIntegral(*fEfficiencyNum);
+          dir.mv(fluxIntegral);
+        }
+      }
+
+      virtual ~CrossSectionNDSignal() = default;
+
+      virtual void mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        const int recoBin = fReco.FindBin(recoValues(*univs.front())),
+                  truthBin = fTruth.FindBin(truthValues(*univs.front()));
+
+        fEfficiencyNum->FillBin(univs, truthBin, model, evt);
+        fMigration->FillBin(univs, recoBin, truthBin, model, evt);
+        fSelectedMCEvents->FillBin(univs, recoBin, model, evt);
+      }
+
+      virtual void truth(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        fEfficiencyDenom->FillBin(univs, fTruth.FindBin(truthValues(*univs.front())), model, evt);
+      }
+
+      virtual void data(const evt::Universe& event, const events weight) override
+      {
+        fSignalEvents->FillBin(&event, fReco.FindBin(recoValues(event)), weight.in<events>());
+      }
+
+      virtual void mcBackground(const std::vector<evt::Universe*>& univs, const background_t& background, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        fBackgrounds[background].FillBin(univs, fReco.FindBin(recoValues(*univs.front())), model, evt);
+      }
+
+      virtual void afterAllFiles(const events /*passedSelection*/) override
+      {
+        fMigration->SyncCVHistos();
+        fEfficiencyNum->SyncCVHistos();
+        fEfficiencyDenom->SyncCVHistos();
+        fBackgrounds.visit([](auto& hist) { hist.SyncCVHistos(); });
+        fSelectedMCEvents->SyncCVHistos();
+        util::materialize(*fSignalEvents);
+      }
+
+      using Registrar = Study::Registrar<CrossSectionNDSignal<VARIABLES...>>;
+
+    private:
+      std::tuple<VARIABLES...> fVars; //VARIABLES in which a differential cross section will be extracted
+
+      util::Linearizer fReco;
+      util::Linearizer fTruth;
+
+      //Signal histograms needed to extract a cross section
+      MIGRATION* fMigration;
+      HIST* fSignalEvents;
+      HIST* fEfficiencyNum;
+      HIST* fEfficiencyDenom;
+
+      util::Categorized<HIST, background_t> fBackgrounds; //Background event distributions in the reco signal region
+
+      //Not needed for a cross section.  Add() to fBackgrounds to get total reco event selection breakdown.
+      HIST* fSelectedMCEvents;
+
+      template <size_t ...AXES>
+      static std::tuple<VARIABLES...> makeVars(const YAML::Node& config, std::index_sequence<AXES...>)
+      {
+        return std::tuple<VARIABLES...>(VARIABLES(config[AXES])...);
+      }
+
+      static std::vector<std::vector<double>> binning(const YAML::Node& config)
+      {
+        if(!config.IsSequence() || config.size() != NDims) throw std::runtime_error("CrossSectionNDSignal needs exactly one binning for each of its " + std::to_string(NDims) + " variables.");
+        return config.as<std::vector<std::vector<double>>>();
+      }
+
+      //Look up every VARIABLE once per event
+      values_t recoValues(const evt::Universe& event) const { return recoValues(event, indices_t{}); }
+      values_t truthValues(const evt::Universe& event) const { return truthValues(event, indices_t{}); }
+
+      template <size_t ...AXES>
+      values_t recoValues(const evt::Universe& event, std::index_sequence<AXES...>) const
+      {
+        return values_t{{std::get<AXES>(fVars).reco(event).template in<RecoUnit<VARIABLES>>()...}};
+      }
+
+      template <size_t ...AXES>
+      values_t truthValues(const evt::Universe& event, std::index_sequence<AXES...>) const
+      {
+        return values_t{{std::get<AXES>(fVars).truth(event).template in<TruthUnit<VARIABLES>>()...}};
+      }
+
+      //Names of all VARIABLES for axis titles like "Muon Pz x Muon PT"
+      std::string names() const
+      {
+        std::string result;
+        namesOf(result, indices_t{});
+        return result;
+      }
+
+      template <size_t ...AXES>
+      void namesOf(std::string& result, std::index_sequence<AXES...>) const
+      {
+        const std::array<std::string, NDims> each = {{std::get<AXES>(fVars).name()...}};
+        for(const auto& name: each) result += (result.empty()?"":" x ") + name;
+      }
+
+      template <size_t ...AXES>
+      void saveAxes(util::Directory& dir, const std::string& prefix, const std::vector<std::vector<double>>& edges, std::index_sequence<AXES...>) const
+      {
+        const std::array<std::string, NDims> axisNames = {{std::get<AXES>(fVars).name()...}};
+        const std::array<std::string, NDims> axisUnits = {{units::detail::unit<RecoUnit<VARIABLES>>::name()...}};
+        for(size_t whichAxis = 0; whichAxis < NDims; ++whichAxis)
+        {
+          dir.make<TH1D>(util::SafeROOTName(prefix + axisNames[whichAxis]), (";" + axisNames[whichAxis] + " [" + axisUnits[whichAxis] + "]").c_str(),
+                         static_cast<int>(edges[whichAxis].size() - 1), edges[whichAxis].data());
+        }
+      }
+  };
+}
+
+#endif //ANA_CROSSSECTIONNDSIGNAL_H
@@ -42,7 +42,7 @@ namespace ana
       static_assert(std::is_same<UNIT, decltype(std::declval<VARIABLE>().truth(std::declval<evt::Universe>()))>::value,
                     "Reco and truth variable calculations must be in the same units!");
 
-      using HIST = units::WithUnits<HistWrapper<evt::Universe>, UNIT, events>;
+      using HIST = units::WithUnits<util::UnivHist<evt::Universe>, UNIT, events>;
 
     public:
       CrossSectionSideband(const YAML::Node& config, util::Directory& dir,
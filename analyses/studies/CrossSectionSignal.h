@@ -49,8 +49,8 @@ namespace ana
       static_assert(std::is_same<UNIT, decltype(std::declval<VARIABLE>().truth(std::declval<evt::Universe>()))>::value,
                     "Reco and truth variable calculations must be in the same units!");
 
-      using HIST = units::WithUnits<HistWrapper<evt::Universe>, UNIT, events>;
-      using MIGRATION = units::WithUnits<Hist2DWrapper<evt::Universe>, UNIT, UNIT, events>;
+      using HIST = units::WithUnits<util::UnivHist<evt::Universe>, UNIT, events>;
+      using MIGRATION = units::WithUnits<util::UnivHist2D<evt::Universe>, UNIT, UNIT, events>;
 
     public:
       CrossSectionSignal(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass, const std::vector<background_t>& backgrounds,
@@ -120,6 +120,7 @@ namespace ana
         fEfficiencyDenom->SyncCVHistos();
         fBackgrounds.visit([](auto& hist) { hist.SyncCVHistos(); });
         fSelectedMCEvents->SyncCVHistos();
+        util::materialize(*fSignalEvents);
       }
 
       using Registrar = Study::Registrar<CrossSectionSignal<VARIABLE>>;
@@ -7,6 +7,7 @@
 #include "analyses/studies/CrossSectionSideband.h"*/
 #include "analyses/studies/Resolution.h"
 #include "analyses/studies/NeutronMultiplicity.cpp"
+#include "analyses/studies/SelectionTable.h"
 
 //c++ includes
 #include <string>
@@ -72,6 +73,7 @@ namespace
 {
   static ana::CrossSectionSignal<ana::EAvailable>::Registrar EAvailableSignal_reg("EAvailableSignal");
   static ana::CrossSectionSideband<ana::EAvailable>::Registrar EAvailableSideband_reg("EAvailableSideband");
+  static ana::SelectionTable<ana::EAvailable>::Registrar EAvailableSelectionTable_reg("EAvailableSelectionTable");
   static ana::Resolution<ana::EAvailable>::Registrar EAvailableResolution_reg("EAvailableResolution");
 }
 
@@ -6,10 +6,12 @@
 #include "analyses/studies/CrossSectionSignal.h"
 #include "analyses/studies/CrossSectionSideband.h"
 #include "analyses/studies/CrossSection2DSignal.h"
+#include "analyses/studies/CrossSectionNDSignal.h"
 #include "analyses/studies/SidebandGENIEBreakdown.h"
 #include "analyses/studies/BackgroundsByPionContent.h"
 #include "analyses/studies/BackgroundsByGENIECategory.h"
 #include "analyses/studies/Resolution.h"
+#include "analyses/studies/SelectionTable.h"
 
 //c++ includes
 #include <string>
@@ -86,18 +88,22 @@ namespace
 {
   static ana::CrossSectionSignal<ana::MuonMomentum>::Registrar MuonMomentumSignal_reg("MuonMomentumSignal");
   static ana::CrossSectionSideband<ana::MuonMomentum>::Registrar MuonMomentumSideband_reg("MuonMomentumSideband");
+  static ana::SelectionTable<ana::MuonMomentum>::Registrar MuonMomentumSelectionTable_reg("MuonMomentumSelectionTable");
 
   static ana::CrossSectionSignal<ana::MuonPT>::Registrar MuonPTSignal_reg("MuonPTSignal");
   static ana::CrossSectionSideband<ana::MuonPT>::Registrar MuonPTSideband_reg("MuonPTSideband");
+  static ana::SelectionTable<ana::MuonPT>::Registrar MuonPTSelectionTable_reg("MuonPTSelectionTable");
   static ana::SidebandGENIEBreakdown<ana::MuonPT>::Registrar MuonPTSidebandGENIEBreakdown_reg("MuonPTSidebandGENIEBreakdown");
   static ana::BackgroundsByPionContent<ana::MuonPT>::Registrar MuonPTPionBreadkdown_reg("MuonPTPionBreakdown");
   static ana::BackgroundsByGENIECategory<ana::MuonPT>::Registrar MuonPTGENIEBreakdown_reg("MuonPTGENIEBreakdown");
 
   static ana::CrossSectionSignal<ana::MuonPz>::Registrar MuonPzSignal_reg("MuonPzSignal");
   static ana::CrossSectionSideband<ana::MuonPz>::Registrar MuonPzSideband_reg("MuonPzSideband");
+  static ana::SelectionTable<ana::MuonPz>::Registrar MuonPzSelectionTable_reg("MuonPzSelectionTable");
   static ana::SidebandGENIEBreakdown<ana::MuonPz>::Registrar MuonPzSidebandGENIEBreakdown_reg("MuonPzSidebandGENIEBreakdown");
 
   static ana::CrossSection2DSignal<ana::MuonPz, ana::MuonPT>::Registrar MuonPzPTSignal_reg("MuonPzPTSignal");
+  static ana::CrossSectionNDSignal<ana::MuonPz, ana::MuonPT>::Registrar MuonPzPTLinearizedSignal_reg("MuonPzPTLinearizedSignal");
   //TODO: CrossSection2DSideband<>
 
   static ana::Resolution<ana::MuonPT>::Registrar MuonPTResolution_reg("MuonPTResolution");
@@ -6,6 +6,7 @@
 
 //c++ includes
 #include <cmath>
+#include <iostream>
 
 //signal includes
 #include "analyses/studies/NeutronDetection.h"
@@ -65,10 +66,10 @@ namespace ana
                                        config["binning"]["zDist"].as<std::vector<double>>(),
                                        config["binning"]["beta"].as<std::vector<double>>());
 
-    fCandsPerFSNeutron = dir.make<units::WithUnits<PlotUtils::HistWrapper<evt::Universe>, neutrons, events>>("CandsPerFSNeutron", "Candidates per FS Neutron;N Candidates;Events", 4, 0, 4, univs);
+    fCandsPerFSNeutron = dir.make<units::WithUnits<util::FlatHistWrapper<evt::Universe>, neutrons, events>>("CandsPerFSNeutron", "Candidates per FS Neutron;N Candidates;Events", 4, 0, 4, univs);
 
-    fNMCEntries = dir.make<PlotUtils::HistWrapper<evt::Universe>>("NMCEntries", "Number of Signal Selected Entries", 1, 0, 1, univs);
-    fNDataEntries = dir.make<PlotUtils::HistWrapper<evt::Universe>>("NDataEntries", "Number of Selected Entries", 1, 0, 1, univs);
+    fNMCEntries = dir.make<util::FlatHistWrapper<evt::Universe>>("NMCEntries", "Number of Signal Selected Entries", 1, 0, 1, univs);
+    fNDataEntries = dir.make<util::FlatHistWrapper<evt::Universe>>("NDataEntries", "Number of Selected Entries", 1, 0, 1, univs);
   }
 
   void NeutronDetection::data(const evt::Universe& event, const events weight)
@@ -157,6 +158,25 @@ namespace ana
 
     fNMCEntries->SyncCVHistos();
     fNDataEntries->SyncCVHistos();
+
+    util::materialize(*fCandsPerFSNeutron);
+    fThreeDCandCosineResiduals.visit([](auto& hist) { util::materialize(hist); });
+    fTwoDCandCosineResiduals.visit([](auto& hist) { util::materialize(hist); });
+    fAllCandCosineResiduals.visit([](auto& hist) { util::materialize(hist); });
+
+    util::MemoryReport report;
+    fPDGToObservables.visit([&report](auto& obs) { obs.AddTo(report); });
+    fDataCands->AddTo(report);
+    fEffNumerator->AddTo(report);
+    fEffDenominator->AddTo(report);
+    report.add(*fCandsPerFSNeutron);
+    fThreeDCandCosineResiduals.visit([&report](auto& hist) { report.add(hist); });
+    fTwoDCandCosineResiduals.visit([&report](auto& hist) { report.add(hist); });
+    fAllCandCosineResiduals.visit([&report](auto& hist) { report.add(hist); });
+    report.add(*fNMCEntries);
+    report.add(*fNDataEntries);
+
+    report.print(std::cerr, "NeutronDetection"); //Not std::cout, where the cut tables go
   }
 
   NeutronDetection::Observables::Observables(const std::string& name, const std::string& title, std::map<std::string, std::vector<evt::Universe*>>& univs,
@@ -197,6 +217,14 @@ namespace ana
     fZDistFromVertex.SyncCVHistos();
   }
 
+  void NeutronDetection::Observables::AddTo(util::MemoryReport& report) const
+  {
+    report.add(fEDeps);
+    report.add(fAngles);
+    report.add(fBeta);
+    report.add(fZDistFromVertex);
+  }
+
   void NeutronDetection::Observables::Scale(const double value, const char* option)
   {
     fEDeps.hist->Scale(value, option);
@@ -237,6 +265,13 @@ namespace ana
     fAngles.SyncCVHistos();
     fBeta.SyncCVHistos();
   }
+
+  void NeutronDetection::Efficiency::AddTo(util::MemoryReport& report) const
+  {
+    report.add(fEnergies);
+    report.add(fAngles);
+    report.add(fBeta);
+  }
 }
 
 //Register with Factory
@@ -15,6 +15,7 @@
 #include "util/Categorized.h"
 #include "util/units.h"
 #include "util/mathWithUnits.h"
+#include "util/FlatHistWrapper.h"
 
 #ifndef SIG_NEUTRONDETECTION_H
 #define SIG_NEUTRONDETECTION_H
@@ -31,7 +32,9 @@ namespace ana
       //Do this study only for MC signal events.
       virtual void mcSignal(const evt::Universe& event, const events weight) override;
 
-      //Normalize fPDGToObservables and syncCVHistos()
+      //Normalize fPDGToObservables and syncCVHistos().  Histograms that never get
+      //synced still need their universes written out.  Also prints how much memory
+      //flat histograms saved.
       virtual void afterAllFiles(const events passedSelection) override;
 
       //Do nothing for backgrounds, the Truth tree, and data
@@ -77,6 +80,12 @@ namespace ana
       };
 
       //Histograms I'm going to Fill()
+      //Most PDG categories never see a candidate in a given sample, so universe
+      //histograms are only allocated when they're first Fill()ed.  Candidate
+      //observables have fine binning that each universe only fills a little of,
+      //so they only store bins that were Fill()ed.
+      using SparseHist = util::FlatHistWrapper<evt::Universe, util::Sparse<>>;
+
       //First, group them together by variables I'm going to histogram
       //TODO: Maybe move CandidateObservables into its own header.  That's what I eventually did last time.
       struct Observables
@@ -103,11 +112,12 @@ namespace ana
         void SetDirectory(TDirectory* dir);
         void SyncCVHistos();
         void Scale(const double value, const char* option = "");
+        void AddTo(util::MemoryReport& report) const;
 
-        units::WithUnits<HistWrapper<evt::Universe>, MeV, neutrons> fEDeps;
-        HistWrapper<evt::Universe> fAngles;
-        HistWrapper<evt::Universe> fBeta;
-        units::WithUnits<HistWrapper<evt::Universe>, mm, neutrons> fZDistFromVertex;
+        units::WithUnits<SparseHist, MeV, neutrons> fEDeps;
+        SparseHist fAngles;
+        SparseHist fBeta;
+        units::WithUnits<SparseHist, mm, neutrons> fZDistFromVertex;
       };
 
       struct Efficiency
@@ -120,10 +130,11 @@ namespace ana
         void SetDirectory(TDirectory* dir);
         void SyncCVHistos();
         void Scale(const double value, const char* option = "");
+        void AddTo(util::MemoryReport& report) const;
 
-        units::WithUnits<HistWrapper<evt::Universe>, MeV, neutrons> fEnergies;
-        HistWrapper<evt::Universe> fAngles;
-        HistWrapper<evt::Universe> fBeta;
+        units::WithUnits<SparseHist, MeV, neutrons> fEnergies;
+        SparseHist fAngles;
+        SparseHist fBeta;
       };
 
       util::Categorized<Observables, int> fPDGToObservables; //Map FS PDG code to Candidate observables
@@ -133,18 +144,18 @@ namespace ana
 
       Observables* fDataCands; //Neutron candidate observables in data
 
-      units::WithUnits<PlotUtils::HistWrapper<evt::Universe>, neutrons, events>* fCandsPerFSNeutron;
+      units::WithUnits<util::FlatHistWrapper<evt::Universe>, neutrons, events>* fCandsPerFSNeutron;
 
       //Residuals (reco - true) on theta w.r.t. the z axis
-      using HIST = units::WithUnits<PlotUtils::HistWrapper<evt::Universe>, degrees, neutrons>;
+      using HIST = units::WithUnits<util::FlatHistWrapper<evt::Universe>, degrees, neutrons>;
       util::Categorized<HIST, int> fThreeDCandCosineResiduals;
       util::Categorized<HIST, int> fTwoDCandCosineResiduals;
       util::Categorized<HIST, int> fAllCandCosineResiduals;
 
-      PlotUtils::HistWrapper<evt::Universe>* fNMCEntries; //Number of entries that make it into mcSignal for each universe
+      util::FlatHistWrapper<evt::Universe>* fNMCEntries; //Number of entries that make it into mcSignal for each universe
                                                          //This lets me cancel uncertainties when I divide by number of
                                                          //entries as well as merge playlists!
-      PlotUtils::HistWrapper<evt::Universe>* fNDataEntries;
+      util::FlatHistWrapper<evt::Universe>* fNDataEntries;
   };
 }
 
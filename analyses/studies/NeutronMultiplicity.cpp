@@ -5,6 +5,7 @@
 //analyses includes
 #include "analyses/studies/CrossSectionSignal.h"
 #include "analyses/studies/CrossSectionSideband.h"
+#include "analyses/studies/SelectionTable.h"
 #include "analyses/studies/BackgroundsByPionContent.h"
 #include "analyses/studies/CandidateMath.h"
 
@@ -52,18 +53,58 @@ namespace ana
       units::LorentzVector<MeV> momentum;
     };
 
+    //Everything countAsReco() cuts on for one candidate.  Calculate it once
+    //to check the same candidate against many NeutronMultiplicity configurations.
+    struct RecoObservables
+    {
+      MeV edep;
+      mm zDist;
+      mm dist;
+      double absZCosine;
+    };
+
+    template <class CAND>
+    static RecoObservables observeReco(const CAND& cand, const units::LorentzVector<mm>& vertex)
+    {
+      return RecoObservables{cand.edep, cand.z - vertex.z(), DistFromVertex(vertex, cand), fabs(CosineWrtZAxis(vertex, cand))};
+    }
+
+    //Everything countAsTruth() cuts on for one FS particle
+    struct TruthObservables
+    {
+      bool isNeutron;
+      MeV KE;
+      double absZCosine;
+    };
+
+    template <class FS>
+    static TruthObservables observeTruth(const FS& fs)
+    {
+      return TruthObservables{fs.PDGCode == 2112, fs.energy - 939.6_MeV, fabs(cos(fs.momentum.p().theta()))};
+    }
+
     //Decide whether a neutron candidate/FS particle should be counted.
     //Splitting code up this way lets me reuse this in studies.
+    bool countAsReco(const RecoObservables& cand) const
+    {
+      return (cand.zDist < this->fRecoMaxZDist) && (cand.edep > this->fRecoMinEDep) && (cand.dist < fRecoDistBoxMax || cand.edep > fRecoEDepBoxMin) && (cand.absZCosine > fMinZCosine) && (cand.dist > fVertexBoxDist);
+    }
+
     template <class CAND>
     bool countAsReco(const CAND& cand, const units::LorentzVector<mm>& vertex) const
     {
-      return (cand.z - vertex.z() < this->fRecoMaxZDist) && (cand.edep > this->fRecoMinEDep) && (DistFromVertex(vertex, cand) < fRecoDistBoxMax || cand.edep > fRecoEDepBoxMin) && (fabs(CosineWrtZAxis(vertex, cand)) > fMinZCosine) && (DistFromVertex(vertex, cand) > fVertexBoxDist);
+      return countAsReco(observeReco(cand, vertex));
+    }
+
+    bool countAsTruth(const TruthObservables& fs) const
+    {
+      return fs.isNeutron && (fs.KE > this->fTruthMinKE) && (fs.absZCosine > fMinZCosine);
     }
 
     template <class FS>
     bool countAsTruth(const FS& fs) const
     {
-      return (fs.PDGCode == 2112) && ((fs.energy - 939.6_MeV) > this->fTruthMinKE) && (fabs(cos(fs.momentum.p().theta())) > fMinZCosine);
+      return countAsTruth(observeTruth(fs));
     }
 
     neutrons truth(const evt::Universe& event) const
@@ -105,6 +146,7 @@ namespace
 {
   static ana::CrossSectionSignal<ana::NeutronMultiplicity>::Registrar NeutronMultiplicitySignal_reg("NeutronMultiplicitySignal");
   static ana::CrossSectionSideband<ana::NeutronMultiplicity>::Registrar NeutronMultiplicitySideband_reg("NeutronMultiplicitySideband");
+  static ana::SelectionTable<ana::NeutronMultiplicity>::Registrar NeutronMultiplicitySelectionTable_reg("NeutronMultiplicitySelectionTable");
   static ana::BackgroundsByPionContent<ana::NeutronMultiplicity>::Registrar NeutronMultiplicityPionContent_reg("NeutronMultiplicityByPionContent");
 }
 
@@ -0,0 +1,247 @@
+//File: NeutronThresholdScan.cpp
+//Brief: Tune the neutron candidate selection by checking a grid of NeutronMultiplicity
+//       thresholds in one pass.  Candidate observables are calculated once per entry.
+//       Only the cuts and Fill()s are repeated for each grid point.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//signal includes
+#include "analyses/studies/NeutronThresholdScan.h"
+
+//util includes
+#include "util/Factory.cpp"
+
+//c++ includes
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+namespace
+{
+  //One list of values for a setting in the "variable" block
+  struct Axis
+  {
+    std::vector<std::string> path; //Keys to get to this setting from the top of "variable"
+    std::vector<YAML::Node> values;
+  };
+
+  //Every list in grid is an Axis
+  void findAxes(const YAML::Node& grid, std::vector<std::string>& path, std::vector<Axis>& axes)
+  {
+    for(const auto& setting: grid)
+    {
+      path.push_back(setting.first.as<std::string>());
+      if(setting.second.IsMap()) findAxes(setting.second, path, axes);
+      else if(setting.second.IsSequence() && setting.second.size() > 0)
+      {
+        axes.push_back(Axis{path, {}});
+        for(const auto& value: setting.second) axes.back().values.push_back(value);
+      }
+      else throw std::runtime_error("NeutronThresholdScan's grid needs a non-empty list of values for " + path.back());
+      path.pop_back();
+    }
+  }
+
+  void set(YAML::Node node, const std::vector<std::string>& path, const YAML::Node& value)
+  {
+    for(auto key = path.begin(); key != std::prev(path.end()); ++key) node.reset(node[*key]);
+    node[path.back()] = value;
+  }
+}
+
+namespace ana
+{
+  NeutronThresholdScan::NeutronThresholdScan(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass, std::vector<background_t>& backgrounds,
+                                             std::map<std::string, std::vector<evt::Universe*>>& univs): Study(config, dir, std::move(mustPass), backgrounds, univs)
+  {
+    std::vector<Axis> axes;
+    std::vector<std::string> path;
+    findAxes(config["grid"], path, axes);
+
+    //Every combination of values on every Axis.  The first Axis changes fastest.
+    std::vector<std::string> labels;
+    std::vector<size_t> whichValue(axes.size(), 0);
+    do
+    {
+      YAML::Node point = YAML::Clone(config["variable"]);
+      std::string label;
+      for(size_t whichAxis = 0; whichAxis < axes.size(); ++whichAxis)
+      {
+        const auto& value = axes[whichAxis].values[whichValue[whichAxis]];
+        set(point, axes[whichAxis].path, value);
+        label += (label.empty()?"":", ") + axes[whichAxis].path.back() + "=" + value.as<std::string>();
+      }
+      fGrid.emplace_back(point);
+      labels.push_back(label.empty()?"nominal":label);
+
+      auto axis = whichValue.begin();
+      for(; axis != whichValue.end() && ++(*axis) == axes[axis - whichValue.begin()].values.size(); ++axis) *axis = 0;
+      if(axis == whichValue.end()) break;
+    } while(true);
+
+    const int nPoints = fGrid.size();
+    const int maxMultiplicity = config["binning"]["multiplicity"].as<int>(6);
+
+    fSignalMultiplicity = dir.make<HIST2D>("SignalMultiplicity", "Signal;Grid Point;Reco Neutron Multiplicity", nPoints, 0, nPoints, maxMultiplicity, 0, maxMultiplicity, univs);
+    fBackgroundMultiplicity = dir.make<HIST2D>("BackgroundMultiplicity", "Backgrounds;Grid Point;Reco Neutron Multiplicity", nPoints, 0, nPoints, maxMultiplicity, 0, maxMultiplicity, univs);
+    fDataMultiplicity = dir.make<HIST2D>("DataMultiplicity", "Data;Grid Point;Reco Neutron Multiplicity", nPoints, 0, nPoints, maxMultiplicity, 0, maxMultiplicity, univs);
+
+    fFSNeutrons = dir.make<HIST>("FSNeutrons", "Truth FS Neutrons;Grid Point;neutrons", nPoints, 0, nPoints, univs);
+    fFoundFSNeutrons = dir.make<HIST>("FoundFSNeutrons", "FS Neutrons with Candidates;Grid Point;neutrons", nPoints, 0, nPoints, univs);
+    fSelectedCands = dir.make<HIST>("SelectedCandidates", "Candidates;Grid Point;candidates", nPoints, 0, nPoints, univs);
+    fNeutronCands = dir.make<HIST>("NeutronCandidates", "Neutron-Induced Candidates;Grid Point;candidates", nPoints, 0, nPoints, univs);
+
+    for(int whichPoint = 0; whichPoint < nPoints; ++whichPoint)
+    {
+      for(auto hist: {fSignalMultiplicity->hist, fBackgroundMultiplicity->hist, fDataMultiplicity->hist}) hist->GetXaxis()->SetBinLabel(whichPoint + 1, labels[whichPoint].c_str());
+      for(auto hist: {fFSNeutrons->hist, fFoundFSNeutrons->hist, fSelectedCands->hist, fNeutronCands->hist}) hist->GetXaxis()->SetBinLabel(whichPoint + 1, labels[whichPoint].c_str());
+    }
+
+    fNMCEntries = dir.make<HIST>("NMCEntries", "Number of Signal Selected Entries", 1, 0, 1, univs);
+    fNDataEntries = dir.make<HIST>("NDataEntries", "Number of Selected Entries", 1, 0, 1, univs);
+  }
+
+  int NeutronThresholdScan::countReco(const NeutronMultiplicity& cuts) const
+  {
+    return std::count_if(fCands.begin(), fCands.end(), [&cuts](const auto& cand) { return cuts.countAsReco(cand); });
+  }
+
+  void NeutronThresholdScan::countSignal(const evt::Universe& event)
+  {
+    //Physics objects I'll need
+    const auto cands = event.Get<MCCandidate>(event.Getblob_edep(), event.Getblob_zPos(), event.Getblob_transverse_dist_from_vertex(), event.Getblob_FS_index(), event.Getblob_geant_dist_to_edep_as_neutron());
+    const auto fs = event.Get<NeutronMultiplicity::FSPart>(event.GetTruthMatchedPDG_code(), event.GetTruthMatchedenergy(), event.GetFSMomenta());
+    const auto vertex = event.GetVtx();
+
+    //Calculate observables once for every grid point
+    fCands.clear();
+    for(const auto& cand: cands) fCands.push_back(NeutronMultiplicity::observeReco(cand, vertex));
+
+    fFS.clear();
+    for(const auto& part: fs) fFS.push_back(NeutronMultiplicity::observeTruth(part));
+
+    //Count how many neutrons or candidates each grid point finds
+    fSignalCounts.clear();
+    for(const auto& cuts: fGrid)
+    {
+      fFSFound.assign(fFS.size(), false);
+      SignalCounts counts{0, 0, 0, 0};
+
+      for(size_t whichCand = 0; whichCand < cands.size(); ++whichCand)
+      {
+        if(!cuts.countAsReco(fCands[whichCand])) continue;
+
+        ++counts.nSelected;
+        const auto& cand = cands[whichCand];
+        if(cand.FS_index >= 0)
+        {
+          //Check for "GEANT neutron"s: FS particles that weren't neutrons but produced neutrons that I detected.
+          if(fs[cand.FS_index].PDGCode == 2112 || cand.dist_to_edep_as_neutron > 0_mm) ++counts.nFromNeutrons;
+          fFSFound[cand.FS_index] = true;
+        }
+      }
+
+      for(size_t whichFS = 0; whichFS < fFS.size(); ++whichFS)
+      {
+        if(cuts.countAsTruth(fFS[whichFS]))
+        {
+          ++counts.nFS;
+          if(fFSFound[whichFS]) ++counts.nFound;
+        }
+      }
+
+      fSignalCounts.push_back(counts);
+    }
+  }
+
+  void NeutronThresholdScan::countReco(const evt::Universe& event)
+  {
+    const auto cands = event.Get<NeutronMultiplicity::Candidate>(event.Getblob_edep(), event.Getblob_zPos(), event.Getblob_transverse_dist_from_vertex());
+    const auto vertex = event.GetVtx();
+
+    fCands.clear();
+    for(const auto& cand: cands) fCands.push_back(NeutronMultiplicity::observeReco(cand, vertex));
+
+    fRecoCounts.clear();
+    for(const auto& cuts: fGrid) fRecoCounts.push_back(countReco(cuts));
+  }
+
+  //Fill each grid point once per entry weighted by how many neutrons or candidates it counted
+  void NeutronThresholdScan::fillSignal(const evt::Universe& univ, const double weight)
+  {
+    fNMCEntries->FillUniverse(univ, 0.5, weight);
+
+    for(size_t whichPoint = 0; whichPoint < fSignalCounts.size(); ++whichPoint)
+    {
+      const auto& counts = fSignalCounts[whichPoint];
+      const double x = whichPoint + 0.5;
+
+      fSignalMultiplicity->FillUniverse(univ, x, counts.nSelected, weight);
+      if(counts.nFS > 0) fFSNeutrons->FillUniverse(univ, x, counts.nFS * weight);
+      if(counts.nFound > 0) fFoundFSNeutrons->FillUniverse(univ, x, counts.nFound * weight);
+      if(counts.nSelected > 0) fSelectedCands->FillUniverse(univ, x, counts.nSelected * weight);
+      if(counts.nFromNeutrons > 0) fNeutronCands->FillUniverse(univ, x, counts.nFromNeutrons * weight);
+    }
+  }
+
+  void NeutronThresholdScan::mcSignal(const evt::Universe& event, const events weight)
+  {
+    countSignal(event);
+    fillSignal(event, weight.in<events>());
+  }
+
+  void NeutronThresholdScan::mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt)
+  {
+    assert(!univs.empty());
+    countSignal(*univs.front());
+
+    util::getWeights(model, univs, evt, fWeights);
+    for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) fillSignal(*univs[whichUniv], fWeights[whichUniv]);
+  }
+
+  void NeutronThresholdScan::mcBackground(const evt::Universe& event, const background_t& /*background*/, const events weight)
+  {
+    countReco(event);
+    for(size_t whichPoint = 0; whichPoint < fRecoCounts.size(); ++whichPoint) fBackgroundMultiplicity->FillUniverse(event, whichPoint + 0.5, fRecoCounts[whichPoint], weight.in<events>());
+  }
+
+  void NeutronThresholdScan::mcBackground(const std::vector<evt::Universe*>& univs, const background_t& /*background*/, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt)
+  {
+    assert(!univs.empty());
+    countReco(*univs.front());
+
+    util::getWeights(model, univs, evt, fWeights);
+    for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv)
+    {
+      for(size_t whichPoint = 0; whichPoint < fRecoCounts.size(); ++whichPoint) fBackgroundMultiplicity->FillUniverse(*univs[whichUniv], whichPoint + 0.5, fRecoCounts[whichPoint], fWeights[whichUniv]);
+    }
+  }
+
+  void NeutronThresholdScan::data(const evt::Universe& event, const events weight)
+  {
+    fNDataEntries->FillUniverse(event, 0.5, weight.in<events>());
+
+    countReco(event);
+    for(size_t whichPoint = 0; whichPoint < fRecoCounts.size(); ++whichPoint) fDataMultiplicity->FillUniverse(event, whichPoint + 0.5, fRecoCounts[whichPoint], weight.in<events>());
+  }
+
+  void NeutronThresholdScan::afterAllFiles(const events /*passedSelection*/)
+  {
+    fSignalMultiplicity->SyncCVHistos();
+    fBackgroundMultiplicity->SyncCVHistos();
+    fDataMultiplicity->SyncCVHistos();
+
+    fFSNeutrons->SyncCVHistos();
+    fFoundFSNeutrons->SyncCVHistos();
+    fSelectedCands->SyncCVHistos();
+    fNeutronCands->SyncCVHistos();
+
+    fNMCEntries->SyncCVHistos();
+    fNDataEntries->SyncCVHistos();
+  }
+}
+
+//Register with Factory
+namespace
+{
+  static ana::Study::Registrar<ana::NeutronThresholdScan> NeutronThresholdScan_reg("NeutronThresholdScan");
+}
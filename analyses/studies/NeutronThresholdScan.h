@@ -0,0 +1,114 @@
+//File: NeutronThresholdScan.h
+//Brief: Tune the neutron candidate selection by checking a grid of NeutronMultiplicity
+//       thresholds in one pass.  Each candidate's observables are calculated once per
+//       entry, and then every grid point's histograms are Fill()ed from them.
+//       Each histogram has one x bin per grid point, labelled with that point's thresholds.
+//
+//       Configure it with the same "variable" block as NeutronMultiplicity plus a "grid"
+//       block of the same shape whose values are lists.  Every combination of those lists
+//       is a grid point, and settings not in "grid" are taken from "variable".
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//signal includes
+#include "analyses/base/Study.h"
+
+//variables includes
+#include "analyses/studies/NeutronMultiplicity.cpp"
+
+//util includes
+#include "util/FlatHistWrapper.h"
+#include "util/BatchModel.h"
+
+#ifndef ANA_NEUTRONTHRESHOLDSCAN_H
+#define ANA_NEUTRONTHRESHOLDSCAN_H
+
+namespace ana
+{
+  class NeutronThresholdScan: public Study
+  {
+    public:
+      NeutronThresholdScan(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass,
+                           std::vector<background_t>& backgrounds, std::map<std::string, std::vector<evt::Universe*>>& universes);
+      virtual ~NeutronThresholdScan() = default;
+
+      //Multiplicity, efficiency, and purity at every grid point
+      virtual void mcSignal(const evt::Universe& event, const events weight) override;
+
+      //Calculates observables and cuts once for all of univs.  Only the Fill()s loop over univs.
+      virtual void mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override;
+
+      //Multiplicity at every grid point
+      virtual void mcBackground(const evt::Universe& event, const background_t& background, const events weight) override;
+      virtual void mcBackground(const std::vector<evt::Universe*>& univs, const background_t& background, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override;
+      virtual void data(const evt::Universe& event, const events weight) override;
+
+      //syncCVHistos()
+      virtual void afterAllFiles(const events passedSelection) override;
+
+      //Nothing to do for the Truth tree
+      virtual void truth(const evt::Universe& /*event*/, const events /*weight*/) override {};
+      virtual bool wantsTruthLoop() const override { return false; }
+
+    private:
+      struct MCCandidate
+      {
+        MeV edep;
+        mm z;
+        mm transverse;
+        int FS_index; //Mapping from a Candidate to an FSPart by index in the array of FSParts
+        mm dist_to_edep_as_neutron; //Distance parent and ancestors travelled that were neutrons
+      };
+
+      //What one signal entry contributes to each grid point
+      struct SignalCounts
+      {
+        int nSelected;
+        int nFromNeutrons;
+        int nFS;
+        int nFound;
+      };
+
+      //One NeutronMultiplicity per grid point
+      std::vector<NeutronMultiplicity> fGrid;
+
+      //Observables for the current entry.  Kept as members so their memory is reused.
+      std::vector<NeutronMultiplicity::RecoObservables> fCands;
+      std::vector<NeutronMultiplicity::TruthObservables> fFS;
+      std::vector<char> fFSFound; //Whether each FS particle has a candidate at the current grid point
+
+      //Counts for the current entry at each grid point.  The same for every universe in a compatible group.
+      std::vector<SignalCounts> fSignalCounts;
+      std::vector<int> fRecoCounts;
+      std::vector<double> fWeights; //Weights for the universes in the current group
+
+      //Number of candidates in fCands that cuts countAsReco()
+      int countReco(const NeutronMultiplicity& cuts) const;
+
+      //Fill fSignalCounts from event's candidates and FS particles
+      void countSignal(const evt::Universe& event);
+
+      //Fill fRecoCounts from event's candidates
+      void countReco(const evt::Universe& event);
+
+      //Fill signal histograms for one universe from fSignalCounts
+      void fillSignal(const evt::Universe& univ, const double weight);
+
+      //x axis of every histogram is grid point
+      using HIST = util::FlatHistWrapper<evt::Universe>;
+      using HIST2D = util::FlatHist2DWrapper<evt::Universe>;
+
+      HIST2D* fSignalMultiplicity; //Reco multiplicity in signal events
+      HIST2D* fBackgroundMultiplicity;
+      HIST2D* fDataMultiplicity;
+
+      HIST* fFSNeutrons; //Efficiency denominator: FS neutrons countAsTruth()
+      HIST* fFoundFSNeutrons; //Efficiency numerator: FS neutrons countAsTruth() with at least 1 candidate countAsReco()
+      HIST* fSelectedCands; //Purity denominator: candidates countAsReco() in signal events
+      HIST* fNeutronCands; //Purity numerator: candidates countAsReco() caused by a neutron, directly or after reinteracting
+
+      HIST* fNMCEntries; //Number of entries that make it into mcSignal() for each universe
+      HIST* fNDataEntries;
+  };
+}
+
+#endif //ANA_NEUTRONTHRESHOLDSCAN_H
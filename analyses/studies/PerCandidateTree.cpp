@@ -9,10 +9,16 @@
 
 //util includes
 #include "util/Factory.cpp"
+#include "util/SafeROOTName.h"
+
+//ROOT includes
+#include "TBranch.h"
 
 //c++ includes
 #include <cmath>
 #include <functional> //std::bind
+#include <iostream>
+#include <algorithm>
 
 using namespace units;
 
@@ -21,47 +27,184 @@ namespace ana
   PerCandidateTree::PerCandidateTree(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass, std::vector<background_t>& backgrounds,
                                      std::map<std::string, std::vector<evt::Universe*>>& univs): Study(config, dir, std::move(mustPass), backgrounds, univs),
                                                                                                  fCuts(config["variable"]),
-                                                                                                 fBackgroundTrees(backgrounds, dir, "BackgroundPerCandidateTree", "One entry for each truth-matched neutron candidate")
+                                                                                                 fBackgroundTrees(backgrounds, dir, "BackgroundPerCandidateTree", "One entry for each truth-matched neutron candidate"),
+                                                                                                 fColumnar(config["columnar"]), fCV(univs["cv"].front()),
+                                                                                                 fWriter(dir.writer())
   {
     fMCTree = dir.make<TTree>("SignalPerCandidateTree", "One entry for each truth-matched neutron candidate");
 
-    connectMCBranches(*fMCTree);
-    connectRecoBranches(*fMCTree);
-
     using namespace std::placeholders; //for _1 which forwards the first argument passed to the bound function
-    fBackgroundTrees.visit(std::bind(&PerCandidateTree::connectMCBranches, this, _1));
-    fBackgroundTrees.visit(std::bind(&PerCandidateTree::connectRecoBranches, this, _1));
+    if(fColumnar)
+    {
+      const auto& columnar = config["columnar"];
+      const auto algorithm = columnar["compression"].as<std::string>("LZ4");
+      const std::map<std::string, int> algorithms = {{"ZLIB", 1}, {"LZMA", 2}, {"LZ4", 4}, {"ZSTD", 5}};
+      const auto foundAlgorithm = algorithms.find(algorithm);
+      if(foundAlgorithm == algorithms.end()) throw std::runtime_error("PerCandidateTree doesn't know about a compression algorithm named " + algorithm + ".  Try ZLIB, LZMA, LZ4, or ZSTD.");
+      fCompression = foundAlgorithm->second * 100 + columnar["level"].as<int>(4);
+
+      //Fill exactly one basket of each float branch per cluster so a reader never has to unzip half of a basket
+      fBasketSize = columnar["basketSize"].as<int>(64000);
+      fAutoFlush = columnar["autoFlush"].as<Long64_t>(fBasketSize / sizeof(float));
+
+      for(const auto& bandName: columnar["weightBands"].as<std::vector<std::string>>(std::vector<std::string>()))
+      {
+        const auto band = univs.find(bandName);
+        if(band == univs.end()) throw std::runtime_error("PerCandidateTree can't save weights for error band " + bandName + " because this job doesn't have it.");
+        if(!band->second.front()->IsVerticalOnly()) throw std::runtime_error("PerCandidateTree can only save weights for vertical error bands, but " + bandName + " changes reco quantities.");
+
+        for(const auto univ: band->second)
+        {
+          const size_t index = fWeightIndex.size();
+          fWeightIndex[univ] = index;
+        }
+        fWeightBands.push_back(bandName);
+        fBandWeights.emplace_back(band->second.size(), 0);
+      }
+      fWeights.resize(fWeightIndex.size(), 0);
+
+      connectColumns(*fMCTree);
+      fBackgroundTrees.visit(std::bind(&PerCandidateTree::connectColumns, this, _1));
+    }
+    else
+    {
+      connectMCBranches(*fMCTree);
+      connectRecoBranches(*fMCTree);
+
+      fBackgroundTrees.visit(std::bind(&PerCandidateTree::connectMCBranches, this, _1));
+      fBackgroundTrees.visit(std::bind(&PerCandidateTree::connectRecoBranches, this, _1));
+    }
   }
 
   void PerCandidateTree::connectMCBranches(TTree& tree)
   {
-    tree.Branch("FSPDG", &fFSPDG);
-    tree.Branch("TruthE", &fTruthE);
-    tree.Branch("TruthAngle", &fTruthAngle);
-    tree.Branch("EventWeight", &fEventWeight);
+    tree.Branch("FSPDG", &fBranches.FSPDG);
+    tree.Branch("TruthE", &fBranches.TruthE);
+    tree.Branch("TruthAngle", &fBranches.TruthAngle);
+    tree.Branch("EventWeight", &fBranches.EventWeight);
   }
 
   void PerCandidateTree::connectRecoBranches(TTree& tree)
   {
-    tree.Branch("EDep", &fEDep);
-    tree.Branch("DistFromVertex", &fDistFromVertex);
-    tree.Branch("DeltaT", &fDeltaT);
-    tree.Branch("AngleWrtZ", &fAngleWrtZ);
-    tree.Branch("AngleTransverseToZ", &fAngleTransverseToZ);
-    tree.Branch("CosineWrtMuon", &fCosineWrtMuon);
-    tree.Branch("SineWrtMuon", &fSineWrtMuon);
-    tree.Branch("NDigits", &fNDigits);
-    tree.Branch("NClusters", &fNClusters);
-    tree.Branch("NCandidates", &fNCandidates);
-    tree.Branch("HighestDigitE", &fHighestDigitE);
-    tree.Branch("SmallestAngleDiff", &fSmallestAngleDiff);
-
-    tree.Branch("EventWeight", &fEventWeight);
+    tree.Branch("EDep", &fBranches.EDep);
+    tree.Branch("DistFromVertex", &fBranches.DistFromVertex);
+    tree.Branch("DeltaT", &fBranches.DeltaT);
+    tree.Branch("AngleWrtZ", &fBranches.AngleWrtZ);
+    tree.Branch("AngleTransverseToZ", &fBranches.AngleTransverseToZ);
+    tree.Branch("CosineWrtMuon", &fBranches.CosineWrtMuon);
+    tree.Branch("SineWrtMuon", &fBranches.SineWrtMuon);
+    tree.Branch("NDigits", &fBranches.NDigits);
+    tree.Branch("NClusters", &fBranches.NClusters);
+    tree.Branch("NCandidates", &fBranches.NCandidates);
+    tree.Branch("HighestDigitE", &fBranches.HighestDigitE);
+    tree.Branch("SmallestAngleDiff", &fBranches.SmallestAngleDiff);
+
+    tree.Branch("EventWeight", &fBranches.EventWeight);
+  }
+
+  void PerCandidateTree::connectColumns(TTree& tree)
+  {
+    tree.Branch("FSPDG", &fColumns.FSPDG);
+    tree.Branch("TruthE", &fColumns.TruthE);
+    tree.Branch("TruthAngle", &fColumns.TruthAngle);
+
+    tree.Branch("EDep", &fColumns.EDep);
+    tree.Branch("DistFromVertex", &fColumns.DistFromVertex);
+    tree.Branch("DeltaT", &fColumns.DeltaT);
+    tree.Branch("AngleWrtZ", &fColumns.AngleWrtZ);
+    tree.Branch("AngleTransverseToZ", &fColumns.AngleTransverseToZ);
+    tree.Branch("CosineWrtMuon", &fColumns.CosineWrtMuon);
+    tree.Branch("SineWrtMuon", &fColumns.SineWrtMuon);
+    tree.Branch("NDigits", &fColumns.NDigits);
+    tree.Branch("NClusters", &fColumns.NClusters);
+    tree.Branch("NCandidates", &fColumns.NCandidates);
+    tree.Branch("HighestDigitE", &fColumns.HighestDigitE);
+    tree.Branch("SmallestAngleDiff", &fColumns.SmallestAngleDiff);
+
+    tree.Branch("EventWeight", &fColumns.EventWeight);
+
+    for(size_t whichBand = 0; whichBand < fWeightBands.size(); ++whichBand)
+    {
+      const auto branchName = util::SafeROOTName("Weights_" + fWeightBands[whichBand]);
+      tree.Branch(branchName.c_str(), fBandWeights[whichBand].data(), (branchName + "[" + std::to_string(fBandWeights[whichBand].size()) + "]/F").c_str());
+    }
+
+    tree.SetBasketSize("*", fBasketSize);
+    tree.SetAutoFlush(fAutoFlush);
+    TIter nextBranch(tree.GetListOfBranches());
+    while(auto branch = static_cast<TBranch*>(nextBranch())) branch->SetCompressionSettings(fCompression);
+  }
+
+  PerCandidateTree::ColumnarRow& PerCandidateTree::ColumnarRow::operator =(const Row& row)
+  {
+    FSPDG = row.FSPDG;
+    TruthE = row.TruthE;
+    TruthAngle = row.TruthAngle;
+
+    EDep = row.EDep;
+    DistFromVertex = row.DistFromVertex;
+    DeltaT = row.DeltaT;
+    AngleWrtZ = row.AngleWrtZ;
+    AngleTransverseToZ = row.AngleTransverseToZ;
+    CosineWrtMuon = row.CosineWrtMuon;
+    SineWrtMuon = row.SineWrtMuon;
+    NDigits = row.NDigits;
+    NClusters = row.NClusters;
+    NCandidates = row.NCandidates;
+    HighestDigitE = row.HighestDigitE;
+    SmallestAngleDiff = row.SmallestAngleDiff;
+
+    EventWeight = row.EventWeight;
+
+    return *this;
+  }
+
+  void PerCandidateTree::mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt)
+  {
+    if(!fColumnar) return Study::mcSignal(univs, model, evt);
+
+    //Every vertical universe sees the same candidates as the CV, so write each candidate once with all of their weights
+    if(std::find(univs.begin(), univs.end(), fCV) == univs.end()) return;
+    for(const auto univ: univs)
+    {
+      const auto found = fWeightIndex.find(univ);
+      if(found != fWeightIndex.end()) fWeights[found->second] = model.GetWeight(*univ, evt);
+    }
+
+    mcSignal(*fCV, model.GetWeight(*fCV, evt));
+  }
+
+  void PerCandidateTree::mcBackground(const std::vector<evt::Universe*>& univs, const background_t& background, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt)
+  {
+    if(!fColumnar) return Study::mcBackground(univs, background, model, evt);
+
+    if(std::find(univs.begin(), univs.end(), fCV) == univs.end()) return;
+    for(const auto univ: univs)
+    {
+      const auto found = fWeightIndex.find(univ);
+      if(found != fWeightIndex.end()) fWeights[found->second] = model.GetWeight(*univ, evt);
+    }
+
+    mcBackground(*fCV, background, model.GetWeight(*fCV, evt));
+  }
+
+  void PerCandidateTree::afterAllFiles(const events /*passedSelection*/)
+  {
+    fWriter.drain(); //Make sure every entry made it into a tree
+
+    auto report = [](TTree& tree)
+                  {
+                    const double MB = 1024. * 1024.;
+                    std::cout << tree.GetName() << ": " << tree.GetEntries() << " entries in " << tree.GetZipBytes() / MB << " MB compressed from "
+                              << tree.GetTotBytes() / MB << " MB (" << tree.GetTotBytes() / std::max(1., static_cast<double>(tree.GetZipBytes())) << "x)\n";
+                  };
+    report(*fMCTree);
+    fBackgroundTrees.visit(report);
   }
 
   void PerCandidateTree::mcSignal(const evt::Universe& event, const events weight)
   {
-    fEventWeight = weight.in<events>();
+    fRow.EventWeight = weight.in<events>();
 
     //Physics objects I'll need
     const auto cands = event.Get<MCCandidate>(event.Getblob_edep(), event.Getblob_zPos(),
@@ -74,7 +217,7 @@ namespace ana
     const auto fs = event.Get<FSPart>(event.GetTruthMatchedPDG_code(), event.GetTruthMatchedenergy(), event.GetTruthMatchedangle_wrt_z());
     const auto vertex = event.GetVtx();
 
-    fNCandidates = fCuts.reco(event).in<neutrons>();
+    fRow.NCandidates = fCuts.reco(event).in<neutrons>();
 
     for(auto whichCand = cands.begin(); whichCand != cands.end(); ++whichCand)
     {
@@ -82,7 +225,7 @@ namespace ana
       {
         fillMCBranches(*whichCand, fs, vertex);
         fillRecoBranches(whichCand, vertex, cands);
-        fMCTree->Fill();
+        fill(*fMCTree);
       }
     }
   }
@@ -90,7 +233,7 @@ namespace ana
   void PerCandidateTree::mcBackground(const evt::Universe& event, const background_t& background, const events weight)
   {
     auto& treeToFill = fBackgroundTrees[background];
-    fEventWeight = weight.in<events>();
+    fRow.EventWeight = weight.in<events>();
 
     //Physics objects I'll need
     const auto cands = event.Get<MCCandidate>(event.Getblob_edep(), event.Getblob_zPos(),
@@ -103,7 +246,7 @@ namespace ana
     const auto fs = event.Get<FSPart>(event.GetTruthMatchedPDG_code(), event.GetTruthMatchedenergy(), event.GetTruthMatchedangle_wrt_z());
     const auto vertex = event.GetVtx();
 
-    fNCandidates = fCuts.reco(event).in<neutrons>();
+    fRow.NCandidates = fCuts.reco(event).in<neutrons>();
 
     for(auto whichCand = cands.begin(); whichCand != cands.end(); ++whichCand)
     {
@@ -111,7 +254,7 @@ namespace ana
       {
         fillMCBranches(*whichCand, fs, vertex);
         fillRecoBranches(whichCand, vertex, cands);
-        treeToFill.Fill();
+        fill(treeToFill);
       }
     }
   }
@@ -133,27 +276,27 @@ namespace ana
       if(pdg != 2112 && cand.dist_to_edep_as_neutron > 0_mm) pdg = std::numeric_limits<int>::max();
     }
 
-    fFSPDG = pdg;
-    fTruthE = truthE;
-    fTruthAngle = truthAngle;
+    fRow.FSPDG = pdg;
+    fRow.TruthE = truthE;
+    fRow.TruthAngle = truthAngle;
   }
 
   void PerCandidateTree::fillRecoBranches(const std::vector<MCCandidate>::const_iterator whichCand, const units::LorentzVector<mm> vertex, const std::vector<MCCandidate>& allCands)
   {
     const auto& cand = *whichCand;
     const mm deltaZ = cand.z - (vertex.z() - 17_mm); //TODO: 17mm is half a plane width.  Correction for targets?
-    fDistFromVertex = sqrt(pow<2>(cand.transverse) + pow<2>(deltaZ)).in<mm>();
-    fAngleTransverseToZ = this->angle(cand, vertex);
-    fAngleWrtZ = atan2(cand.transverse, deltaZ);
+    fRow.DistFromVertex = sqrt(pow<2>(cand.transverse) + pow<2>(deltaZ)).in<mm>();
+    fRow.AngleTransverseToZ = this->angle(cand, vertex);
+    fRow.AngleWrtZ = atan2(cand.transverse, deltaZ);
     const mm muonDistance = sqrt(pow<2>(cand.muon_long) + pow<2>(cand.muon_transverse));
-    fCosineWrtMuon = cand.muon_long.in<mm>() / muonDistance.in<mm>();
-    fSineWrtMuon = cand.muon_transverse.in<mm>() / muonDistance.in<mm>();
+    fRow.CosineWrtMuon = cand.muon_long.in<mm>() / muonDistance.in<mm>();
+    fRow.SineWrtMuon = cand.muon_transverse.in<mm>() / muonDistance.in<mm>();
 
-    fEDep = cand.edep.in<MeV>();
-    fDeltaT = cand.time.in<ns>();
-    fNDigits = cand.nDigits;
-    fNClusters = cand.nClusters;
-    fHighestDigitE = cand.highestDigitE.in<MeV>();
+    fRow.EDep = cand.edep.in<MeV>();
+    fRow.DeltaT = cand.time.in<ns>();
+    fRow.NDigits = cand.nDigits;
+    fRow.NClusters = cand.nClusters;
+    fRow.HighestDigitE = cand.highestDigitE.in<MeV>();
 
     //Checked that angle() can return a negative number.  Consider deltaZ < 0.
     auto compareAngle = [this, &vertex](const auto& lhs, const auto& rhs)
@@ -162,12 +305,36 @@ namespace ana
                         };
     const auto smallestAnglePrefix = std::min_element(allCands.begin(), whichCand, compareAngle);
     const auto smallestAnglePostfix = std::min_element(whichCand+1, allCands.end(), compareAngle);
-    fSmallestAngleDiff = 9999; //std::numeric_limits<double>::max();
-    if(smallestAnglePrefix != allCands.end()) fSmallestAngleDiff = fabs(this->angle(*whichCand, vertex) - this->angle(*smallestAnglePrefix, vertex));
-    if(smallestAnglePostfix != allCands.end()) fSmallestAngleDiff = std::min(fSmallestAngleDiff, fabs(this->angle(*whichCand, vertex) - this->angle(*smallestAnglePostfix, vertex)));
+    fRow.SmallestAngleDiff = 9999; //std::numeric_limits<double>::max();
+    if(smallestAnglePrefix != allCands.end()) fRow.SmallestAngleDiff = fabs(this->angle(*whichCand, vertex) - this->angle(*smallestAnglePrefix, vertex));
+    if(smallestAnglePostfix != allCands.end()) fRow.SmallestAngleDiff = std::min(fRow.SmallestAngleDiff, fabs(this->angle(*whichCand, vertex) - this->angle(*smallestAnglePostfix, vertex)));
   }
 
 
+  void PerCandidateTree::fill(TTree& tree)
+  {
+    if(fColumnar)
+    {
+      fWriter.push([this, &tree, row = fRow, weights = fWeights]()
+                   {
+                     fColumns = row;
+                     auto weight = weights.begin();
+                     for(auto& band: fBandWeights)
+                     {
+                       for(auto& univWeight: band) univWeight = *weight++;
+                     }
+                     tree.Fill();
+                   });
+      return;
+    }
+
+    fWriter.push([this, &tree, row = fRow]()
+                 {
+                   fBranches = row;
+                   tree.Fill();
+                 });
+  }
+
   double PerCandidateTree::angle(const MCCandidate& cand, const units::LorentzVector<mm>& vertex) const
   {
     const mm deltaZ = cand.z - (vertex.z() - 17_mm); //TODO: 17mm is half a plane width.  Correction for targets?
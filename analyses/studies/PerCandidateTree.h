@@ -2,6 +2,15 @@
 //Brief: A study on how effectively I detect neutron candidates. Should plot
 //       efficiency to find a FS neutron and a breakdown of fake neutron candidates
 //       in multiple neutron canddiate observables.
+//
+//       Add a "columnar" block to write single precision branches with one row per
+//       candidate instead of one per universe:
+//       columnar:
+//         compression: LZ4 #or ZSTD, ZLIB, LZMA
+//         level: 4
+//         basketSize: 64000 #bytes per branch
+//         autoFlush: 16000 #entries per cluster.  Defaults to one float basket.
+//         weightBands: [Flux] #Save a weight for each universe in these vertical bands
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //signal includes
@@ -14,6 +23,10 @@
 #include "util/Categorized.h"
 #include "util/units.h"
 #include "util/mathWithUnits.h"
+#include "util/AsyncWriter.h"
+
+//c++ includes
+#include <unordered_map>
 
 #ifndef SIG_NEUTRONDETECTION_H
 #define SIG_NEUTRONDETECTION_H
@@ -31,8 +44,12 @@ namespace ana
       virtual void mcSignal(const evt::Universe& event, const events weight) override;
       void mcBackground(const evt::Universe& event, const background_t& background, const events weight) override;
 
-      //No histograms to normalize
-      virtual void afterAllFiles(const events /*passedSelection*/) override {};
+      //Columnar output only fills once for the CV's group of universes
+      virtual void mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override;
+      virtual void mcBackground(const std::vector<evt::Universe*>& univs, const background_t& background, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override;
+
+      //Print how big each tree got
+      virtual void afterAllFiles(const events /*passedSelection*/) override;
 
       //Do nothing for the Truth tree and data
       virtual void truth(const evt::Universe& /*event*/, const events /*weight*/) override {};
@@ -87,27 +104,80 @@ namespace ana
       TTree* fMCTree;
       util::Categorized<TTree, background_t> fBackgroundTrees;
 
-      //Truth-matched branches
-      double fFSPDG;
-      double fTruthE;
-      double fTruthAngle;
-
-      //Reco branches
-      double fEDep;
-      double fDistFromVertex;
-      double fDeltaT;
-      double fAngleWrtZ;
-      double fAngleTransverseToZ;
-      double fCosineWrtMuon;
-      double fSineWrtMuon;
-      int fNDigits;
-      int fNClusters;
-      int fNCandidates;
-      double fHighestDigitE;
-      double fSmallestAngleDiff;
-
-      //Per-event weight
-      double fEventWeight;
+      //Values of every branch for one entry
+      struct Row
+      {
+        //Truth-matched branches
+        double FSPDG;
+        double TruthE;
+        double TruthAngle;
+
+        //Reco branches
+        double EDep;
+        double DistFromVertex;
+        double DeltaT;
+        double AngleWrtZ;
+        double AngleTransverseToZ;
+        double CosineWrtMuon;
+        double SineWrtMuon;
+        int NDigits;
+        int NClusters;
+        int NCandidates;
+        double HighestDigitE;
+        double SmallestAngleDiff;
+
+        //Per-event weight
+        double EventWeight;
+      };
+
+      //Single precision version of Row for columnar output
+      struct ColumnarRow
+      {
+        int FSPDG;
+        float TruthE;
+        float TruthAngle;
+
+        float EDep;
+        float DistFromVertex;
+        float DeltaT;
+        float AngleWrtZ;
+        float AngleTransverseToZ;
+        float CosineWrtMuon;
+        float SineWrtMuon;
+        int NDigits;
+        int NClusters;
+        int NCandidates;
+        float HighestDigitE;
+        float SmallestAngleDiff;
+
+        float EventWeight;
+
+        ColumnarRow& operator =(const Row& row);
+      };
+
+      Row fRow; //Set up by the event loop for the next entry
+      Row fBranches; //Where the TTrees read from.  Only fWriter touches it.
+
+      //Columnar output configuration
+      bool fColumnar;
+      int fCompression; //ROOT's algorithm * 100 + level
+      int fBasketSize;
+      Long64_t fAutoFlush;
+
+      ColumnarRow fColumns; //Where columnar TTrees read from.  Only fWriter touches it.
+      std::vector<std::string> fWeightBands;
+      std::vector<std::vector<float>> fBandWeights; //Branch buffers for [band][universe].  Only fWriter touches them.
+      std::unordered_map<const evt::Universe*, size_t> fWeightIndex; //Universe to index in fWeights
+      std::vector<float> fWeights; //Set up by the event loop for the next entry
+      const evt::Universe* fCV;
+
+      void connectColumns(TTree& tree);
+
+      //Runs TTree::Fill() so that baskets can be compressed on another thread
+      util::AsyncWriter& fWriter;
+
+      //Copy fRow into tree on fWriter's thread
+      void fill(TTree& tree);
 
       double angle(const MCCandidate& cand, const units::LorentzVector<mm>& vertex) const;
   };
@@ -0,0 +1,226 @@
+//File: SelectionTable.h
+//Brief: A Study template that saves one row per selected event instead of
+//       filling histograms.  Each row has the event's ID, background category,
+//       reco and truth VARIABLE values, and its weight in every universe that
+//       shares its reco values.  RebinSelectionTable turns these tables into
+//       the same histograms as CrossSectionSignal or CrossSectionSideband with
+//       any binning without running over the AnaTuples again.
+//
+//       Configure it like a CrossSectionSignal or CrossSectionSideband but
+//       without a binning.  It's a sideband table when its configuration has
+//       a "fails" block.  Otherwise, it's a signal table that also wants the
+//       Truth loop for efficiency denominators.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//base includes
+#include "analyses/base/Study.h"
+#include "analyses/base/Background.h"
+
+//analyses includes
+#include "analyses/studies/SelectionTableFormat.h"
+
+//evt includes
+#include "evt/Universe.h"
+#include "evt/EventID.h"
+
+//util includes
+#include "util/units.h"
+#include "util/WithUnits.h"
+#include "util/Directory.h"
+
+//ROOT includes
+#include "TTree.h"
+#include "TNamed.h"
+#include "TList.h"
+
+//c++ includes
+#include <unordered_map>
+#include <algorithm>
+
+#ifndef ANA_SELECTIONTABLE_H
+#define ANA_SELECTIONTABLE_H
+
+namespace ana
+{
+  //A VARIABLE shall have:
+  //1) A std::string name() const method that will be used to name all of the plots produced
+  //2) A UNIT reco(const Universe& univ) const method
+  //3) A UNIT truth(const Universe& unix) const method
+  //4) The return type of reco() and truth() must match
+  template <class VARIABLE>
+  class SelectionTable: public Study
+  {
+    private:
+      using UNIT = decltype(std::declval<VARIABLE>().reco(std::declval<evt::Universe>()));
+      static_assert(std::is_same<UNIT, decltype(std::declval<VARIABLE>().truth(std::declval<evt::Universe>()))>::value,
+                    "Reco and truth variable calculations must be in the same units!");
+
+    public:
+      SelectionTable(const YAML::Node& config, util::Directory& dir, cuts_t&& mustPass, const std::vector<background_t>& backgrounds,
+                     std::map<std::string, std::vector<evt::Universe*>>& universes): Study(config, dir, std::move(mustPass), backgrounds, universes),
+                                                                                       fVar(config["variable"]), fIsSideband(config["fails"].IsDefined()),
+                                                                                       fTruthTree(nullptr)
+      {
+        for(const auto& background: backgrounds) fBackgrounds.push_back(background.get());
+
+        //Name every universe the same way PrecomputeWeights does
+        for(const auto& band: universes)
+        {
+          for(size_t whichUniv = 0; whichUniv < band.second.size(); ++whichUniv) fUnivNames[band.second[whichUniv]] = band.first + "_" + std::to_string(whichUniv);
+        }
+
+        fRecoTree = dir.make<TTree>(table::recoTreeName, ("Selected events in Reco " + fVar.name()).c_str());
+        connectBranches(*fRecoTree);
+        fRecoTree->Branch("reco", &fReco);
+
+        if(!fIsSideband)
+        {
+          fTruthTree = dir.make<TTree>(table::truthTreeName, ("Efficiency denominator in Truth " + fVar.name()).c_str());
+          connectBranches(*fTruthTree);
+
+          //The flux integral doesn't depend on which events were selected, so save it now
+          //with 1 bin.  RebinSelectionTable copies it into every bin of the new binning.
+          auto cv = universes["cv"].front();
+          if(cv)
+          {
+            PlotUtils::HistWrapper<evt::Universe> oneBin("fluxOneBin", "", 1, 0., 1., universes);
+            auto fluxIntegral = cv->GetFluxIntegral(oneBin);
+            fluxIntegral->SetName(table::fluxName);
+            dir.mv(fluxIntegral);
+            delete oneBin.hist;
+          }
+        }
+      }
+
+      virtual ~SelectionTable() = default;
+
+      virtual void mcSignal(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        fReco = fVar.reco(*univs.front()).template in<UNIT>();
+        fillRow(*fRecoTree, univs, table::signalCategory, model, evt);
+      }
+
+      virtual void mcBackground(const std::vector<evt::Universe*>& univs, const background_t& background, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        fReco = fVar.reco(*univs.front()).template in<UNIT>();
+        const auto found = std::find(fBackgrounds.begin(), fBackgrounds.end(), background.get());
+        fillRow(*fRecoTree, univs, 1 + std::distance(fBackgrounds.begin(), found), model, evt);
+      }
+
+      virtual void truth(const std::vector<evt::Universe*>& univs, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt) override
+      {
+        assert(!univs.empty());
+        if(fTruthTree) fillRow(*fTruthTree, univs, table::signalCategory, model, evt);
+      }
+
+      //Data and "fake data" go into the CV only.  ev_ branches are in both data and MC AnaTuples.
+      virtual void data(const evt::Universe& event, const events weight) override
+      {
+        setEventID(event.GetEventID(true));
+        fCategory = table::dataCategory;
+        fGroup = -1;
+        fReco = fVar.reco(event).template in<UNIT>();
+        fTruth = 0;
+        fWeights.assign(1, weight.template in<events>());
+        fRecoTree->Fill();
+      }
+
+      virtual void afterAllFiles(const events /*passedSelection*/) override
+      {
+        //Everything RebinSelectionTable needs to turn rows back into histograms
+        auto info = fRecoTree->GetUserInfo();
+        info->Add(new TNamed(table::variableName, fVar.name().c_str()));
+        info->Add(new TNamed(table::unitName, units::detail::unit<UNIT>::name().c_str()));
+        info->Add(new TNamed(table::weightUnitName, units::detail::unit<events>::name().c_str()));
+        info->Add(new TNamed(table::roleName, fIsSideband?"sideband":"signal"));
+
+        std::string categories = "Signal\n";
+        for(const auto background: fBackgrounds) categories += background->name() + "\n";
+        categories += "Other\n";
+        info->Add(new TNamed(table::categoriesName, categories.c_str()));
+
+        for(const auto& group: fGroups)
+        {
+          std::string columns;
+          for(const auto univ: group.second.univs) columns += fUnivNames[univ] + "\n";
+          info->Add(new TNamed((table::groupPrefix + std::to_string(group.second.index)).c_str(), columns.c_str()));
+        }
+      }
+
+      virtual bool wantsTruthLoop() const override { return !fIsSideband; }
+
+      using Registrar = Study::Registrar<SelectionTable<VARIABLE>>;
+
+    private:
+      VARIABLE fVar;
+      const bool fIsSideband;
+
+      std::vector<const ana::Background*> fBackgrounds; //Defines the category number of each background
+      std::unordered_map<const evt::Universe*, std::string> fUnivNames;
+
+      //Universes that share reco values are always passed together in the same order.
+      //Number each group of compatible universes the first time I see it so that rows
+      //only have to store weights.
+      struct group
+      {
+        int index;
+        std::vector<const evt::Universe*> univs;
+      };
+      std::unordered_map<const evt::Universe*, group> fGroups;
+
+      //Rows for the selected region and efficiency denominator
+      TTree* fRecoTree;
+      TTree* fTruthTree; //nullptr for sidebands
+
+      //Branches
+      int fRun;
+      int fSubrun;
+      int fGate;
+      int fSlice;
+      int fCategory;
+      int fGroup; //Which set of columns fWeights corresponds to.  -1 for data.
+      double fReco;
+      double fTruth;
+      std::vector<float> fWeights; //Single precision is plenty for weights and halves the file size
+
+      void connectBranches(TTree& tree)
+      {
+        tree.Branch("run", &fRun);
+        tree.Branch("subrun", &fSubrun);
+        tree.Branch("gate", &fGate);
+        tree.Branch("slice", &fSlice);
+        tree.Branch("category", &fCategory);
+        tree.Branch("group", &fGroup);
+        tree.Branch("truth", &fTruth);
+        tree.Branch("weights", &fWeights);
+      }
+
+      void setEventID(const evt::SliceID& id)
+      {
+        fRun = id.run;
+        fSubrun = id.subrun;
+        fGate = id.gate;
+        fSlice = id.slice;
+      }
+
+      void fillRow(TTree& tree, const std::vector<evt::Universe*>& univs, const int category, const PlotUtils::Model<evt::Universe>& model, const PlotUtils::detail::empty& evt)
+      {
+        auto found = fGroups.find(univs.front());
+        if(found == fGroups.end()) found = fGroups.emplace(univs.front(), group{static_cast<int>(fGroups.size()), std::vector<const evt::Universe*>(univs.begin(), univs.end())}).first;
+
+        setEventID(univs.front()->GetEventID(false));
+        fCategory = category;
+        fGroup = found->second.index;
+        fTruth = fVar.truth(*univs.front()).template in<UNIT>();
+
+        fWeights.resize(univs.size());
+        for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) fWeights[whichUniv] = model.GetWeight(*univs[whichUniv], evt);
+
+        tree.Fill();
+      }
+  };
+}
+
+#endif //ANA_SELECTIONTABLE_H
@@ -0,0 +1,37 @@
+//File: SelectionTableFormat.h
+//Brief: Names of the TTrees, branches, and metadata that SelectionTable writes
+//       and RebinSelectionTable reads.  Kept separate from SelectionTable.h so that
+//       programs that only read tables don't need the whole event model.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef ANA_SELECTIONTABLEFORMAT_H
+#define ANA_SELECTIONTABLEFORMAT_H
+
+namespace ana
+{
+  namespace table
+  {
+    //TTrees made under a SelectionTable's Directory
+    constexpr auto recoTreeName = "SelectionTable";
+    constexpr auto truthTreeName = "TruthTable";
+
+    //One bin flux integral in every universe.  Every bin of a cross section's flux
+    //integral has the same content, so it can be expanded to any binning later.
+    constexpr auto fluxName = "TableFluxIntegral";
+
+    //TNameds in the reco TTree's GetUserInfo()
+    constexpr auto variableName = "Variable";
+    constexpr auto unitName = "Unit";
+    constexpr auto weightUnitName = "WeightUnit";
+    constexpr auto roleName = "Role";
+    constexpr auto categoriesName = "Categories"; //One per line in category order
+    constexpr auto groupPrefix = "Group_"; //Universe names for each value of the group branch, one per line
+
+    //Special values of the category branch.  Backgrounds are numbered from 1 in the
+    //order they were configured, and the last category is events in no background.
+    constexpr int dataCategory = -1;
+    constexpr int signalCategory = 0;
+  }
+}
+
+#endif //ANA_SELECTIONTABLEFORMAT_H
@@ -39,6 +39,7 @@ namespace ana
                                                                                                                    config["binning"]["xy"]["min"].as<double>(),
                                                                                                                    config["binning"]["xy"]["max"].as<double>(),
                                                                                                                    univs),
+                                                                                               fXYPositionsByTargetAndMaterial(fXYPositionsByTargetByMaterial),
                                                                                                fSelectedSignalXYPositionsByMaterial("VertexXY_Signal",
                                                                                                                    "Reco Vertex X; Reco Vertex Y",
                                                                                                                    ::elements, dir,
@@ -50,7 +51,7 @@ namespace ana
                                                                                                                    config["binning"]["xy"]["max"].as<double>(),
                                                                                                                    univs)
   {
-    fSelectedSignalZPositions = dir.make<units::WithUnits<HistWrapper<evt::Universe>, mm, events>>("VertexZ_Signal", "Reco Vertex Z",
+    fSelectedSignalZPositions = dir.make<units::WithUnits<util::FlatHistWrapper<evt::Universe>, mm, events>>("VertexZ_Signal", "Reco Vertex Z",
                                                                                                    config["binning"]["z"]["nBins"].as<int>(),
                                                                                                    config["binning"]["z"]["min"].as<double>(),
                                                                                                    config["binning"]["z"]["max"].as<double>(), univs);
@@ -66,7 +67,7 @@ namespace ana
   void TargetCutTuning::mcBackground(const evt::Universe& event, const background_t& background, const events weight)
   {
     fZPositionsByTarget[background].Fill(&event, event.GetVtx().z(), weight);
-    fXYPositionsByTargetByMaterial[background][event.GetTruthTargetZ()].Fill(&event, event.GetVtx().x(), event.GetVtx().y(), weight);
+    fXYPositionsByTargetAndMaterial(background, event.GetTruthTargetZ()).Fill(&event, event.GetVtx().x(), event.GetVtx().y(), weight);
   }
 
   /*void TargetCutTuning::data(const evt::Universe& event, const events weight)
@@ -80,6 +81,9 @@ namespace ana
     fZPositionsByTarget.visit([](auto& hist) { hist.SyncCVHistos(); });
     fSelectedSignalZPositions->SyncCVHistos();
     //fSelectedZPosition.SyncCVHistos();
+
+    fXYPositionsByTargetByMaterial.visit([](auto& byMaterial) { byMaterial.visit([](auto& hist) { util::materialize(hist); }); });
+    fSelectedSignalXYPositionsByMaterial.visit([](auto& hist) { util::materialize(hist); });
   }
 }
 
@@ -10,6 +10,7 @@
 
 //util includes
 #include "util/Categorized.h"
+#include "util/FlatHistWrapper.h"
 
 #ifndef ANA_TARGETCUTTUNING_H
 #define ANA_TARGETCUTTUNING_H
@@ -26,7 +27,7 @@ namespace ana
       //Do this study only for MC signal events.
       virtual void mcSignal(const evt::Universe& event, const events weight) override;
 
-      //syncCVHistos()
+      //syncCVHistos() and write out the universes of histograms that don't get synced
       virtual void afterAllFiles(const events passedSelection) override;
 
       virtual void mcBackground(const evt::Universe& /*event*/, const background_t& /*background*/, const events /*weight*/) override;
@@ -39,11 +40,14 @@ namespace ana
       virtual bool wantsTruthLoop() const override { return false; }
 
     private:
-      util::Categorized<units::WithUnits<HistWrapper<evt::Universe>, mm, events>, background_t> fZPositionsByTarget; //Event z positions by truth target
-      units::WithUnits<HistWrapper<evt::Universe>, mm, events>* fSelectedSignalZPositions;
-
-      util::Categorized<util::Categorized<units::WithUnits<Hist2DWrapper<evt::Universe>, mm, mm, events>, int>, background_t> fXYPositionsByTargetByMaterial;
-      util::Categorized<units::WithUnits<Hist2DWrapper<evt::Universe>, mm, mm, events>, int> fSelectedSignalXYPositionsByMaterial;
+      //Every target gets a histogram for every material, but only a few of those
+      //combinations ever happen.  Universe histograms are allocated on first Fill().
+      util::Categorized<units::WithUnits<util::FlatHistWrapper<evt::Universe>, mm, events>, background_t> fZPositionsByTarget; //Event z positions by truth target
+      units::WithUnits<util::FlatHistWrapper<evt::Universe>, mm, events>* fSelectedSignalZPositions;
+
+      util::Categorized<util::Categorized<units::WithUnits<util::FlatHist2DWrapper<evt::Universe>, mm, mm, events>, int>, background_t> fXYPositionsByTargetByMaterial;
+      util::FlatCategorized<units::WithUnits<util::FlatHist2DWrapper<evt::Universe>, mm, mm, events>, background_t, int> fXYPositionsByTargetAndMaterial; //Same HISTs with one index
+      util::Categorized<units::WithUnits<util::FlatHist2DWrapper<evt::Universe>, mm, mm, events>, int> fSelectedSignalXYPositionsByMaterial;
   };
 }
 
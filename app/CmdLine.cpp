@@ -86,7 +86,7 @@ namespace app
     }
   }
 
-  CmdLine::CmdLine(const int argc, const char** argv)
+  CmdLine::CmdLine(const int argc, const char** argv, const std::string& outputSuffix)
   {
     std::string configFile;
     const std::string binName = argv[0];
@@ -153,7 +153,7 @@ namespace app
     //doing anything if I fail.
     outFileName.erase(outFileName.find("."));
     outFileName.erase(0, outFileName.rfind("/") + 1);
-    outFileName += std::string((fIsMC?"MC":"Data")) + ".root";
+    outFileName += outputSuffix + std::string((fIsMC?"MC":"Data")) + ".root";
 
     try
     {
@@ -168,7 +168,7 @@ namespace app
 
   CmdLine::~CmdLine()
   {
-    HistFile->Write(); //Ensure that all histograms written to HistFile
+    if(HistFile) HistFile->Write(); //Ensure that all histograms written to HistFile
                        //get saved to the filesystem just before the job
                        //ends.
   }
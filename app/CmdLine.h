@@ -38,10 +38,12 @@ namespace app
   class CmdLine
   {
     public:
-      CmdLine(const int argc, const char** argv);
+      //outputSuffix goes between the last YAML file's name and MC/Data in the output file's name.
+      //Lets other applications share this command line without clobbering ProcessAnaTuples' output.
+      CmdLine(const int argc, const char** argv, const std::string& outputSuffix = "");
       ~CmdLine(); //A great opportunity to make sure my histograms are always saved.
   
-      std::unique_ptr<TFile> HistFile; //File where histograms will be written
+      std::unique_ptr<TFile> HistFile; //File where histograms will be written.  Written by ~CmdLine() unless it was reset().
 
       //const access to names of NTuple files to read
       inline const std::vector<std::string>& TupleFileNames() const { return fTupleFileNames; }
@@ -0,0 +1,130 @@
+//File: PrecomputedWeights.cpp
+//Brief: Model and systematic universe weights only depend on the AnaTuples and the
+//       "model" and "systematics" configuration, so they're the same in every job that
+//       reads the same files.  PrecomputedWeights is a Reweighter that reads them back
+//       from a file written by PrecomputeWeights.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/PrecomputedWeights.h"
+
+//util includes
+#include "util/Hash.h"
+#include "util/SafeROOTName.h"
+
+//YAML-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TNamed.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+
+//c++ includes
+#include <sstream>
+#include <algorithm>
+
+namespace
+{
+  std::string dumpIfPresent(const YAML::Node& node)
+  {
+    if(!node) return "";
+    return YAML::Dump(node);
+  }
+}
+
+namespace app
+{
+  std::string weightConfigHash(const YAML::Node& config, const std::string& playlist)
+  {
+    //Only the parts of "app" that setting up universes and Reweighters read.  Other parameters,
+    //like where to find precomputed weights, shouldn't invalidate them.
+    const auto& appConfig = config["app"];
+    uint64_t hash = util::fnv1a(dumpIfPresent(config["model"]));
+    hash = util::fnv1a(dumpIfPresent(config["systematics"]), hash);
+    hash = util::fnv1a(dumpIfPresent(config["blobAlg"]), hash);
+    for(const auto key: {"AnaTupleName", "HypothesisName", "nFluxUniverses", "useNuEConstraint"}) hash = util::fnv1a(dumpIfPresent(appConfig[key]), hash);
+    hash = util::fnv1a(playlist, hash);
+
+    return util::toHex(hash);
+  }
+
+  std::vector<std::pair<std::string, evt::Universe*>> weightColumns(const std::map<std::string, std::vector<evt::Universe*>>& universes)
+  {
+    std::vector<std::pair<std::string, evt::Universe*>> columns;
+    for(const auto& band: universes)
+    {
+      for(size_t whichUniv = 0; whichUniv < band.second.size(); ++whichUniv) columns.emplace_back(band.first + "_" + std::to_string(whichUniv), band.second[whichUniv]);
+    }
+
+    return columns;
+  }
+
+  std::string weightDirName(const std::string& tupleFileName)
+  {
+    //The file name is just to make weight files easier to browse.  The hash of the whole path
+    //keeps files with the same name from different directories apart.
+    return util::SafeROOTName(tupleFileName.substr(tupleFileName.rfind('/') + 1)) + "_" + util::toHex(util::fnv1a(tupleFileName));
+  }
+
+  PrecomputedWeights::PrecomputedWeights(const std::string& weightFileName, const std::string& configHash,
+                                         const std::map<std::string, std::vector<evt::Universe*>>& universes): PlotUtils::Reweighter<evt::Universe>(),
+                                                                                                                fFile(TFile::Open(weightFileName.c_str(), "READ")),
+                                                                                                                fTree(nullptr)
+  {
+    if(!fFile) throw std::runtime_error("Failed to open a file of precomputed weights named " + weightFileName);
+
+    const auto fileHash = dynamic_cast<TNamed*>(fFile->Get(weightHashName));
+    if(!fileHash) throw std::runtime_error(weightFileName + " doesn't have a configuration hash named " + weightHashName + ".  Is it really a file of precomputed weights?");
+    if(fileHash->GetTitle() != configHash) throw std::runtime_error(weightFileName + " was made with a different model, systematics, or playlist.  Its configuration hash is " + fileHash->GetTitle() + ", but this job's is " + configHash + ".");
+
+    const auto fileColumnList = dynamic_cast<TNamed*>(fFile->Get(weightColumnsName));
+    if(!fileColumnList) throw std::runtime_error(weightFileName + " doesn't have a list of universes named " + weightColumnsName + ".");
+
+    std::vector<std::string> fileColumns;
+    std::stringstream columnNames(fileColumnList->GetTitle());
+    for(std::string name; std::getline(columnNames, name); ) fileColumns.push_back(name);
+    fRow.resize(fileColumns.size(), 1);
+
+    for(const auto& column: weightColumns(universes))
+    {
+      const auto found = std::find(fileColumns.begin(), fileColumns.end(), column.first);
+      if(found == fileColumns.end()) throw std::runtime_error(weightFileName + " doesn't have weights for universe " + column.first + ".");
+      fColumns[column.second] = std::distance(fileColumns.begin(), found);
+    }
+  }
+
+  PrecomputedWeights::~PrecomputedWeights() = default;
+
+  bool PrecomputedWeights::SetTuple(const std::string& tupleFileName, const bool truthTree, const size_t nEntries)
+  {
+    fTree = nullptr;
+
+    auto dir = fFile->GetDirectory(weightDirName(tupleFileName).c_str());
+    if(!dir) return false;
+
+    auto tree = dynamic_cast<TTree*>(dir->Get(truthTree?truthWeightTreeName:recoWeightTreeName));
+    if(!tree || static_cast<size_t>(tree->GetEntries()) != nEntries) return false;
+
+    auto branch = tree->GetBranch(weightBranchName);
+    if(!branch || branch->GetLeaf(weightBranchName)->GetLen() != static_cast<int>(fRow.size())) return false;
+
+    tree->SetBranchAddress(weightBranchName, fRow.data());
+    fTree = tree;
+    return true;
+  }
+
+  void PrecomputedWeights::SetEntry(const size_t entry)
+  {
+    fTree->GetEntry(entry);
+  }
+
+  double PrecomputedWeights::GetWeight(const evt::Universe& univ, const PlotUtils::detail::empty& /*event*/) const
+  {
+    const auto found = fColumns.find(&univ);
+    if(found == fColumns.end()) throw std::runtime_error("PrecomputedWeights: asked for the weight of a universe named " + univ.ShortName() + " that wasn't set up with this job.");
+    return fRow[found->second];
+  }
+}
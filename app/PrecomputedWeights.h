@@ -0,0 +1,85 @@
+//File: PrecomputedWeights.h
+//Brief: Model and systematic universe weights only depend on the AnaTuples and the
+//       "model" and "systematics" configuration, so they're the same in every job that
+//       reads the same files.  PrecomputeWeights writes them once per AnaTuple file into
+//       friend TTrees indexed by entry number.  PrecomputedWeights is a Reweighter that
+//       reads them back instead of evaluating every Reweighter in every universe.
+//
+//       Weights are only trusted when the configuration hash and list of universes in
+//       the weight file match this job exactly.  Otherwise, the caller should fall back
+//       to evaluating the Model live.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef APP_PRECOMPUTEDWEIGHTS_H
+#define APP_PRECOMPUTEDWEIGHTS_H
+
+//PlotUtils includes
+#include "PlotUtils/Reweighter.h"
+
+//evt includes
+#include "evt/Universe.h"
+
+//c++ includes
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+
+class TFile;
+class TTree;
+
+namespace YAML
+{
+  class Node;
+}
+
+namespace app
+{
+  //Hash of every configuration parameter that changes a weight.  playlist matters because of the flux.
+  std::string weightConfigHash(const YAML::Node& config, const std::string& playlist);
+
+  //The name of each universe's column in a weight file, in the same order as they're stored
+  std::vector<std::pair<std::string, evt::Universe*>> weightColumns(const std::map<std::string, std::vector<evt::Universe*>>& universes);
+
+  //Name of the TDirectory that holds weights for an AnaTuple file.  Depends on its whole path, so
+  //PrecomputeWeights and ProcessAnaTuples have to be given the same file names.
+  std::string weightDirName(const std::string& tupleFileName);
+
+  //Names of the TTrees under weightDirName() and the objects at the top of a weight file
+  constexpr auto recoWeightTreeName = "RecoWeights";
+  constexpr auto truthWeightTreeName = "TruthWeights";
+  constexpr auto weightBranchName = "weights";
+  constexpr auto weightHashName = "WeightConfigHash";
+  constexpr auto weightColumnsName = "WeightColumns";
+
+  class PrecomputedWeights: public PlotUtils::Reweighter<evt::Universe>
+  {
+    public:
+      //Throws std::runtime_error if weightFileName can't be opened or if it was
+      //produced with a different configuration than configHash or universes.
+      PrecomputedWeights(const std::string& weightFileName, const std::string& configHash,
+                         const std::map<std::string, std::vector<evt::Universe*>>& universes);
+      virtual ~PrecomputedWeights();
+
+      //Point at weights for tupleFileName's reco or Truth tree.  Returns false if this
+      //file doesn't have weights for exactly nEntries entries in that tree.
+      bool SetTuple(const std::string& tupleFileName, const bool truthTree, const size_t nEntries);
+
+      //Load the weights for every universe at entry.  Call once per entry before GetWeight().
+      void SetEntry(const size_t entry);
+
+      double GetWeight(const evt::Universe& univ, const PlotUtils::detail::empty& /*event*/) const override;
+
+      std::string GetName() const override { return "PrecomputedWeights"; }
+      bool DependsReco() const override { return true; } //Each universe gets its own weight
+
+    private:
+      std::unique_ptr<TFile> fFile;
+      TTree* fTree; //Owned by fFile
+      std::unordered_map<const evt::Universe*, size_t> fColumns;
+      std::vector<float> fRow; //Weights for the current entry in every universe
+  };
+}
+
+#endif //APP_PRECOMPUTEDWEIGHTS_H
@@ -0,0 +1,132 @@
+//File: Sampling.cpp
+//Brief: Quick-look jobs only process a random fraction of their AnaTuples.  Sampling
+//       chooses which entries or files and how much to scale them up by.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/Sampling.h"
+#include "app/GetPlaylist.h"
+
+//util includes
+#include "util/Hash.h"
+
+//PlotUtils includes
+#include "PlotUtils/TreeWrapper.h"
+
+//YAML-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+
+//c++ includes
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <map>
+#include <memory>
+#include <cmath>
+
+namespace
+{
+  //POT from a file's Meta tree.  0 if it doesn't have one so that it doesn't count towards
+  //the POT a playlist's sampled files stand for.
+  double readPOT(const std::string& fileName)
+  {
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "READ"));
+    if(!file) return 0;
+
+    auto metaTree = dynamic_cast<TTree*>(file->Get("Meta"));
+    if(!metaTree) return 0;
+
+    return PlotUtils::TreeWrapper(metaTree).GetValue("POT_Used", 0);
+  }
+}
+
+namespace app
+{
+  Sampling::Sampling(const YAML::Node& config): fFraction(1), fByFiles(false), fSeed(0), fFileHash(0), fWeight(1), fPOTScale(1)
+  {
+    if(!config) return;
+
+    fFraction = config["fraction"].as<double>(1);
+    fSeed = config["seed"].as<uint64_t>(0);
+    if(!(fFraction > 0 && fFraction <= 1)) throw std::runtime_error("sample's fraction has to be more than 0 and no more than 1, but it's " + std::to_string(fFraction) + ".");
+
+    const auto by = config["by"].as<std::string>("entries");
+    if(by == "files") fByFiles = true;
+    else if(by != "entries") throw std::runtime_error("I can only sample by entries or files, not " + by + ".");
+  }
+
+  std::vector<std::string> Sampling::chooseFiles(const std::vector<std::string>& files, const bool isMC)
+  {
+    if(!enabled() || !fByFiles) return files;
+
+    //Stratify by playlist so that every run period is in the sample
+    std::map<std::string, std::vector<std::string>> byPlaylist;
+    for(const auto& fName: files)
+    {
+      try
+      {
+        byPlaylist[app::GetPlaylist(fName, isMC)].push_back(fName);
+      }
+      catch(const std::runtime_error& e)
+      {
+        std::cerr << e.what() << "\nLeaving this file out of the sample.\n";
+      }
+    }
+
+    std::vector<std::string> chosen;
+    std::mt19937_64 random(fSeed);
+    for(auto& playlist: byPlaylist)
+    {
+      auto& candidates = playlist.second;
+      std::sort(candidates.begin(), candidates.end()); //The same seed chooses the same files no matter what order they were listed in
+      std::shuffle(candidates.begin(), candidates.end(), random);
+      const size_t nChosen = std::max<size_t>(1, std::lround(fFraction * candidates.size()));
+
+      //The chosen files stand for all of this playlist's POT
+      double totalPOT = 0, chosenPOT = 0;
+      for(size_t whichFile = 0; whichFile < candidates.size(); ++whichFile)
+      {
+        const double pot = ::readPOT(candidates[whichFile]);
+        totalPOT += pot;
+        if(whichFile < nChosen) chosenPOT += pot;
+      }
+
+      for(size_t whichFile = 0; whichFile < nChosen; ++whichFile)
+      {
+        fPOTScales[candidates[whichFile]] = (chosenPOT > 0)?totalPOT / chosenPOT:1;
+        chosen.push_back(candidates[whichFile]);
+      }
+
+      std::cout << "Sampling " << nChosen << " of " << candidates.size() << " files from " << playlist.first << ".\n";
+    }
+
+    return chosen;
+  }
+
+  void Sampling::setFile(const std::string& fileName)
+  {
+    //Independent of where the file is stored
+    fFileHash = util::fnv1a(fileName.substr(fileName.rfind('/') + 1));
+
+    const auto found = fPOTScales.find(fileName);
+    fPOTScale = (found != fPOTScales.end())?found->second:1;
+    fWeight = fByFiles?fPOTScale:1. / fFraction;
+  }
+
+  bool Sampling::keep(const size_t entry, const bool truthTree) const
+  {
+    if(fByFiles || !enabled()) return true;
+
+    //splitmix64's finalizer so that neighbouring entries aren't correlated
+    uint64_t bits = fFileHash ^ (fSeed + 0x9e3779b97f4a7c15ull * (2 * entry + truthTree + 1));
+    bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ull;
+    bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebull;
+    bits ^= bits >> 31;
+
+    return (bits >> 11) / 9007199254740992. < fFraction; //Uniform in [0, 1) with 53 bits
+  }
+}
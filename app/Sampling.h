@@ -0,0 +1,90 @@
+//File: Sampling.h
+//Brief: Quick-look jobs only process a random fraction of their AnaTuples.  Sampling
+//       either keeps a random subset of entries from every file or a random subset of
+//       files from each playlist so that no run period is left out.  Weights and POT
+//       are scaled up so that histograms are normalized like the full sample's.
+//
+//       The same seed always chooses the same entries and files, so quick-look jobs
+//       can be compared to each other.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef APP_SAMPLING_H
+#define APP_SAMPLING_H
+
+//PlotUtils includes
+#include "PlotUtils/Reweighter.h"
+
+//evt includes
+#include "evt/Universe.h"
+
+//c++ includes
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace YAML
+{
+  class Node;
+}
+
+namespace app
+{
+  class Sampling
+  {
+    public:
+      //config is the "sample" block from "app".  Sampling is off when it's missing.
+      //Throws std::runtime_error if the fraction isn't between 0 and 1.
+      Sampling(const YAML::Node& config);
+
+      inline bool enabled() const { return fFraction < 1; }
+      inline bool byFiles() const { return fByFiles; }
+      inline double fraction() const { return fFraction; }
+
+      //A random subset of each playlist's files when sampling by files.  Remembers how much
+      //POT each chosen file stands for.  Otherwise, files are returned unchanged.
+      std::vector<std::string> chooseFiles(const std::vector<std::string>& files, const bool isMC);
+
+      //Call before reading each file
+      void setFile(const std::string& fileName);
+
+      //Whether to process entry from the current file's reco or Truth tree
+      bool keep(const size_t entry, const bool truthTree) const;
+
+      //Multiply every event weight by this to scale sampled entries up to the whole sample
+      inline double weight() const { return fWeight; }
+
+      //POT the current file stands for divided by its own POT
+      inline double potScale() const { return fPOTScale; }
+
+    private:
+      double fFraction; //1 means everything is processed
+      bool fByFiles; //Otherwise, sample entries
+      uint64_t fSeed;
+
+      std::unordered_map<std::string, double> fPOTScales; //For each file chooseFiles() picked
+
+      //Current file
+      uint64_t fFileHash;
+      double fWeight;
+      double fPOTScale;
+  };
+
+  //Puts Sampling::weight() into a Model along with the physics Reweighters
+  class SampleWeight: public PlotUtils::Reweighter<evt::Universe>
+  {
+    public:
+      SampleWeight(const Sampling& sampling): PlotUtils::Reweighter<evt::Universe>(), fSampling(sampling) {}
+      virtual ~SampleWeight() = default;
+
+      double GetWeight(const evt::Universe& /*univ*/, const PlotUtils::detail::empty& /*event*/) const override { return fSampling.weight(); }
+
+      std::string GetName() const override { return "SampleWeight"; }
+      bool DependsReco() const override { return false; }
+
+    private:
+      const Sampling& fSampling;
+  };
+}
+
+#endif //APP_SAMPLING_H
@@ -233,7 +233,8 @@ namespace app
     return backgrounds;
   }
 
-  std::vector<std::unique_ptr<PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>>> setupRecoCuts(const YAML::Node& config)
+  std::vector<std::unique_ptr<PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>>> setupRecoCuts(const YAML::Node& config,
+                                                                                                     reco::SharedCut::caches_t* shared)
   {
     std::vector<std::unique_ptr<PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>>> recoCuts;
     auto& cutFactory = plgn::Factory<reco::Cut, std::string&>::instance();
@@ -242,7 +243,13 @@ namespace app
       auto name = cut.first.as<std::string>();
       try
       {
-        recoCuts.emplace_back(cutFactory.Get(cut.second, name));
+        if(shared)
+        {
+          auto& cache = (*shared)[reco::SharedCut::configKey(cut.second)];
+          if(!cache) cache.reset(new reco::SharedCut::Cache(cutFactory.Get(cut.second, name)));
+          recoCuts.emplace_back(new reco::SharedCut(name, cache));
+        }
+        else recoCuts.emplace_back(cutFactory.Get(cut.second, name));
       }
       catch(const std::runtime_error& e)
       {
@@ -11,6 +11,9 @@
 //reweighters includes
 #include "PlotUtils/Reweighter.h"
 
+//cuts includes
+#include "cuts/reco/SharedCut.h"
+
 //PlotUtils includes
 #include "PlotUtils/Cut.h"
 
@@ -60,8 +63,11 @@ namespace app
   //by these Backgrounds' names.
   std::vector<std::unique_ptr<ana::Background>> setupBackgrounds(const YAML::Node& config);
 
-  //Set up reco::Cuts that define an event selection.
-  std::vector<std::unique_ptr<PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>>> setupRecoCuts(const YAML::Node& config);
+  //Set up reco::Cuts that define an event selection.  If shared is provided, each Cut is a
+  //reco::SharedCut that evaluates the same reco::Cut as any other Cut set up with the same
+  //configuration and shared.  Use that to avoid checking a Cut again for each Fiducial.
+  std::vector<std::unique_ptr<PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>>> setupRecoCuts(const YAML::Node& config,
+                                                                                                     reco::SharedCut::caches_t* shared = nullptr);
 
   //Set up truth::Cuts that make up a signal definition
   std::vector<std::unique_ptr<PlotUtils::SignalConstraint<evt::Universe>>> setupTruthConstraints(const YAML::Node& config);
@@ -19,6 +19,22 @@ namespace reco
     return (fabs(vertex.y()) < mm(fSlope*fabs(vertex.x().in<mm>()) + 2.*fApothem.in<mm>()/sqrt(3.)))
            && (fabs(vertex.x()) < fApothem);
   }
+
+  std::vector<Column> Apothem::columns() const
+  {
+    return {{"vtx", 0}, {"vtx", 1}};
+  }
+
+  void Apothem::evaluateBlock(const Columns& columns, std::vector<char>& mask) const
+  {
+    const auto& x = columns[{"vtx", 0}];
+    const auto& y = columns[{"vtx", 1}];
+    const double apothem = fApothem.in<mm>();
+    for(size_t entry = 0; entry < mask.size(); ++entry)
+    {
+      mask[entry] &= (fabs(y[entry]) < fSlope*fabs(x[entry]) + 2.*apothem/sqrt(3.)) && (fabs(x[entry]) < apothem);
+    }
+  }
 }
 
 namespace
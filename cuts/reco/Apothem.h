@@ -22,6 +22,10 @@ namespace reco
       Apothem(const YAML::Node& config, const std::string& name);
       virtual ~Apothem() = default;
 
+      //Check a block of CV entries at once
+      std::vector<Column> columns() const override;
+      void evaluateBlock(const Columns& columns, std::vector<char>& mask) const override;
+
     protected:
       //Your concrete Cut class must override these methods.
       virtual bool checkCut(const evt::Universe& event, PlotUtils::detail::empty& /*empty*/) const override;
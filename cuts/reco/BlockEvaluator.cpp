@@ -0,0 +1,56 @@
+//File: BlockEvaluator.cpp
+//Brief: A BlockEvaluator checks every SharedCut that implements reco::Cut::evaluateBlock()
+//       on a block of entries at once in the CV.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//cuts includes
+#include "cuts/reco/BlockEvaluator.h"
+
+//c++ includes
+#include <algorithm>
+
+namespace reco
+{
+  BlockEvaluator::BlockEvaluator(const SharedCut::caches_t& caches, const size_t blockSize): fTree(nullptr), fNEntries(0), fBlockSize(blockSize), fFirst(0)
+  {
+    if(fBlockSize == 0) return;
+
+    for(const auto& cache: caches)
+    {
+      const auto columns = cache.second->cut->columns();
+      if(columns.empty()) continue;
+
+      for(const auto& column: columns) fColumns.add(column);
+      fCaches.push_back(cache.second);
+    }
+    fMasks.resize(fCaches.size());
+  }
+
+  void BlockEvaluator::setTree(TTree& tree, const size_t nEntries)
+  {
+    fTree = &tree;
+    fNEntries = nEntries;
+    fFirst = nEntries; //Force reading a new block
+  }
+
+  void BlockEvaluator::setEntry(const size_t entry, const evt::Universe& cv)
+  {
+    if(empty()) return;
+
+    if(entry < fFirst || entry >= fFirst + fColumns.size())
+    {
+      fFirst = entry;
+      fColumns.read(*fTree, fFirst, std::min(fBlockSize, fNEntries - fFirst));
+      for(size_t whichCut = 0; whichCut < fCaches.size(); ++whichCut)
+      {
+        fMasks[whichCut].assign(fColumns.size(), 1);
+        fCaches[whichCut]->cut->evaluateBlock(fColumns, fMasks[whichCut]);
+      }
+    }
+
+    for(size_t whichCut = 0; whichCut < fCaches.size(); ++whichCut)
+    {
+      SharedCut::preset(*fCaches[whichCut], cv, fMasks[whichCut][entry - fFirst]);
+    }
+  }
+}
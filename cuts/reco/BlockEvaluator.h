@@ -0,0 +1,54 @@
+//File: BlockEvaluator.h
+//Brief: A BlockEvaluator checks every SharedCut that implements reco::Cut::evaluateBlock()
+//       on a block of entries at once in the CV.  It reads only the columns those Cuts
+//       need, runs each Cut as a tight loop over the block, and then hands each entry's
+//       result to the SharedCut caches.  Every Cutter still checks each entry so that cut
+//       tables stay the same, but columnar Cuts become lookups.  The other Cuts are only
+//       checked for entries that get that far in a Cutter.
+//
+//       Call setEntry() right after SharedCut::nextEvent() for every entry in order.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef RECO_BLOCKEVALUATOR_H
+#define RECO_BLOCKEVALUATOR_H
+
+//cuts includes
+#include "cuts/reco/SharedCut.h"
+#include "cuts/reco/Columns.h"
+
+//c++ includes
+#include <vector>
+#include <memory>
+
+class TTree;
+
+namespace reco
+{
+  class BlockEvaluator
+  {
+    public:
+      //A blockSize of 0 turns off block evaluation
+      BlockEvaluator(const SharedCut::caches_t& caches, const size_t blockSize);
+
+      //Start reading a new AnaTuple
+      void setTree(TTree& tree, const size_t nEntries);
+
+      //Preset SharedCut results for cv at entry.  Reads the next block if needed.
+      void setEntry(const size_t entry, const evt::Universe& cv);
+
+      //Whether any Cut can be checked in blocks
+      inline bool empty() const { return fCaches.empty(); }
+
+    private:
+      std::vector<std::shared_ptr<SharedCut::Cache>> fCaches; //Only Caches with columns()
+      std::vector<std::vector<char>> fMasks; //Results for each Cache in this block
+
+      Columns fColumns;
+      TTree* fTree;
+      size_t fNEntries;
+      size_t fBlockSize;
+      size_t fFirst; //First entry in this block
+  };
+}
+
+#endif //RECO_BLOCKEVALUATOR_H
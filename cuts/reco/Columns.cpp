@@ -0,0 +1,53 @@
+//File: Columns.cpp
+//Brief: Columns holds a few branches from a block of consecutive AnaTuple entries
+//       so that reco::Cuts can check a whole block at once.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//cuts includes
+#include "cuts/reco/Columns.h"
+
+//ROOT includes
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+
+//c++ includes
+#include <stdexcept>
+#include <limits>
+
+namespace reco
+{
+  void Columns::add(const Column& column)
+  {
+    fColumns[column];
+  }
+
+  //Only reads the branches that columns come from.  Reading a column's branch
+  //for other entries is OK because TreeWrapper reads a branch again whenever
+  //its GetReadEntry() isn't the entry a Universe asks for.
+  void Columns::read(TTree& tree, const size_t first, const size_t nEntries)
+  {
+    fSize = nEntries;
+    for(auto& column: fColumns)
+    {
+      auto leaf = tree.GetLeaf(column.first.first.c_str());
+      if(!leaf) throw std::runtime_error("Failed to find a branch named " + column.first.first + " for a Cut that checks blocks of entries in " + tree.GetName());
+      auto branch = leaf->GetBranch();
+
+      auto& values = column.second;
+      values.resize(nEntries);
+      for(size_t entry = 0; entry < nEntries; ++entry)
+      {
+        branch->GetEntry(first + entry);
+        values[entry] = (column.first.second < leaf->GetLen())?leaf->GetValue(column.first.second):std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+  }
+
+  const std::vector<double>& Columns::operator [](const Column& column) const
+  {
+    const auto found = fColumns.find(column);
+    if(found == fColumns.end()) throw std::runtime_error("Cut asked for index " + std::to_string(column.second) + " of branch " + column.first + ", but it didn't list that in columns()");
+    return found->second;
+  }
+}
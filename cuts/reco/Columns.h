@@ -0,0 +1,45 @@
+//File: Columns.h
+//Brief: Columns holds a few branches from a block of consecutive AnaTuple entries
+//       so that reco::Cuts can check a whole block at once in evaluateBlock().
+//       Each column is one index of one branch, like the z component of "vtx".
+//       Entries whose branch is too short for that index get NaN, which fails
+//       every comparison.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef RECO_COLUMNS_H
+#define RECO_COLUMNS_H
+
+//c++ includes
+#include <string>
+#include <vector>
+#include <map>
+
+class TTree;
+
+namespace reco
+{
+  //Name of a branch and which of its values to read
+  using Column = std::pair<std::string, int>;
+
+  class Columns
+  {
+    public:
+      //Read column for every block from now on
+      void add(const Column& column);
+
+      //Read entries [first, first + nEntries) of every column from tree
+      void read(TTree& tree, const size_t first, const size_t nEntries);
+
+      //Throws std::runtime_error if column was never add()ed
+      const std::vector<double>& operator [](const Column& column) const;
+
+      inline size_t size() const { return fSize; }
+      inline bool empty() const { return fColumns.empty(); }
+
+    private:
+      std::map<Column, std::vector<double>> fColumns;
+      size_t fSize = 0; //Entries in this block
+  };
+}
+
+#endif //RECO_COLUMNS_H
@@ -19,6 +19,9 @@
 //util includes
 #include "util/Factory.cpp"
 
+//cuts includes
+#include "cuts/reco/Columns.h"
+
 //PlotUtils includes
 #include "PlotUtils/Cut.h"
 
@@ -38,6 +41,17 @@ namespace reco
 
       //Adapter for old Cut interface
       std::string name() const { return getName(); }
+
+      //Evaluate this Cut without counting event in its cut table
+      inline bool checkWithoutStats(const evt::Universe& event, PlotUtils::detail::empty& evt) const { return checkCut(event, evt); }
+
+      //Optional interface for checking the CV in a block of entries at once.  Cuts that
+      //only read a few branches directly can list them in columns().  evaluateBlock() has
+      //to agree with checkCut() in the CV.  It sets mask[entry] to 0 for each entry in
+      //the block that fails.  Cuts that don't override columns() are always checked one
+      //entry at a time.
+      virtual std::vector<Column> columns() const { return {}; }
+      virtual void evaluateBlock(const Columns& /*columns*/, std::vector<char>& /*mask*/) const {}
   };
 }
 
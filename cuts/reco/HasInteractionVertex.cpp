@@ -15,6 +15,17 @@ namespace reco
   {
     return event.hasInteractionVertex();
   }
+
+  std::vector<Column> HasInteractionVertex::columns() const
+  {
+    return {{"has_interaction_vertex", 0}};
+  }
+
+  void HasInteractionVertex::evaluateBlock(const Columns& columns, std::vector<char>& mask) const
+  {
+    const auto& hasVertex = columns[{"has_interaction_vertex", 0}];
+    for(size_t entry = 0; entry < mask.size(); ++entry) mask[entry] &= (hasVertex[entry] != 0);
+  }
 }
 
 namespace
@@ -18,6 +18,18 @@ namespace reco
     const ns deltaT = event.GetMINOSTrackDeltaT();
     return deltaT > fMin && deltaT < fMax;
   }
+
+  std::vector<Column> MinosDeltaT::columns() const
+  {
+    return {{"minos_minerva_track_deltaT", 0}};
+  }
+
+  void MinosDeltaT::evaluateBlock(const Columns& columns, std::vector<char>& mask) const
+  {
+    const auto& deltaT = columns[{"minos_minerva_track_deltaT", 0}];
+    const double min = fMin.in<ns>(), max = fMax.in<ns>();
+    for(size_t entry = 0; entry < mask.size(); ++entry) mask[entry] &= (deltaT[entry] > min && deltaT[entry] < max);
+  }
 }
 
 namespace
@@ -0,0 +1,83 @@
+//File: SharedCut.h
+//Brief: A SharedCut lets every Fiducial's Cutter use the same reco::Cut without
+//       evaluating it more than once per entry and universe group.  Each Fiducial
+//       still gets its own SharedCut so that its cut table only counts its own events.
+//       SharedCuts made from the same YAML configuration share a Cache.  The event
+//       loop has to call SharedCut::nextEvent() every time universes move to a new
+//       entry or it moves on to a new universe group.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef RECO_SHAREDCUT_H
+#define RECO_SHAREDCUT_H
+
+//cut includes
+#include "cuts/reco/Cut.h"
+
+//c++ includes
+#include <memory>
+#include <map>
+#include <string>
+
+namespace reco
+{
+  class SharedCut: public Cut
+  {
+    public:
+      //The Cut that's really evaluated and its most recent result
+      struct Cache
+      {
+        Cache(std::unique_ptr<Cut>&& cut): cut(std::move(cut)), event(0), univ(nullptr), passed(false) {}
+
+        std::unique_ptr<Cut> cut;
+        unsigned long long event; //Value of nextEvent() when passed was evaluated
+        const evt::Universe* univ; //Universe passed was evaluated with
+        bool passed;
+      };
+
+      //One Cache per YAML configuration
+      using caches_t = std::map<std::string, std::shared_ptr<Cache>>;
+
+      SharedCut(const std::string& name, const std::shared_ptr<Cache>& cache): Cut(YAML::Node(), name), fCache(cache) {}
+      virtual ~SharedCut() = default;
+
+      //Forget every SharedCut's cached result
+      static inline void nextEvent() { ++currentEvent(); }
+
+      //Use passed as cache's result for univ until the next event.  For results
+      //that were already found by reco::Cut::evaluateBlock().
+      static inline void preset(Cache& cache, const evt::Universe& univ, const bool passed)
+      {
+        cache.event = currentEvent();
+        cache.univ = &univ;
+        cache.passed = passed;
+      }
+
+      //Key for caches_t.  Cuts with the same type and parameters always get the same result.
+      static inline std::string configKey(const YAML::Node& config) { return config.Tag() + "\n" + YAML::Dump(config); }
+
+    protected:
+      virtual bool checkCut(const evt::Universe& event, PlotUtils::detail::empty& evt) const override
+      {
+        if(fCache->event != currentEvent() || fCache->univ != &event)
+        {
+          fCache->passed = fCache->cut->checkWithoutStats(event, evt);
+          fCache->event = currentEvent();
+          fCache->univ = &event;
+        }
+
+        return fCache->passed;
+      }
+
+    private:
+      std::shared_ptr<Cache> fCache;
+
+      //Starts at 1 so that a new Cache is never up to date
+      static inline unsigned long long& currentEvent()
+      {
+        static unsigned long long event = 1;
+        return event;
+      }
+  };
+}
+
+#endif //RECO_SHAREDCUT_H
@@ -18,6 +18,18 @@ namespace reco
   {
     return event.GetVtx().z() > fZMin && event.GetVtx().z() < fZMax;
   }
+
+  std::vector<Column> IsInTarget::columns() const
+  {
+    return {{"vtx", 2}};
+  }
+
+  void IsInTarget::evaluateBlock(const Columns& columns, std::vector<char>& mask) const
+  {
+    const auto& z = columns[{"vtx", 2}];
+    const double min = fZMin.in<mm>(), max = fZMax.in<mm>();
+    for(size_t entry = 0; entry < mask.size(); ++entry) mask[entry] &= (z[entry] > min && z[entry] < max);
+  }
 }
 
 //Register IsInTarget as a kind of Cut
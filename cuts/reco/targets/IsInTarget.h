@@ -20,6 +20,14 @@ namespace reco
       IsInTarget(const YAML::Node& config, const std::string& name);
       virtual ~IsInTarget() = default;
 
+      //Vertex z range for routing events to Fiducials
+      inline mm zMin() const { return fZMin; }
+      inline mm zMax() const { return fZMax; }
+
+      //Check a block of CV entries at once
+      std::vector<Column> columns() const override;
+      void evaluateBlock(const Columns& columns, std::vector<char>& mask) const override;
+
     protected:
       virtual bool checkCut(const evt::Universe& event, PlotUtils::detail::empty& /*empty*/) const override;
 
@@ -19,6 +19,10 @@ namespace truth
       IsInTarget(const YAML::Node& config, const std::string& name);
       virtual ~IsInTarget() = default;
 
+      //Vertex z range for routing events to Fiducials
+      inline mm zMin() const { return fZMin; }
+      inline mm zMax() const { return fZMax; }
+
     protected:
       virtual bool passesCut(const evt::Universe& event) const override;
 
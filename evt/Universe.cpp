@@ -11,10 +11,17 @@
 #include "evt/Universe.h"
 #include "evt/EventID.h"
 
+//util includes
+#include "util/SetupCache.h"
+
 //ROOT GenVector includes
 #include "Math/AxisAngle.h"
 #include "Math/Vector3D.h"
 
+//c++ includes
+#include <sstream>
+#include <iomanip>
+
 //Convince PlotUtils::TreeWrapper that a quantity can be read from a POD type.
 //See Universe.h for a more detailed explanation.
 namespace PlotUtils
@@ -98,6 +105,11 @@ namespace evt
   }
 
   MnvH1D* Universe::GetFluxIntegral(PlotUtils::HistWrapper<Universe>& crossSectionHist, const GeV Emin, const GeV Emax) const
+  {
+    return GetFluxIntegral(*crossSectionHist.hist, Emin, Emax);
+  }
+
+  MnvH1D* Universe::GetFluxIntegral(PlotUtils::MnvH1D& crossSectionHist, const GeV Emin, const GeV Emax) const
   {
     bool useMuonCorrelations = true;
 
@@ -107,6 +119,22 @@ namespace evt
       useMuonCorrelations = false;
     }
 
-    return PlotUtils::flux_reweighter(GetPlaylist(), GetAnalysisNuPDG(), UseNuEConstraint(), GetNFluxUniverses()).GetIntegratedFluxReweighted(GetAnalysisNuPDG(), crossSectionHist.hist, Emin.in<GeV>(), Emax.in<GeV>(), useMuonCorrelations);
+    //The flux integral only depends on the flux configuration and crossSectionHist's binning and error bands.
+    //Its names and titles are copied from crossSectionHist too.
+    std::stringstream key;
+    key << std::setprecision(17) << "FluxIntegral\n" << util::SetupCache::libraryTag() << "\n" << GetPlaylist() << " " << GetAnalysisNuPDG() << " " << UseNuEConstraint() << " "
+        << GetNFluxUniverses() << " " << useMuonCorrelations << " " << Emin.in<GeV>() << " " << Emax.in<GeV>() << "\n";
+    const auto axis = crossSectionHist.GetXaxis();
+    key << crossSectionHist.GetName() << "\n" << crossSectionHist.GetTitle() << "\n" << axis->GetTitle() << "\n";
+    for(int whichEdge = 1; whichEdge <= axis->GetNbins() + 1; ++whichEdge) key << axis->GetBinLowEdge(whichEdge) << " ";
+    key << "\n";
+    for(const auto& name: crossSectionHist.GetVertErrorBandNames()) key << name << ":" << crossSectionHist.GetVertErrorBand(name)->GetNHists() << " ";
+    for(const auto& name: crossSectionHist.GetLatErrorBandNames()) key << name << ":" << crossSectionHist.GetLatErrorBand(name)->GetNHists() << " ";
+
+    if(auto cached = util::SetupCache::get<MnvH1D>(key.str())) return cached;
+
+    auto fluxIntegral = PlotUtils::flux_reweighter(GetPlaylist(), GetAnalysisNuPDG(), UseNuEConstraint(), GetNFluxUniverses()).GetIntegratedFluxReweighted(GetAnalysisNuPDG(), &crossSectionHist, Emin.in<GeV>(), Emax.in<GeV>(), useMuonCorrelations);
+    util::SetupCache::store(key.str(), *fluxIntegral);
+    return fluxIntegral;
   }
 }
@@ -23,6 +23,12 @@
 //c++ includes
 #include <numeric>
 
+namespace util
+{
+  template <class UNIV, class SUM>
+  class FlatHistWrapper;
+}
+
 namespace
 {
   template <class UNIT>
@@ -115,6 +121,11 @@ namespace evt
       inline static void SetBlobAlg(const std::string& newAlg) { blobAlg = newAlg; }
       inline void SetHypothesisName(const std::string& hypName) { fHypothesisName = hypName; }
 
+      //Universes that change truth information, like which FS particles there are,
+      //have to return true so that their signal and background categories aren't
+      //taken from the CV.
+      virtual bool ShiftsTruth() const { return false; }
+
       //MinervaUniverse interfaces
       //This is really used as "hypothesis name" for NeutrinoInt-based branches.
       virtual std::string GetAnaToolName() const override { return fHypothesisName; }
@@ -250,6 +261,16 @@ namespace evt
       //universes that do not vary the flux.  The flux integrals need to match the error bands and
       //binning of crossSectionHist.
       PlotUtils::MnvH1D* GetFluxIntegral(PlotUtils::HistWrapper<Universe>& crossSectionHist, const GeV Emin = 0_GeV, const GeV Emax = 100_GeV) const;
+      PlotUtils::MnvH1D* GetFluxIntegral(PlotUtils::MnvH1D& crossSectionHist, const GeV Emin = 0_GeV, const GeV Emax = 100_GeV) const;
+
+      //A FlatHistWrapper<> doesn't make its error bands until the end of the job, so give the flux
+      //reweighter an empty copy that has them.
+      template <class SUM>
+      PlotUtils::MnvH1D* GetFluxIntegral(util::FlatHistWrapper<Universe, SUM>& crossSectionHist, const GeV Emin = 0_GeV, const GeV Emax = 100_GeV) const
+      {
+        auto skeleton = crossSectionHist.Skeleton();
+        return GetFluxIntegral(*skeleton, Emin, Emax);
+      }
 
       //Unpack several related vector<> branches into an Analysis-specific struct called CAND.
       //One function to rule them all; one function to find them.
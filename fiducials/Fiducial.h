@@ -12,6 +12,7 @@
 #include "analyses/base/Background.h"
 #include "util/Factory.cpp"
 #include "evt/Universe.h"
+#include "fiducials/Regions.h"
 
 //c++ includes
 #include <vector>
@@ -47,8 +48,18 @@ namespace fid
       std::unique_ptr<ana::Study> study;
       std::unique_ptr<PlotUtils::Cutter<evt::Universe>> selection;
       std::unordered_map<std::bitset<64>, std::vector<std::unique_ptr<ana::Study>>> sidebands;
+      Regions regions; //Which of study and sidebands an event belongs in
       std::vector<std::unique_ptr<ana::Background>> backgrounds;
 
+      //Copies of study and sidebands that are filled with weights from another model
+      struct ModelStudies
+      {
+        std::unique_ptr<ana::Study> study;
+        std::unordered_map<std::bitset<64>, std::vector<std::unique_ptr<ana::Study>>> sidebands;
+        std::unordered_map<const ana::Study*, ana::Study*> byNominal; //Copy of each Study that regions can find
+      };
+      std::vector<ModelStudies> alternateModels; //In the order of the job's alternate models
+
       template <class DERIVED>
       using Registrar = plgn::Registrar<fid::Fiducial, DERIVED>;
   };
@@ -0,0 +1,112 @@
+//File: Regions.cpp
+//Brief: Regions decides which Study, the selection or one of the sidebands, an
+//       event belongs in for one Fiducial without hashing its cut pattern.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//fiducials includes
+#include "fiducials/Regions.h"
+
+//c++ includes
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+  std::unique_ptr<ana::Background> noBackground(nullptr);
+}
+
+namespace fid
+{
+  Regions::Regions(ana::Study& selection, sidebands_t& sidebands, const std::vector<cut_t*>& required,
+                   const std::vector<cut_t*>& sidebandCuts, const std::vector<std::unique_ptr<ana::Background>>& backgrounds)
+                  : fStudies{&selection}, fRequired(required), fSidebandCuts(sidebandCuts),
+                    fIfPassed(sidebandCuts.size(), 1), fIfFailed(sidebandCuts.size(), 0), fBackgrounds(&backgrounds)
+  {
+    if(sidebandCuts.size() > 64) throw std::runtime_error("Regions can only handle up to 64 sideband cuts, but got " + std::to_string(sidebandCuts.size()));
+
+    for(auto& pattern: sidebands)
+    {
+      for(auto& sideband: pattern.second)
+      {
+        if(fStudies.size() == 64) throw std::runtime_error("Regions can only handle up to 63 sidebands");
+
+        const mask_t bit = mask_t(1) << fStudies.size();
+        for(size_t whichCut = 0; whichCut < fSidebandCuts.size(); ++whichCut)
+        {
+          if(pattern.first.test(whichCut)) fIfPassed[whichCut] |= bit;
+          else fIfFailed[whichCut] |= bit;
+        }
+        fStudies.push_back(sideband.get());
+      }
+    }
+
+    fAll = (fStudies.size() == 64)?~mask_t(0):((mask_t(1) << fStudies.size()) - 1);
+  }
+
+  ana::Study* Regions::find(const evt::Universe& univ, PlotUtils::detail::empty& evt) const
+  {
+    for(const auto cut: fRequired)
+    {
+      if(!cut->passesCut(univ, evt)) return nullptr;
+    }
+
+    mask_t candidates = fAll;
+    for(size_t whichCut = 0; whichCut < fSidebandCuts.size() && candidates; ++whichCut)
+    {
+      candidates &= fSidebandCuts[whichCut]->passesCut(univ, evt)?fIfPassed[whichCut]:fIfFailed[whichCut];
+    }
+
+    return firstPassing(candidates, univ);
+  }
+
+  ana::Study* Regions::find(const std::bitset<64> passedCuts, const evt::Universe& univ) const
+  {
+    if(passedCuts.none()) return nullptr; //Failed a required cut
+
+    mask_t candidates = fAll;
+    for(size_t whichCut = 0; whichCut < fSidebandCuts.size() && candidates; ++whichCut)
+    {
+      candidates &= passedCuts.test(whichCut)?fIfPassed[whichCut]:fIfFailed[whichCut];
+    }
+
+    return firstPassing(candidates, univ);
+  }
+
+  const std::unique_ptr<ana::Background>& Regions::findBackground(const evt::Universe& univ) const
+  {
+    for(const auto& background: *fBackgrounds)
+    {
+      if(std::all_of(background->passes.begin(), background->passes.end(), [&univ](const auto& cut) { return cut->passes(univ); })) return background;
+    }
+
+    return noBackground;
+  }
+
+  Regions::Truth Regions::classify(const evt::Universe& univ, PlotUtils::Cutter<evt::Universe>& selection)
+  {
+    if(fTruthKnown && !univ.ShiftsTruth()) return fTruth;
+
+    Truth truth{selection.isSignal(univ), nullptr};
+    if(!truth.isSignal) truth.background = &findBackground(univ);
+
+    if(!univ.ShiftsTruth())
+    {
+      fTruth = truth;
+      fTruthKnown = true;
+    }
+
+    return truth;
+  }
+
+  //The selection needs no extra cuts, and sidebands with the same pattern are tried in order
+  ana::Study* Regions::firstPassing(mask_t candidates, const evt::Universe& univ) const
+  {
+    for(size_t whichStudy = 0; candidates; ++whichStudy, candidates >>= 1)
+    {
+      if((candidates & 1) && (whichStudy == 0 || fStudies[whichStudy]->passesCuts(univ))) return fStudies[whichStudy];
+    }
+
+    return nullptr;
+  }
+}
@@ -0,0 +1,89 @@
+//File: Regions.h
+//Brief: Regions decides which Study, the selection or one of the sidebands, an
+//       event belongs in for one Fiducial.  It's compiled once from the cuts a
+//       Cutter was given so that the event loop never hashes a cut pattern.  Each
+//       Study is a bit in a mask of candidates.  Checking a sideband cut removes every
+//       Study that needs the other outcome, and cuts stop being checked as soon as
+//       there are no candidates left.  Then, the first remaining Study whose own
+//       passesCuts() is true is the answer.
+//
+//       Regions also remembers whether the current entry is signal and which
+//       Background it is otherwise.  Truth information is the same in every universe
+//       unless it ShiftsTruth(), so that's only checked once per entry.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef FID_REGIONS_H
+#define FID_REGIONS_H
+
+//ana includes
+#include "analyses/base/Study.h"
+#include "analyses/base/Background.h"
+
+//PlotUtils includes
+#include "PlotUtils/Cut.h"
+#include "PlotUtils/Cutter.h"
+
+//c++ includes
+#include <vector>
+#include <unordered_map>
+#include <bitset>
+#include <memory>
+#include <cstdint>
+
+namespace fid
+{
+  class Regions
+  {
+    public:
+      using cut_t = PlotUtils::Cut<evt::Universe, PlotUtils::detail::empty>;
+      using sidebands_t = std::unordered_map<std::bitset<64>, std::vector<std::unique_ptr<ana::Study>>>;
+
+      Regions() = default;
+
+      //required are the reco cuts every Study needs to pass.  sidebandCuts are in the same
+      //order as the sideband Cutter bits that sidebands' keys were made from.
+      Regions(ana::Study& selection, sidebands_t& sidebands, const std::vector<cut_t*>& required,
+              const std::vector<cut_t*>& sidebandCuts, const std::vector<std::unique_ptr<ana::Background>>& backgrounds);
+
+      //Check cuts on univ without counting it in any cut table.  nullptr if univ isn't in any Study.
+      ana::Study* find(const evt::Universe& univ, PlotUtils::detail::empty& evt) const;
+
+      //Same answer from a Cutter that already checked its cuts to fill its cut table
+      ana::Study* find(const std::bitset<64> passedCuts, const evt::Universe& univ) const;
+
+      //First Background that univ passes.  Refers to a nullptr if none pass.
+      const std::unique_ptr<ana::Background>& findBackground(const evt::Universe& univ) const;
+
+      //Truth category of an event
+      struct Truth
+      {
+        bool isSignal;
+        const std::unique_ptr<ana::Background>* background; //Only looked up if not isSignal
+      };
+
+      //Whether univ is signal according to selection, and which Background it is otherwise.
+      //Reused for every universe until forgetTruth() unless univ.ShiftsTruth().
+      Truth classify(const evt::Universe& univ, PlotUtils::Cutter<evt::Universe>& selection);
+
+      //Call when universes move to a new entry
+      inline void forgetTruth() { fTruthKnown = false; }
+
+    private:
+      using mask_t = std::uint64_t;
+
+      std::vector<ana::Study*> fStudies; //Selection first, then sidebands in the order they were set up
+      std::vector<cut_t*> fRequired;
+      std::vector<cut_t*> fSidebandCuts;
+      std::vector<mask_t> fIfPassed; //For each sideband cut, the Studies that are still candidates if it passes
+      std::vector<mask_t> fIfFailed; //Studies that are still candidates if it fails
+      mask_t fAll; //Every Study
+      const std::vector<std::unique_ptr<ana::Background>>* fBackgrounds = nullptr;
+
+      Truth fTruth; //Of the current entry in universes that don't ShiftsTruth()
+      bool fTruthKnown = false;
+
+      ana::Study* firstPassing(mask_t candidates, const evt::Universe& univ) const;
+  };
+}
+
+#endif //FID_REGIONS_H
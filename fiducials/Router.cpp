@@ -0,0 +1,107 @@
+//File: Router.cpp
+//Brief: A Router finds the few Fiducials whose IsInTarget z range an event's
+//       vertex could be in.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//fiducials includes
+#include "fiducials/Router.h"
+#include "fiducials/Fiducial.h"
+
+//cuts includes
+#include "cuts/reco/targets/IsInTarget.h"
+#include "cuts/truth/targets/IsInTarget.h"
+
+//c++ includes
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  using range_t = std::pair<double, double>;
+
+  const range_t everywhere(std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest());
+
+  //Intersection of the z ranges of every IsInTarget in cuts
+  template <class IS_IN_TARGET, class CUT>
+  range_t zRange(const std::vector<CUT*>& cuts, range_t range)
+  {
+    for(const auto cut: cuts)
+    {
+      const auto target = dynamic_cast<const IS_IN_TARGET*>(cut);
+      if(target)
+      {
+        if(range == everywhere) range = range_t(target->zMin().template in<mm>(), target->zMax().template in<mm>());
+        else range = range_t(std::max(range.first, target->zMin().template in<mm>()), std::min(range.second, target->zMax().template in<mm>()));
+      }
+    }
+
+    return range;
+  }
+}
+
+namespace fid
+{
+  Router::Router(const std::vector<std::unique_ptr<Fiducial>>& fiducials, const bool useTruth)
+  {
+    std::vector<range_t> recoRanges, truthRanges;
+    for(const auto& fid: fiducials)
+    {
+      fAll.push_back(fAll.size());
+      recoRanges.push_back(::zRange<reco::IsInTarget>(fid->recoCuts, ::everywhere));
+
+      if(useTruth) truthRanges.push_back(::zRange<truth::IsInTarget>(fid->phaseSpace, ::zRange<truth::IsInTarget>(fid->signalDef, ::everywhere)));
+      else truthRanges.push_back(::everywhere);
+    }
+
+    fReco = build(recoRanges);
+    fTruth = build(truthRanges);
+  }
+
+  const std::vector<size_t>& Router::reco(const mm z) const
+  {
+    return fReco.find(z);
+  }
+
+  const std::vector<size_t>& Router::truth(const mm z) const
+  {
+    return fTruth.find(z);
+  }
+
+  const std::vector<size_t>& Router::Index::find(const mm z) const
+  {
+    const auto boundary = std::upper_bound(boundaries.begin(), boundaries.end(), z.in<mm>());
+    return candidates[std::distance(boundaries.begin(), boundary)];
+  }
+
+  //A Fiducial is a candidate between two boundaries if its range contains both of them.
+  //That's a few more candidates than IsInTarget accepts exactly at boundaries, but
+  //each Fiducial's own cuts still make the final decision.
+  Router::Index Router::build(const std::vector<range_t>& ranges)
+  {
+    Index index;
+    for(const auto& range: ranges)
+    {
+      if(range != ::everywhere)
+      {
+        index.boundaries.push_back(range.first);
+        index.boundaries.push_back(range.second);
+      }
+    }
+    std::sort(index.boundaries.begin(), index.boundaries.end());
+    index.boundaries.erase(std::unique(index.boundaries.begin(), index.boundaries.end()), index.boundaries.end());
+
+    index.candidates.resize(index.boundaries.size() + 1);
+    for(size_t whichFid = 0; whichFid < ranges.size(); ++whichFid)
+    {
+      const auto& range = ranges[whichFid];
+      for(size_t whichSection = 0; whichSection < index.candidates.size(); ++whichSection)
+      {
+        const bool inside = whichSection > 0 && whichSection < index.boundaries.size()
+                            && range.first <= index.boundaries[whichSection - 1] && index.boundaries[whichSection] <= range.second;
+        if(range == ::everywhere || inside) index.candidates[whichSection].push_back(whichFid);
+      }
+    }
+
+    return index;
+  }
+}
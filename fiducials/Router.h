@@ -0,0 +1,62 @@
+//File: Router.h
+//Brief: A Router finds the few Fiducials whose IsInTarget z range an event's
+//       vertex could be in.  It's built once from every Fiducial's reco and truth
+//       IsInTarget cuts so that the event loop can skip universe work for Fiducials
+//       an event can't possibly enter.  ThreeSectionTarget and TwoSectionTarget only
+//       split a target transversely, so IsInTarget is the only cut that sets z ranges.
+//       Fiducials without an IsInTarget cut are candidates for every vertex.
+//
+//       Routing uses the CV's vertex.  No systematic universe shifts vertex z.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef FID_ROUTER_H
+#define FID_ROUTER_H
+
+//util includes
+#include "util/units.h"
+
+//c++ includes
+#include <vector>
+#include <memory>
+
+namespace fid
+{
+  class Fiducial;
+
+  class Router
+  {
+    public:
+      Router() = default;
+
+      //useTruth is false when truth cuts are overridden so that every Fiducial gets every truth entry
+      Router(const std::vector<std::unique_ptr<Fiducial>>& fiducials, const bool useTruth);
+
+      //Indices of Fiducials whose reco cuts a vertex at z might pass
+      const std::vector<size_t>& reco(const mm z) const;
+
+      //Indices of Fiducials whose truth cuts a vertex at z might pass
+      const std::vector<size_t>& truth(const mm z) const;
+
+      //Index of every Fiducial
+      inline const std::vector<size_t>& all() const { return fAll; }
+
+    private:
+      //Sorted z boundaries between which the same Fiducials are candidates
+      struct Index
+      {
+        std::vector<double> boundaries; //In mm
+        std::vector<std::vector<size_t>> candidates; //One more than boundaries.  The first and last are outside every boundary.
+
+        const std::vector<size_t>& find(const mm z) const;
+      };
+
+      Index fReco;
+      Index fTruth;
+      std::vector<size_t> fAll;
+
+      //Fiducials without an IsInTarget have a range from the largest double to the lowest
+      static Index build(const std::vector<std::pair<double, double>>& ranges);
+  };
+}
+
+#endif //FID_ROUTER_H
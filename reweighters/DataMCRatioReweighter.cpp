@@ -20,33 +20,22 @@
 //util includes
 #include "util/Factory.cpp"
 #include "util/units.h"
+#include "util/FlatHistLookup.h"
+#include "util/BatchModel.h"
 
 //evt includes
 #include "evt/Universe.h"
 
 //c++ includes
 #include <memory>
+#include <vector>
 
 template <class UNIVERSE, class EVENT = PlotUtils::detail::empty>
-class DataMCRatioReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
+class DataMCRatioReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>, public util::BatchReweighter<UNIVERSE, EVENT>
 {
   public:
-    DataMCRatioReweighter(const YAML::Node& config): PlotUtils::Reweighter<UNIVERSE, EVENT>(), fVar(config["variable"])
+    DataMCRatioReweighter(const YAML::Node& config): PlotUtils::Reweighter<UNIVERSE, EVENT>(), fVar(config["variable"]), fWeights(loadRatio(config))
     {
-      constexpr auto histName = "backgroundSubtracted";
-
-      const auto dataFileName = config["dataFile"].as<std::string>();
-      std::unique_ptr<TFile> dataFile(TFile::Open(dataFileName.c_str()));
-      if(!dataFile) throw std::runtime_error("Failed to open a data file at " + dataFileName + " for data/MC reweight.");
-      if(!dynamic_cast<PlotUtils::MnvH1D*>(dataFile->Get(histName))) throw std::runtime_error("Failed to find a histogram named backgroundSubtracted in " + dataFileName);
-
-      const auto mcFileName = config["mcFile"].as<std::string>();
-      std::unique_ptr<TFile> mcFile(TFile::Open(mcFileName.c_str()));
-      if(!mcFile) throw std::runtime_error("Failed to open an MC file at " + mcFileName + " for data/MC reweight.");
-      if(!dynamic_cast<PlotUtils::MnvH1D*>(mcFile->Get(histName))) throw std::runtime_error("Failed to find a histogram named backgroundSubtracted in " + mcFileName);
-
-      fWeightHist.reset(dynamic_cast<PlotUtils::MnvH1D*>(dataFile->Get(histName))->Clone());
-      fWeightHist->Divide(fWeightHist.get(), dynamic_cast<PlotUtils::MnvH1D*>(mcFile->Get(histName)));
     }
 
     virtual ~DataMCRatioReweighter() = default;
@@ -54,7 +43,17 @@ class DataMCRatioReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
     double GetWeight(const UNIVERSE& univ, const EVENT& /*event*/) const override
     {
       if(univ.IsTruth()) return 1; //Just like the MINOS reweighter, I can't run this reweighter on the Truth tree because it uses a reco variable.
-      return fWeightHist->GetBinContent(fWeightHist->FindBin(fVar.reco(univ).template in<GeV>()));
+      return fWeights.Lookup(fVar.reco(univ).template in<GeV>());
+    }
+
+    //Look up weights for the CV and all of its shifted universes at once.  Each universe
+    //can still shift the muon, so fVar has to be recalculated for each of them.
+    void GetWeights(const std::vector<UNIVERSE*>& univs, const EVENT& /*event*/, std::vector<double>& weights) const override
+    {
+      weights.assign(univs.size(), 1.);
+      if(univs.empty() || univs.front()->IsTruth()) return;
+
+      for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) weights[whichUniv] = fWeights.Lookup(fVar.reco(*univs[whichUniv]).template in<GeV>());
     }
 
     std::string GetName() const override { return "DataMCRatio"; }
@@ -62,7 +61,26 @@ class DataMCRatioReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
 
   private:
     ana::MuonPT fVar; //It would be easy to change this out with one of my other "calculators" if someone needed to
-    std::unique_ptr<TH1D> fWeightHist; //Ratio of background-subtracted data to background-subtracted MC
+    util::FlatHist1D fWeights; //Ratio of background-subtracted data to background-subtracted MC
+
+    static util::FlatHist1D loadRatio(const YAML::Node& config)
+    {
+      constexpr auto histName = "backgroundSubtracted";
+
+      const auto dataFileName = config["dataFile"].as<std::string>();
+      std::unique_ptr<TFile> dataFile(TFile::Open(dataFileName.c_str()));
+      if(!dataFile) throw std::runtime_error("Failed to open a data file at " + dataFileName + " for data/MC reweight.");
+      if(!dynamic_cast<PlotUtils::MnvH1D*>(dataFile->Get(histName))) throw std::runtime_error("Failed to find a histogram named backgroundSubtracted in " + dataFileName);
+
+      const auto mcFileName = config["mcFile"].as<std::string>();
+      std::unique_ptr<TFile> mcFile(TFile::Open(mcFileName.c_str()));
+      if(!mcFile) throw std::runtime_error("Failed to open an MC file at " + mcFileName + " for data/MC reweight.");
+      if(!dynamic_cast<PlotUtils::MnvH1D*>(mcFile->Get(histName))) throw std::runtime_error("Failed to find a histogram named backgroundSubtracted in " + mcFileName);
+
+      std::unique_ptr<TH1D> ratio(dynamic_cast<PlotUtils::MnvH1D*>(dataFile->Get(histName))->Clone());
+      ratio->Divide(ratio.get(), dynamic_cast<PlotUtils::MnvH1D*>(mcFile->Get(histName)));
+      return util::FlatHist1D(*ratio);
+    }
 };
 
 namespace
@@ -17,15 +17,18 @@
 //util includes
 #include "util/Factory.cpp"
 #include "util/units.h"
+#include "util/FlatHistLookup.h"
+#include "util/BatchModel.h"
 
 //evt includes
 #include "evt/Universe.h"
 
 //c++ includes
 #include <memory>
+#include <vector>
 
 template <class UNIVERSE, class EVENT = PlotUtils::detail::empty>
-class NuWroSFReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
+class NuWroSFReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>, public util::BatchReweighter<UNIVERSE, EVENT>
 {
   public:
     struct EventRecordParticle
@@ -36,17 +39,8 @@ class NuWroSFReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
       int LD;
     };
 
-    NuWroSFReweighter(const YAML::Node& /*config*/): PlotUtils::Reweighter<UNIVERSE, EVENT>()
+    NuWroSFReweighter(const YAML::Node& /*config*/): PlotUtils::Reweighter<UNIVERSE, EVENT>(), fWeights(loadWeights())
     {
-      //TODO: If you need to change the reweight file name often for debugging,
-      //      make it a parameter that optionally comes from config.
-      const char* mParamLocation = std::getenv("MPARAMFILESROOT");
-      if(!mParamLocation) throw std::runtime_error("MPARAMFILESROOT needs to be set to use NuWroSFReweighter, but it's not set.");
-
-      std::unique_ptr<TFile> nuWroReweightFile(TFile::Open((std::string(mParamLocation) + "/data/Reweight/q0q3ProtonWeight.root").c_str()));
-      if(!nuWroReweightFile) throw std::runtime_error("Failed to find a file at MPARAMFILESROOT/data/Reweight/q0q3ProtonWeight.root"); //TODO: Doesn't ROOT print a warning about this automatically?
-
-      fWeightHist = dynamic_cast<TH2D*>(nuWroReweightFile->Get("nuwroSF_mnvGENIEv2_qsq_kF_qelike_qe_oth_ratio")->Clone());
     }
 
     virtual ~NuWroSFReweighter() = default;
@@ -76,17 +70,40 @@ class NuWroSFReweighter: public PlotUtils::Reweighter<UNIVERSE, EVENT>
 
       const auto qSq = units::sqrt(-(neutrino - lepton).m2());
       const auto kf = initNuc.p().mag();
-      const int qSqBin = fWeightHist->GetXaxis()->FindBin(qSq.in<GeV>()),
-                kfBin = fWeightHist->GetYaxis()->FindBin(kf.in<GeV>());
-      if(qSqBin > fWeightHist->GetNbinsX() || kfBin > fWeightHist->GetNbinsY()) return 1;
-      return fWeightHist->GetBinContent(qSqBin, kfBin);
+      const int qSqBin = fWeights.GetXaxis().FindBin(qSq.in<GeV>()),
+                kfBin = fWeights.GetYaxis().FindBin(kf.in<GeV>());
+      if(qSqBin > fWeights.GetXaxis().GetNbins() || kfBin > fWeights.GetYaxis().GetNbins()) return 1;
+      return fWeights.GetBinContent(qSqBin, kfBin);
+    }
+
+    //This weight only depends on truth branches that no systematic universe shifts, so
+    //look it up once for the CV and give the same answer to every universe in univs.
+    void GetWeights(const std::vector<UNIVERSE*>& univs, const EVENT& event, std::vector<double>& weights) const override
+    {
+      weights.assign(univs.size(), univs.empty()?1.:GetWeight(*univs.front(), event));
     }
 
     std::string GetName() const override { return "NuWroSF"; }
     bool DependsReco() const override { return false; }
 
   private:
-    TH2D* fWeightHist; //Contains reweight values produced by Tejin with dedicated NuWro and GENIE generator samples using NUISSANCE
+    util::FlatHist2D fWeights; //Contains reweight values produced by Tejin with dedicated NuWro and GENIE generator samples using NUISSANCE
+
+    static util::FlatHist2D loadWeights()
+    {
+      //TODO: If you need to change the reweight file name often for debugging,
+      //      make it a parameter that optionally comes from config.
+      const char* mParamLocation = std::getenv("MPARAMFILESROOT");
+      if(!mParamLocation) throw std::runtime_error("MPARAMFILESROOT needs to be set to use NuWroSFReweighter, but it's not set.");
+
+      std::unique_ptr<TFile> nuWroReweightFile(TFile::Open((std::string(mParamLocation) + "/data/Reweight/q0q3ProtonWeight.root").c_str()));
+      if(!nuWroReweightFile) throw std::runtime_error("Failed to find a file at MPARAMFILESROOT/data/Reweight/q0q3ProtonWeight.root"); //TODO: Doesn't ROOT print a warning about this automatically?
+
+      const auto weightHist = dynamic_cast<TH2D*>(nuWroReweightFile->Get("nuwroSF_mnvGENIEv2_qsq_kF_qelike_qe_oth_ratio"));
+      if(!weightHist) throw std::runtime_error("Failed to find a TH2D named nuwroSF_mnvGENIEv2_qsq_kF_qelike_qe_oth_ratio in MPARAMFILESROOT/data/Reweight/q0q3ProtonWeight.root");
+
+      return util::FlatHist2D(*weightHist);
+    }
 };
 
 namespace
@@ -0,0 +1,43 @@
+#treeThroughput.py: Times reading every TTree in a file to compare output formats like PerCandidateTree's default and columnar options.
+#                   Reads every branch, then only the branches named on the command line like an analysis that only needs a few columns.
+#                   Also prints how well each TTree was compressed.
+#Usage: treeThroughput.py <file.root> [branchesToRead]...
+
+import sys
+import time
+import ROOT
+
+if len(sys.argv) < 2:
+  print "treeThroughput.py <file.root> [branchesToRead]..."
+  print "Times reading every TTree in file.root.  Reads every branch, then only branchesToRead if there are any."
+  sys.exit(1)
+
+inFile = ROOT.TFile.Open(sys.argv[1])
+branchesToRead = sys.argv[2:]
+MB = 1024. * 1024.
+
+#Returns entries per second and uncompressed MB per second
+def timeRead(tree):
+  start = time.time()
+  nBytes = 0
+  for entry in range(tree.GetEntries()):
+    nBytes += tree.GetEntry(entry)
+  elapsed = max(time.time() - start, 1e-9)
+  return tree.GetEntries() / elapsed, nBytes / MB / elapsed
+
+for key in inFile.GetListOfKeys():
+  if not key.GetClassName() == "TTree":
+    continue
+
+  tree = key.ReadObj()
+  print tree.GetName() + ": " + str(tree.GetEntries()) + " entries, " + str(tree.GetZipBytes() / MB) + " MB on disk, " + str(tree.GetTotBytes() / MB) + " MB uncompressed"
+
+  entriesPerSec, MBPerSec = timeRead(tree)
+  print "  Every branch: " + str(entriesPerSec) + " entries/s, " + str(MBPerSec) + " MB/s"
+
+  if branchesToRead:
+    tree.SetBranchStatus("*", 0)
+    for branch in branchesToRead:
+      tree.SetBranchStatus(branch, 1)
+    entriesPerSec, MBPerSec = timeRead(tree)
+    print "  " + " ".join(branchesToRead) + ": " + str(entriesPerSec) + " entries/s, " + str(MBPerSec) + " MB/s"
@@ -11,6 +11,7 @@
 
 //c++ includes
 #include <iostream>
+#include <fstream>
 
 #define USAGE "USAGE: makeGeneralizedBirksTable <dEdxTable.txt> <start> <end> <nSteps> [Cvalue] [kBValue]\n\n"\
               "dEdxTable.txt shall be a plaintext file with 2 space-separated columns:\n"\
@@ -41,6 +41,12 @@ namespace sys
         return "Drop GENIE Neutrons";
       }
 
+      //Dropped FS neutrons change whether an event is signal
+      bool ShiftsTruth() const override
+      {
+        return true;
+      }
+
     private:
       void OnNewEntry() override
       {
@@ -12,9 +12,17 @@
 //util includes
 #include "util/Factory.cpp"
 #include "util/Interpolation.h"
+#include "util/UniformInterpolation.h"
+#include "util/Hash.h"
 
 //c++ includes
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+//POSIX includes
+#include <unistd.h>
 
 namespace
 {
@@ -32,12 +40,55 @@ namespace sys
       {
         //Pre-load all PDG codes of interest here
         const std::vector<int> pdgsToLoad = {2212, 11, 1000020040};
+        const std::string tableDir = config["tableDir"].as<std::string>(INSTALL_DIR "etc") + "/";
 
         for(const int pdg: pdgsToLoad)
         {
-          std::ifstream birksFile("birksRatios_" + std::to_string(pdg) + ".txt");
-          if(birksFile) fPDGToBirksShift[pdg] = util::Interpolation(birksFile);
-          else std::cerr << "GeneralizedBirksLaw: Failed to find a file of Birks' Law ratios for PDG code " << pdg << ".  Using a constant 1.\n";
+          const std::string baseName = tableDir + "birksRatios_" + std::to_string(pdg);
+
+          std::ifstream birksFile(baseName + ".txt");
+          if(birksFile)
+          {
+            //Name the resampled table after the text table's contents so an edited table is never shadowed by an old cache
+            std::stringstream text;
+            text << birksFile.rdbuf();
+            const std::string cacheName = baseName + "." + util::toHex(util::fnv1a(text.str())) + ".bin";
+
+            //Prefer a table that's already been resampled onto a uniform grid
+            std::ifstream binaryFile(cacheName, std::ios::binary);
+            if(binaryFile)
+            {
+              try
+              {
+                fPDGToBirksShift.emplace_back(pdg, util::UniformInterpolation(binaryFile));
+                continue;
+              }
+              catch(const std::exception& e) //A truncated table could even claim more values than fit in memory
+              {
+                std::cerr << "GeneralizedBirksLaw: Ignoring " << cacheName << " because I couldn't read it:\n" << e.what() << "\n";
+              }
+            }
+
+            const util::Interpolation original(text);
+            fPDGToBirksShift.emplace_back(pdg, util::UniformInterpolation(original, original.size()));
+
+            //Cache the resampled table for next time.  It's OK if tableDir isn't writable.
+            //Write somewhere else first so that other jobs sharing tableDir never read a partial table.
+            char hostName[256] = "";
+            ::gethostname(hostName, sizeof(hostName) - 1);
+            const std::string tempName = cacheName + "." + hostName + "." + std::to_string(::getpid()) + ".tmp";
+            bool written = false;
+            {
+              std::ofstream cache(tempName, std::ios::binary);
+              if(cache)
+              {
+                fPDGToBirksShift.back().second.write(cache);
+                written = static_cast<bool>(cache);
+              }
+            }
+            if(!written || std::rename(tempName.c_str(), cacheName.c_str())) std::remove(tempName.c_str());
+          }
+          else std::cerr << "GeneralizedBirksLaw: Failed to find a file of Birks' Law ratios for PDG code " << pdg << " in " << tableDir << ".  Using a constant 1.\n";
         }
       }
 
@@ -73,7 +124,7 @@ namespace sys
           for(int whichCause = nextCause; whichCause < nextCause + cand.nCauses; ++whichCause)
           {
             const auto& cause = causes[whichCause];
-            const double birksShift = fPDGToBirksShift[cause.pdgCode][cause.energy.in<MeV>()];
+            const double birksShift = shiftFor(cause.pdgCode, cause.energy.in<MeV>());
             //std::cout << "For particle with PDG code " << cause.pdgCode << " and energy " << cause.energy << ", Birks' Law changed by a factor of " << birksShift << "\n";
             energyScaleFactor += birksShift * cause.energy.in<MeV>();
             totalCauseEnergy += cause.energy;
@@ -103,7 +154,17 @@ namespace sys
       }
 
     private:
-      mutable std::map<int, util::Interpolation> fPDGToBirksShift; //Has to be mutable so I can default to an empty Interpolation that just returns 1 for unhandled PDG codes.
+      //Only a handful of PDG codes, so a linear search beats a map here
+      std::vector<std::pair<int, util::UniformInterpolation>> fPDGToBirksShift;
+
+      //Unhandled PDG codes aren't shifted at all
+      inline double shiftFor(const int pdg, const double energyInMeV) const
+      {
+        const auto found = std::find_if(fPDGToBirksShift.begin(), fPDGToBirksShift.end(),
+                                        [pdg](const auto& table) { return table.first == pdg; });
+        if(found == fPDGToBirksShift.end()) return 1;
+        return found->second[energyInMeV];
+      }
   };
 }
 
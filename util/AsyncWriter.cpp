@@ -0,0 +1,116 @@
+//File: AsyncWriter.cpp
+//Brief: An AsyncWriter runs output work like TTree::Fill() and TObject::Write() on a
+//       background thread with a bounded queue.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/AsyncWriter.h"
+
+//ROOT includes
+#include "RVersion.h"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 0, 0)
+  #include "TROOT.h"
+  #define ASYNCWRITER_HAS_THREADS
+#endif
+
+namespace util
+{
+  AsyncWriter::AsyncWriter(const size_t capacity): fCapacity(capacity), fBusy(false), fStop(false)
+  {
+    #ifdef ASYNCWRITER_HAS_THREADS
+      if(fCapacity > 0)
+      {
+        //TFile and gDirectory have to know that more than one thread uses them
+        ROOT::EnableThreadSafety();
+        fThread = std::thread(&AsyncWriter::run, this);
+      }
+    #else
+      fCapacity = 0;
+    #endif
+  }
+
+  AsyncWriter::~AsyncWriter()
+  {
+    if(!isAsync()) return;
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fHasTasks.notify_one();
+    fThread.join();
+  }
+
+  void AsyncWriter::push(std::function<void()>&& task)
+  {
+    if(!isAsync())
+    {
+      task();
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fHasSpace.wait(lock, [this] { return fTasks.size() < fCapacity || fError; });
+      rethrow();
+      fTasks.push_back(std::move(task));
+    }
+    fHasTasks.notify_one();
+  }
+
+  void AsyncWriter::drain()
+  {
+    if(!isAsync()) return;
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fHasSpace.wait(lock, [this] { return (fTasks.empty() && !fBusy) || fError; });
+    rethrow();
+  }
+
+  AsyncWriter& AsyncWriter::synchronous()
+  {
+    static AsyncWriter writer(0);
+    return writer;
+  }
+
+  void AsyncWriter::run()
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    while(true)
+    {
+      fHasTasks.wait(lock, [this] { return !fTasks.empty() || fStop; });
+      if(fTasks.empty()) return; //Only stop after every task is done
+
+      auto task = std::move(fTasks.front());
+      fTasks.pop_front();
+      fBusy = true;
+      lock.unlock();
+      fHasSpace.notify_all();
+
+      try
+      {
+        task();
+      }
+      catch(...)
+      {
+        lock.lock();
+        if(!fError) fError = std::current_exception();
+        lock.unlock();
+      }
+
+      lock.lock();
+      fBusy = false;
+      if(fTasks.empty() || fError) fHasSpace.notify_all();
+    }
+  }
+
+  void AsyncWriter::rethrow()
+  {
+    if(fError)
+    {
+      auto error = fError;
+      fError = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+//File: AsyncWriter.h
+//Brief: An AsyncWriter runs output work like TTree::Fill() and TObject::Write() on a
+//       background thread so that ROOT can compress baskets and histograms while the
+//       event loop keeps going.  Tasks run in the order they were push()ed.  The queue
+//       holds at most a fixed number of tasks, and push() only waits when it's full.
+//
+//       An AsyncWriter with a capacity of 0, like synchronous(), just runs each task
+//       as soon as it's push()ed.  So do builds whose ROOT can't use threads.
+//
+//       Anything a task touches must only be touched by tasks until drain() returns.
+//       An exception thrown by a task is rethrown by the next push() or drain().
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_ASYNCWRITER_H
+#define UTIL_ASYNCWRITER_H
+
+//c++ includes
+#include <functional>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace util
+{
+  class AsyncWriter
+  {
+    public:
+      AsyncWriter(const size_t capacity);
+      ~AsyncWriter(); //Finishes every task
+
+      AsyncWriter(const AsyncWriter&) = delete;
+      AsyncWriter& operator =(const AsyncWriter&) = delete;
+
+      //Run task on the writer thread.  Waits for space if the queue is full.
+      void push(std::function<void()>&& task);
+
+      //Wait for every task to finish
+      void drain();
+
+      //Whether tasks really run on another thread
+      inline bool isAsync() const { return fThread.joinable(); }
+
+      //Runs every task right away
+      static AsyncWriter& synchronous();
+
+    private:
+      size_t fCapacity;
+      std::deque<std::function<void()>> fTasks;
+      bool fBusy; //Is the writer thread running a task right now?
+      bool fStop;
+      std::exception_ptr fError; //First exception thrown by a task
+
+      std::mutex fMutex;
+      std::condition_variable fHasTasks;
+      std::condition_variable fHasSpace; //Also notified when the queue is empty
+      std::thread fThread;
+
+      void run(); //Body of the writer thread
+      void rethrow(); //Call with fMutex locked
+  };
+}
+
+#endif //UTIL_ASYNCWRITER_H
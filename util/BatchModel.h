@@ -0,0 +1,103 @@
+//File: BatchModel.h
+//Brief: PlotUtils::Model only knows how to weight one universe at a time.  Some Reweighters
+//       can weight a whole group of compatible universes faster than that, for example by
+//       looking up a weight only once when no universe in the group changes it.  Those Reweighters
+//       implement BatchReweighter.  A BatchModel is a PlotUtils::Model that remembers which of
+//       its Reweighters can do that so that histograms filled from many universes at once can
+//       ask for all of their weights with getWeights().
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_BATCHMODEL_H
+#define UTIL_BATCHMODEL_H
+
+//PlotUtils includes
+#include "PlotUtils/Model.h"
+#include "PlotUtils/Reweighter.h"
+
+//c++ includes
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+namespace util
+{
+  template <class UNIVERSE, class EVENT = PlotUtils::detail::empty>
+  class BatchReweighter
+  {
+    public:
+      virtual ~BatchReweighter() = default;
+
+      //Same answers as GetWeight() for each universe in univs.  weights is resized to match univs.
+      virtual void GetWeights(const std::vector<UNIVERSE*>& univs, const EVENT& event, std::vector<double>& weights) const = 0;
+  };
+
+  template <class UNIVERSE, class EVENT = PlotUtils::detail::empty>
+  class BatchModel: public PlotUtils::Model<UNIVERSE, EVENT>
+  {
+    public:
+      using reweighters_t = std::vector<std::unique_ptr<PlotUtils::Reweighter<UNIVERSE, EVENT>>>;
+
+      BatchModel(reweighters_t&& reweighters): BatchModel(observe(reweighters), std::move(reweighters))
+      {
+      }
+
+      virtual ~BatchModel() = default;
+
+      //Same answers as GetWeight() for each universe in univs.  Multiplies Reweighters together in the
+      //same order as PlotUtils::Model does.  weights is resized to match univs.
+      void GetWeights(const std::vector<UNIVERSE*>& univs, const EVENT& event, std::vector<double>& weights) const
+      {
+        thread_local std::vector<double> batchWeights; //So that GetWeights() doesn't allocate for every event
+
+        weights.assign(univs.size(), 1.);
+        for(const auto reweighter: fReweighters)
+        {
+          const auto batch = dynamic_cast<const BatchReweighter<UNIVERSE, EVENT>*>(reweighter);
+          if(batch)
+          {
+            batch->GetWeights(univs, event, batchWeights);
+            for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) weights[whichUniv] *= batchWeights[whichUniv];
+          }
+          else
+          {
+            for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) weights[whichUniv] *= reweighter->GetWeight(*univs[whichUniv], event);
+          }
+        }
+      }
+
+    private:
+      //Owned by the PlotUtils::Model I derive from
+      std::vector<const PlotUtils::Reweighter<UNIVERSE, EVENT>*> fReweighters;
+
+      BatchModel(std::vector<const PlotUtils::Reweighter<UNIVERSE, EVENT>*>&& observed, reweighters_t&& reweighters): PlotUtils::Model<UNIVERSE, EVENT>(std::move(reweighters)),
+                                                                                                                   fReweighters(std::move(observed))
+      {
+      }
+
+      static std::vector<const PlotUtils::Reweighter<UNIVERSE, EVENT>*> observe(const reweighters_t& reweighters)
+      {
+        std::vector<const PlotUtils::Reweighter<UNIVERSE, EVENT>*> observed;
+        for(const auto& reweighter: reweighters) observed.push_back(reweighter.get());
+        return observed;
+      }
+  };
+
+  //Weights for every universe in univs.  Uses model's BatchReweighters if it's a BatchModel.
+  //Otherwise, asks model for one universe at a time.
+  template <class UNIVERSE, class EVENT>
+  void getWeights(const PlotUtils::Model<UNIVERSE, EVENT>& model, const std::vector<UNIVERSE*>& univs, const EVENT& event, std::vector<double>& weights)
+  {
+    static_assert(std::is_polymorphic<PlotUtils::Model<UNIVERSE, EVENT>>::value, "getWeights() needs to dynamic_cast a PlotUtils::Model to find out whether it's a BatchModel.");
+    const auto batch = dynamic_cast<const BatchModel<UNIVERSE, EVENT>*>(&model);
+    if(batch)
+    {
+      batch->GetWeights(univs, event, weights);
+      return;
+    }
+
+    weights.resize(univs.size());
+    for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) weights[whichUniv] = model.GetWeight(*univs[whichUniv], event);
+  }
+}
+
+#endif //UTIL_BATCHMODEL_H
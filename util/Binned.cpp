@@ -22,7 +22,8 @@
 //c++ includes
 #include <string>
 #include <initializer_list>
-#include <map>
+#include <vector>
+#include <algorithm>
 
 namespace apo
 {
@@ -66,15 +67,15 @@ namespace apo
 
       HIST& operator[](const float_t value)
       {
-        const auto found = fVarToHist.upper_bound(value);
-        if(found != fVarToHist.begin()) return *(std::prev(found)->second);
+        const auto found = std::upper_bound(fLowEdges.begin(), fLowEdges.end(), value);
+        if(found != fLowEdges.begin()) return *fHists[std::distance(fLowEdges.begin(), found) - 1];
         return *fUnderflow;
       }
 
       template <class ...ARGS>
       auto Fill(const float_t value, ARGS... args)
       {
-        (*this)[value]->Fill(args...);
+        return (*this)[value].Fill(args...);
       }
 
       //Apply a callable object, of type FUNC, to each histogram this object manages.
@@ -82,14 +83,15 @@ namespace apo
       template <class FUNC>
       void visit(FUNC&& func)
       {
-        for(auto& bin: fVarToHist) func(bin.first, *(bin.second));
-        func(fVarToHist.begin()->first - 1., *fUnderflow);
+        for(size_t whichBin = 0; whichBin < fHists.size(); ++whichBin) func(fLowEdges[whichBin], *fHists[whichBin]);
+        func(fLowEdges.front() - 1., *fUnderflow);
       }
 
     private:
       //Every HIST is stored as a HIST* because they are really owned by the current TDirectory.
       //So, these are all observer pointers that will not be deleted.
-      std::map<float_t, HIST*> fVarToHist; //Mapping from variable at lower bin edge to histogram
+      std::vector<float_t> fLowEdges; //Sorted lower edge of each bin.  One contiguous array is faster to search than a std::map<>.
+      std::vector<HIST*> fHists; //Histogram for each bin in fLowEdges
       HIST* fUnderflow; //Underflow bin
 
       //Helper function to centralize constructor functionality
@@ -106,15 +108,17 @@ namespace apo
         for(auto bin = bins.begin(); bin < std::prev(bins.end()); ++bin)
         {
           const auto nextBin = apo::stringify(*std::next(bin), nSigFigs);
-          fVarToHist[*bin] = new HIST((name + SafeROOTName(binStr + " ")).c_str(),
-                                      (title + binStr + " < " + var + " < " + nextBin + axes).c_str(), args...);
+          fLowEdges.push_back(*bin);
+          fHists.push_back(new HIST((name + SafeROOTName(binStr + " ")).c_str(),
+                                    (title + binStr + " < " + var + " < " + nextBin + axes).c_str(), args...));
           binStr = nextBin;
         }
 
         //Last bin has overflow values
         binStr = apo::stringify(*std::prev(bins.end()), nSigFigs);
-        fVarToHist[*std::prev(bins.end())] = new HIST((name + SafeROOTName(binStr + " ")).c_str(),
-                                                      (title + var + " > " + binStr + axes).c_str(), args...);
+        fLowEdges.push_back(*std::prev(bins.end()));
+        fHists.push_back(new HIST((name + SafeROOTName(binStr + " ")).c_str(),
+                                  (title + var + " > " + binStr + axes).c_str(), args...));
       }
   };
 }
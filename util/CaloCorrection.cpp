@@ -1,4 +1,4 @@
-//File: CaloCorrection.h
+//File: CaloCorrection.cpp
 //Brief: A CaloCorrection corrects recoil energy (without vertex box, with OD, etc.) to
 //       a better estimator for total hadronic energy.  It mimics Minerva::CalorimetryUtils
 //       in doing this by interpolating a multiplicative constant between a series of points.
@@ -6,6 +6,8 @@
 
 //Local includes
 #include "util/CaloCorrection.h"
+#include "util/SafeROOTName.h"
+#include "util/Hash.h"
 
 //c++ includes
 #include <string>
@@ -17,10 +19,22 @@
 #include <sstream>
 #include <algorithm>
 #include <iostream>
+#include <cstdint>
+#include <iterator>
+#include <cstdio>
+
+//POSIX includes
+#include <unistd.h>
 
 #define FORBID(KEYWORD, STATE)\
   assert(line.find("KEYWORD") == std::string::npos && KEYWORD "keyword does not make sense in the " STATE "state!");
 
+namespace
+{
+  constexpr char cacheMagic[] = "CALOCOR1";
+  constexpr size_t cacheMagicLength = sizeof(cacheMagic) - 1;
+}
+
 namespace util
 {
   std::string& trim(std::string& toTrim)
@@ -61,6 +75,12 @@ namespace util
   }
 
   std::unordered_map<std::string, CaloCorrection> CaloCorrection::parse(const std::string& caloFile)
+  {
+    std::vector<std::string> filesRead;
+    return parse(caloFile, filesRead);
+  }
+
+  std::unordered_map<std::string, CaloCorrection> CaloCorrection::parse(const std::string& caloFile, std::vector<std::string>& filesRead)
   {
     std::unordered_map<std::string, CaloCorrection> corrections;
     auto currentCorr = corrections.end();
@@ -80,6 +100,7 @@ namespace util
     {
       std::ifstream currentFile(replaceEnvVars(filesLeft.top()));
       assert(currentFile.is_open() && "Failed to open a calorimetry spline file!");
+      filesRead.push_back(filesLeft.top());
       filesLeft.pop();
       //--depth; //TODO: This depth check doesn't seem correct because I keep going with the current file
 
@@ -154,42 +175,193 @@ namespace util
     return corrections;
   }
 
-  CaloCorrection::CaloCorrection(const std::string& caloFile, const std::string& tuningName)
+  CaloCorrection::CaloCorrection(const std::string& caloFile, const std::string& tuningName, const std::string& cacheDir): CaloCorrection()
   {
-    const auto parsed = parse(caloFile);
-    const auto found = parsed.find(tuningName);
-    if(found != parsed.end())
+    std::string cacheFile;
+    if(!cacheDir.empty())
     {
-      fPoints = found->second.fPoints;
-      fScale = found->second.fScale;
+      std::string expandedDir = cacheDir;
+      cacheFile = replaceEnvVars(expandedDir) + "/" + SafeROOTName(tuningName) + "_" + toHex(fnv1a(caloFile)) + ".calocache";
     }
-    else
+
+    if(cacheFile.empty() || !readCache(cacheFile))
     {
-      std::cerr << "Calorimetric splines found:\n";
-      for(const auto& spline: parsed) std::cerr << spline.first << ".\n";
+      std::vector<std::string> filesRead;
+      const auto parsed = parse(caloFile, filesRead);
+      const auto found = parsed.find(tuningName);
+      if(found != parsed.end())
+      {
+        fPoints = found->second.fPoints;
+        fScale = found->second.fScale;
+      }
+      else
+      {
+        std::cerr << "Calorimetric splines found:\n";
+        for(const auto& spline: parsed) std::cerr << spline.first << ".\n";
+
+        throw std::runtime_error("Failed to find a calorimetric spline named " + tuningName + ".");
+      }
 
-      throw std::runtime_error("Failed to find a calorimetric spline named " + tuningName + ".");
+      compile();
+      if(!cacheFile.empty() && !writeCache(cacheFile, filesRead)) std::cerr << "CaloCorrection: Failed to write a cache of calorimetric spline " << tuningName << " to " << cacheFile << ".  Will parse " << caloFile << " again next time.\n";
     }
 
     #ifndef NDEBUG
       std::cout << "Using a calorimetric correction named " << tuningName << " with scale " << fScale << " from " << caloFile << ":\n";
-      for(const auto& point: fPoints) std::cout << point.threshold << ", " << point.correction << "\n";
+      for(size_t whichSegment = 0; whichSegment < fBreakpoints.size(); ++whichSegment) std::cout << "Up to " << fBreakpoints[whichSegment] << " MeV: " << fIntercepts[whichSegment] << " GeV + " << fSlopes[whichSegment] << " GeV/MeV\n";
     #endif
   }
 
+  GeV CaloCorrection::correct(const MeV scaledRecoil) const
+  {
+    const double recoil = scaledRecoil.in<MeV>();
+    if(fBreakpoints.empty() || recoil > fBreakpoints.back()) return scaledRecoil; //scaledRecoil is after last point, so don't correct.
+                                                                                 //This is both a fail-safe mechanism for very energetic
+                                                                                 //neutrinos which are very rare in MINERvA's <6 GeV>
+                                                                                 //beam and the Default spline.
+
+    const size_t segment = std::distance(fBreakpoints.begin(), std::lower_bound(fBreakpoints.begin(), fBreakpoints.end(), recoil));
+    return std::max(0., fIntercepts[segment] + fSlopes[segment] * recoil);
+  }
+
   GeV CaloCorrection::eCorrection(const MeV rawRecoil) const
   {
-    const MeV scaledRecoil = rawRecoil.in<MeV>() * fScale;
-    const auto upperPoint = std::lower_bound(std::next(fPoints.begin()), fPoints.end(), scaledRecoil, [](const auto& point, const auto recoil) { return point.threshold < recoil; });
-    if(upperPoint != fPoints.end())
+    return correct(rawRecoil.in<MeV>() * fScale);
+  }
+
+  void CaloCorrection::compile()
+  {
+    fBreakpoints.clear();
+    fIntercepts.clear();
+    fSlopes.clear();
+
+    //The first point only starts the first segment.  With fewer than 2 points, there are no segments.
+    //Extrapolate the first segment below the first point just like the original lower_bound() search did.
+    for(size_t whichPoint = 1; whichPoint < fPoints.size(); ++whichPoint)
     {
-      const auto lowerPoint = std::prev(upperPoint);
-      return std::max(0., lowerPoint->correction + (upperPoint->correction - lowerPoint->correction) * (scaledRecoil - lowerPoint->threshold).in<GeV>() / (upperPoint->threshold - lowerPoint->threshold).in<GeV>());
+      const auto& lower = fPoints[whichPoint - 1];
+      const auto& upper = fPoints[whichPoint];
+      const double width = (upper.threshold - lower.threshold).in<MeV>();
+      const double slope = (width > 0)?(upper.correction - lower.correction) / width:0.;
+
+      fBreakpoints.push_back(upper.threshold.in<MeV>());
+      fSlopes.push_back(slope);
+      fIntercepts.push_back(lower.correction - slope * lower.threshold.in<MeV>());
     }
-    else return scaledRecoil; //scaledRecoil is after last point, so don't correct.
-                              //This is both a fail-safe mechanism for very energetic
-                              //neutrinos which are very rare in MINERvA's <6 GeV>
-                              //beam and the Default spline.
+
+    fPoints.clear();
+  }
+
+  bool CaloCorrection::readCache(const std::string& cacheFile)
+  {
+    std::ifstream cache(cacheFile, std::ios::binary | std::ios::ate);
+    if(!cache) return false;
+
+    //A truncated or corrupted cache could claim to be bigger than memory.  Never believe a length
+    //that's longer than what's left in the file.
+    const std::streamoff fileSize = cache.tellg();
+    cache.seekg(0);
+    const auto bytesLeft = [&cache, fileSize]() { return static_cast<uint64_t>(fileSize - cache.tellg()); };
+
+    char fileMagic[::cacheMagicLength];
+    cache.read(fileMagic, ::cacheMagicLength);
+    if(!cache || std::string(fileMagic, ::cacheMagicLength) != ::cacheMagic) return false;
+
+    //Make sure none of the files that went into this cache have changed
+    uint64_t nFiles = 0;
+    cache.read(reinterpret_cast<char*>(&nFiles), sizeof(nFiles));
+    if(!cache) return false;
+
+    uint64_t hash = fnv1aBasis;
+    for(uint64_t whichFile = 0; whichFile < nFiles; ++whichFile)
+    {
+      uint64_t pathLength = 0;
+      cache.read(reinterpret_cast<char*>(&pathLength), sizeof(pathLength));
+      if(!cache || pathLength > bytesLeft()) return false;
+      std::string path(pathLength, '\0');
+      cache.read(&path[0], pathLength);
+      if(!cache) return false;
+
+      std::ifstream source(path, std::ios::binary);
+      if(!source) return false;
+      hash = fnv1a(path, hash);
+      hash = fnv1a(std::string(std::istreambuf_iterator<char>(source), std::istreambuf_iterator<char>()), hash);
+    }
+
+    uint64_t cachedHash = 0, nSegments = 0;
+    double scale = 0;
+    cache.read(reinterpret_cast<char*>(&cachedHash), sizeof(cachedHash));
+    cache.read(reinterpret_cast<char*>(&scale), sizeof(scale));
+    cache.read(reinterpret_cast<char*>(&nSegments), sizeof(nSegments));
+    if(!cache || cachedHash != hash) return false;
+    if(nSegments > bytesLeft() / (3 * sizeof(double))) return false;
+
+    std::vector<double> breakpoints(nSegments), intercepts(nSegments), slopes(nSegments);
+    cache.read(reinterpret_cast<char*>(breakpoints.data()), nSegments * sizeof(double));
+    cache.read(reinterpret_cast<char*>(intercepts.data()), nSegments * sizeof(double));
+    cache.read(reinterpret_cast<char*>(slopes.data()), nSegments * sizeof(double));
+    if(!cache) return false;
+
+    fScale = scale;
+    fBreakpoints = std::move(breakpoints);
+    fIntercepts = std::move(intercepts);
+    fSlopes = std::move(slopes);
+
+    return true;
+  }
+
+  //Binary layout: magic, number of source files, each source file's length and path,
+  //hash of all source paths and contents, fScale, number of segments, then fBreakpoints,
+  //fIntercepts, and fSlopes back to back.  Native byte order.
+  bool CaloCorrection::writeCache(const std::string& cacheFile, const std::vector<std::string>& filesRead) const
+  {
+    //Write somewhere else first so that other jobs sharing this cache never read a partial file
+    char hostName[256] = "";
+    ::gethostname(hostName, sizeof(hostName) - 1);
+    const std::string tempName = cacheFile + "." + hostName + "." + std::to_string(::getpid()) + ".tmp";
+
+    bool written = writeCacheTo(tempName, filesRead);
+    if(!written || std::rename(tempName.c_str(), cacheFile.c_str()))
+    {
+      std::remove(tempName.c_str());
+      written = false;
+    }
+
+    return written;
+  }
+
+  bool CaloCorrection::writeCacheTo(const std::string& fileName, const std::vector<std::string>& filesRead) const
+  {
+    std::ofstream cache(fileName, std::ios::binary);
+    if(!cache) return false;
+
+    cache.write(::cacheMagic, ::cacheMagicLength);
+
+    const uint64_t nFiles = filesRead.size();
+    cache.write(reinterpret_cast<const char*>(&nFiles), sizeof(nFiles));
+
+    uint64_t hash = fnv1aBasis;
+    for(const auto& path: filesRead)
+    {
+      std::ifstream source(path, std::ios::binary);
+      if(!source) return false;
+      hash = fnv1a(path, hash);
+      hash = fnv1a(std::string(std::istreambuf_iterator<char>(source), std::istreambuf_iterator<char>()), hash);
+
+      const uint64_t pathLength = path.length();
+      cache.write(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+      cache.write(path.data(), pathLength);
+    }
+
+    const uint64_t nSegments = fBreakpoints.size();
+    cache.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    cache.write(reinterpret_cast<const char*>(&fScale), sizeof(fScale));
+    cache.write(reinterpret_cast<const char*>(&nSegments), sizeof(nSegments));
+    cache.write(reinterpret_cast<const char*>(fBreakpoints.data()), nSegments * sizeof(double));
+    cache.write(reinterpret_cast<const char*>(fIntercepts.data()), nSegments * sizeof(double));
+    cache.write(reinterpret_cast<const char*>(fSlopes.data()), nSegments * sizeof(double));
+
+    return static_cast<bool>(cache);
   }
 
   CaloCorrection::CaloCorrection(): fScale(0), fPoints{}
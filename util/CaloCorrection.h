@@ -2,20 +2,30 @@
 //Brief: A CaloCorrection corrects recoil energy (without vertex box, with OD, etc.) to
 //       a better estimator for total hadronic energy.  It mimics Minerva::CalorimetryUtils
 //       in doing this by interpolating a multiplicative constant between a series of points.
+//       The polyline is compiled into flat arrays of breakpoints and slopes once it's
+//       parsed, and that compiled form can be cached on disk to skip parsing entirely.
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
+#ifndef UTIL_CALOCORRECTION_H
+#define UTIL_CALOCORRECTION_H
+
 //Local includes
 #include "util/units.h"
 
 //c++ includes
 #include <unordered_map>
+#include <vector>
+#include <string>
 
 namespace util
 {
   class CaloCorrection
   {
     public:
-      CaloCorrection(const std::string& caloFile, const std::string& tuningName = "Default");
+      //If cacheDir is not empty, look for a compiled copy of tuningName there before parsing
+      //caloFile.  The cache is only used if the contents of caloFile and every file it IMPORTs
+      //haven't changed since it was written.  Otherwise, it's rewritten after parsing.
+      CaloCorrection(const std::string& caloFile, const std::string& tuningName = "Default", const std::string& cacheDir = "");
 
       //Load one CaloCorrection from a plaintext file with the following format that originated
       //from https://nusoft.fnal.gov/minerva/minervadat/software_doxygen/HEAD/MINERVA/classCalorimetryUtils.html#261bfea9ea2c8880fbfa352fdfb9f60f:
@@ -37,6 +47,17 @@ namespace util
     private:
       CaloCorrection();
 
+      //Same as the public parse(), but also remembers every file it read after environment variables were expanded
+      static std::unordered_map<std::string, CaloCorrection> parse(const std::string& caloFile, std::vector<std::string>& filesRead);
+
+      //Turn fPoints into fBreakpoints, fIntercepts, and fSlopes
+      void compile();
+
+      //Cache management.  Both return false and leave this CaloCorrection untouched on failure.
+      bool readCache(const std::string& cacheFile);
+      bool writeCache(const std::string& cacheFile, const std::vector<std::string>& filesRead) const;
+      bool writeCacheTo(const std::string& fileName, const std::vector<std::string>& filesRead) const; //writeCache() without the rename
+
       struct PolyPoint
       {
         GeV threshold;
@@ -45,6 +66,17 @@ namespace util
 
       double fScale; //Overall energy scale applied to all Clusters
 
-      std::vector<PolyPoint> fPoints;
+      std::vector<PolyPoint> fPoints; //Only used while parsing
+
+      //Compiled polyline.  Segment i covers scaled recoil energies up to fBreakpoints[i] in MeV.
+      //Its correction is fIntercepts[i] + fSlopes[i] * scaled recoil in MeV.  Scaled energies
+      //above fBreakpoints.back() are not corrected.
+      std::vector<double> fBreakpoints;
+      std::vector<double> fIntercepts;
+      std::vector<double> fSlopes;
+
+      GeV correct(const MeV scaledRecoil) const;
   };
 }
+
+#endif //UTIL_CALOCORRECTION_H
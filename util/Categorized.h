@@ -16,32 +16,13 @@
 //c++ includes
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <map>
 #include <set>
 #include <functional>
 #include <type_traits>
-
-namespace
-{
-  //Old std::void_t<> implementation courtesy of https://en.cppreference.com/w/cpp/types/void_t
-  template<typename... Ts> struct make_void { typedef void type;};
-  template<typename... Ts> using void_t = typename make_void<Ts...>::type;
-
-  //Check whether a CATegory is std::hash<>able.  Soft of a missing piece of the STL because
-  //it wasn't guaranteed to work pre-c++17.  As long as you're using a c++17-era STL, this should work
-  //regardless of compiler standard.
-  //Solution inspired by https://stackoverflow.com/questions/12753997/check-if-type-is-hashable
-
-  template <class CAT, class VALUE, typename = void_t<>>
-  struct map_t { using type = std::map<CAT, VALUE>; };
-
-  template <class CAT, class VALUE>
-  struct map_t<CAT, VALUE, void_t<decltype(std::declval<std::hash<CAT>>()(std::declval<CAT>()))>>
-  {
-    using type = std::unordered_map<CAT, VALUE>;
-  };
-}
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
 
 namespace util
 {
@@ -53,42 +34,113 @@ namespace util
     std::string name;
   };
 
+  namespace detail
+  {
+    //Dense index for each category value, or -1 for values that aren't in any category.
+    //Looking up a value is a binary search over a short sorted array instead of hashing.
+    template <class CAT>
+    class SortedCategoryIndex
+    {
+      public:
+        void add(const CAT& key, const int index)
+        {
+          const auto pos = std::lower_bound(fKeys.begin(), fKeys.end(), key, std::less<CAT>());
+          const auto offset = std::distance(fKeys.begin(), pos);
+          if(pos != fKeys.end() && !std::less<CAT>()(key, *pos)) fIndices[offset] = index; //Last category to claim a value gets it
+          else
+          {
+            fKeys.insert(pos, key);
+            fIndices.insert(fIndices.begin() + offset, index);
+          }
+        }
+
+        inline int operator ()(const CAT& key) const
+        {
+          const auto pos = std::lower_bound(fKeys.begin(), fKeys.end(), key, std::less<CAT>());
+          if(pos == fKeys.end() || std::less<CAT>()(key, *pos)) return -1;
+          return fIndices[std::distance(fKeys.begin(), pos)];
+        }
+
+      protected:
+        std::vector<CAT> fKeys; //Sorted
+        std::vector<int> fIndices; //Index of each key
+    };
+
+    //Compiled once after all categories are add()ed
+    template <class CAT, class = void>
+    class CategoryIndex: public SortedCategoryIndex<CAT>
+    {
+      public:
+        void compile() {}
+    };
+
+    //Integer categories like PDG codes and GENIE interaction modes are usually close
+    //together, so look them up directly in an array indexed by value - min.  Falls
+    //back to binary search when values are too far apart, like nuclear PDG codes.
+    template <class CAT>
+    class CategoryIndex<CAT, typename std::enable_if<std::is_integral<CAT>::value || std::is_enum<CAT>::value>::type>: public SortedCategoryIndex<CAT>
+    {
+      private:
+        using Base_t = SortedCategoryIndex<CAT>;
+        static constexpr long long maxDirectSize = 4096;
+
+        long long fMin = 0;
+        std::vector<int> fDirect; //Empty if values were too far apart
+
+      public:
+        void compile()
+        {
+          fDirect.clear();
+          if(Base_t::fKeys.empty()) return;
+
+          fMin = static_cast<long long>(Base_t::fKeys.front());
+          const long long size = static_cast<long long>(Base_t::fKeys.back()) - fMin + 1;
+          if(size > maxDirectSize) return;
+
+          fDirect.assign(size, -1);
+          for(size_t whichKey = 0; whichKey < Base_t::fKeys.size(); ++whichKey) fDirect[static_cast<long long>(Base_t::fKeys[whichKey]) - fMin] = Base_t::fIndices[whichKey];
+        }
+
+        inline int operator ()(const CAT key) const
+        {
+          if(fDirect.empty()) return Base_t::operator()(key);
+
+          const long long offset = static_cast<long long>(key) - fMin;
+          if(offset < 0 || offset >= static_cast<long long>(fDirect.size())) return -1;
+          return fDirect[offset];
+        }
+    };
+  }
+
   //A Categorized holds a total HIST along with a HIST for each category.
   //It works similarly to a Binned<>, but each entry either exactly matches
   //one CATEGORY or is put in the Other CATEGORY.
   //Its Fill() method takes a CATEGORY plus whatever ARGS HIST::Fill() takes.
   template <class HIST, class CATEGORY>
   //HIST is a Fill()able type that takes a c-string as its first constructor argument (like TH1D or Binned<TH1D>)
-  //CATEGORY is hashable for std::unordered_map<> and has either a "name" member that can be added to a std::string
-  //         or first and second members with first being hashable and second that can be added to a std::string.
+  //CATEGORY is comparable with std::less<> and has either a "name" member that can be added to a std::string
+  //         or first and second members with first being comparable and second that can be added to a std::string.
   class Categorized
   {
     private:
       //Code reuse for the special case of std::unique_ptr<> through metaprogramming.
-      //Solves the problem where I want to hash std::unique_ptr<>s without owning them.
+      //Solves the problem where I want to look up std::unique_ptr<>s without owning them.
 
       //The "normal" case: It's fine to keep a copy of CAT.
       template <class CAT>
-      struct lookup
+      struct key
       {
-        typename map_t<CAT, HIST*>::type map;
-
-        HIST*& operator [](const CAT& key) { return map[key]; }
-
-        auto find(const CAT& key) const -> decltype(map.find(key)) { return map.find(key); }
+        using type = CAT;
+        static const CAT& get(const CAT& cat) { return cat; }
       };
 
       //Special case: Don't hold on to a copy of unique_ptr<>.  Take an
       //              observer pointer instead.
       template <class CAT>
-      struct lookup<std::unique_ptr<CAT>>
+      struct key<std::unique_ptr<CAT>>
       {
-        typename map_t<CAT*, HIST*>::type map;
-        static_assert(std::is_same<typename map_t<CAT*, HIST*>::type, std::unordered_map<CAT*, HIST*>>::value, "Using std::map for unique_ptr<> where unordered_map<> should be used!");
-
-        HIST*& operator [](const std::unique_ptr<CAT>& key) { return map[key.get()]; }
-
-        auto find(const std::unique_ptr<CAT>& key) const -> decltype(map.find(key.get())) { return map.find(key.get()); }
+        using type = CAT*;
+        static CAT* get(const std::unique_ptr<CAT>& cat) { return cat.get(); }
       };
 
     public:
@@ -99,12 +151,13 @@ namespace util
       {
         for(const auto& category: categories)
         {
-          auto hist = dir.make<HIST>(SafeROOTName(baseName + "_" + category.name).c_str(), (category.name + ";" + axes).c_str(), args...);
+          fHists.push_back(dir.make<HIST>(SafeROOTName(baseName + "_" + category.name).c_str(), (category.name + ";" + axes).c_str(), args...));
           for(const auto& value: category.values)
           {
-            fCatToHist[value] = hist;
+            fIndex.add(value, fHists.size() - 1);
           }
         }
+        fIndex.compile();
 
         fOther = dir.make<HIST>(SafeROOTName(baseName + "_Other").c_str(), ("Other;" + axes).c_str(), args...);
       }
@@ -116,12 +169,13 @@ namespace util
       {
         for(const auto& category: categories)
         {
-          auto hist = dir.make<HIST>(SafeROOTName(baseName + "_" + category.name).c_str(), (category.name + ";" + axes).c_str(), args...);
+          fHists.push_back(dir.make<HIST>(SafeROOTName(baseName + "_" + category.name).c_str(), (category.name + ";" + axes).c_str(), args...));
           for(const auto& value: category.values)
           {
-            fCatToHist[value] = hist;
+            fIndex.add(value, fHists.size() - 1);
           }
         }
+        fIndex.compile();
 
         fOther = dir.make<HIST>(SafeROOTName(baseName + "_Other").c_str(), ("Other;" + axes).c_str(), args...);
       }
@@ -133,8 +187,10 @@ namespace util
       {
         for(const auto& catPtr: categories)
         {
-          fCatToHist[catPtr] = dir.make<HIST>(SafeROOTName(baseName + "_" + catPtr->name()).c_str(), (catPtr->name() + ";" + axes).c_str(), args...);
+          fHists.push_back(dir.make<HIST>(SafeROOTName(baseName + "_" + catPtr->name()).c_str(), (catPtr->name() + ";" + axes).c_str(), args...));
+          fIndex.add(key<CATEGORY>::get(catPtr), fHists.size() - 1);
         }
+        fIndex.compile();
 
         fOther = dir.make<HIST>(SafeROOTName(baseName + "_Other").c_str(), ("Other;" + axes).c_str(), args...);
       }
@@ -146,8 +202,10 @@ namespace util
       {
         for(const auto& catPtr: categories)
         {
-          fCatToHist[catPtr] = dir.make<HIST>(SafeROOTName(baseName + "_" + catPtr->name()).c_str(), (catPtr->name() + ";" + axes).c_str(), args...);
+          fHists.push_back(dir.make<HIST>(SafeROOTName(baseName + "_" + catPtr->name()).c_str(), (catPtr->name() + ";" + axes).c_str(), args...));
+          fIndex.add(key<CATEGORY>::get(catPtr), fHists.size() - 1);
         }
+        fIndex.compile();
 
         fOther = dir.make<HIST>(SafeROOTName(baseName + "_Other").c_str(), ("Other;" + axes).c_str(), args...);
       }
@@ -159,20 +217,36 @@ namespace util
       {
         for(const auto& category: categories)
         {
-          auto hist = dir.make<HIST>(SafeROOTName(baseName + "_" + category.second), (category.second + ";" + axes).c_str(), args...);
-          fCatToHist[category.first] = hist;
+          fHists.push_back(dir.make<HIST>(SafeROOTName(baseName + "_" + category.second), (category.second + ";" + axes).c_str(), args...));
+          fIndex.add(category.first, fHists.size() - 1);
         }
+        fIndex.compile();
 
         fOther = dir.make<HIST>(SafeROOTName(baseName + "_Other").c_str(), ("Other;" + axes).c_str(), args...);
       }
 
       HIST& operator [](const CATEGORY& cat) const
       {
-        //Find out whether category is kept track of separately
-        const auto found = fCatToHist.find(cat);
-        if(found == fCatToHist.map.end()) return *fOther; //If not, lump this entry in with other uncategorized entries
-        return *found->second; //If so, return its category
-        
+        return (*this)(index(cat));
+      }
+
+      //Dense index of the HIST for cat, or -1 for Other.  Use this to look up a
+      //category once and Fill() several HISTs or nested Categorized<>s with it.
+      inline int index(const CATEGORY& cat) const
+      {
+        return fIndex(key<CATEGORY>::get(cat));
+      }
+
+      inline HIST& operator ()(const int whichHist) const
+      {
+        //Lump entries that aren't kept track of separately in with other uncategorized entries
+        return (whichHist < 0)?*fOther:*fHists[whichHist];
+      }
+
+      //Number of categories, not counting Other.  index() is always less than this.
+      inline int size() const
+      {
+        return fHists.size();
       }
 
       //Apply a callable object, of type FUNC, to each histogram this object manages.
@@ -180,17 +254,7 @@ namespace util
       template <class FUNC>
       void visit(FUNC&& func)
       {
-        //Make sure that each histogram is normalized exactly once
-        std::set<HIST*> histsNormalized;
-        for(auto& category: fCatToHist.map)
-        {
-          if(histsNormalized.count(category.second) == 0)
-          {
-            func(*(category.second));
-            histsNormalized.insert(category.second);
-          }
-        }
-
+        for(auto hist: fHists) func(*hist);
         func(*fOther);
       }
 
@@ -202,9 +266,45 @@ namespace util
     private:
       //All HISTs are referred to as observer pointers for compatability with TH1s created in a TFile.
       //The TFile is responsible for deleting them.
-      lookup<CATEGORY> fCatToHist;
+      std::vector<HIST*> fHists; //One per category in the order they were configured
+      detail::CategoryIndex<typename key<CATEGORY>::type> fIndex; //Maps CATEGORY to its position in fHists
       HIST* fOther; //All entries that don't fit in any other CATEGORY end up in this HIST
   };
+
+  //A Categorized<> of Categorized<>s, like histograms by target by material, flattened into
+  //one array of HISTs.  Looking up a HIST finds each category's index once and then indexes
+  //that array at outer * nInner + inner instead of going through an inner Categorized<>.
+  //Every inner Categorized<> must have been made from the same categories.  nested still
+  //owns the HISTs and has to outlive this.
+  template <class HIST, class OUTER, class INNER>
+  class FlatCategorized
+  {
+    public:
+      FlatCategorized(const Categorized<Categorized<HIST, INNER>, OUTER>& nested): fOuter(nested), fInner(nested(-1)),
+                                                                                   fNInner(fInner.size() + 1)
+      {
+        //Other is the last index on each axis
+        for(int whichOuter = 0; whichOuter <= fOuter.size(); ++whichOuter)
+        {
+          const auto& inner = fOuter((whichOuter < fOuter.size())?whichOuter:-1);
+          if(inner.size() + 1 != fNInner) throw std::runtime_error("FlatCategorized: every inner Categorized<> has to have the same categories.");
+          for(int whichInner = 0; whichInner < fNInner; ++whichInner) fHists.push_back(&inner((whichInner < inner.size())?whichInner:-1));
+        }
+      }
+
+      inline HIST& operator ()(const OUTER& outer, const INNER& inner) const
+      {
+        const int whichOuter = fOuter.index(outer),
+                  whichInner = fInner.index(inner);
+        return *fHists[((whichOuter < 0)?fOuter.size():whichOuter) * fNInner + ((whichInner < 0)?fNInner - 1:whichInner)];
+      }
+
+    private:
+      const Categorized<Categorized<HIST, INNER>, OUTER>& fOuter;
+      const Categorized<HIST, INNER>& fInner; //Looks up inner categories for every outer category
+      int fNInner; //Including Other
+      std::vector<HIST*> fHists; //[outer][inner] with Other last on each axis
+  };
 }
 
 #endif //UTIL_CATEGORIZED_CPP
@@ -0,0 +1,218 @@
+//File: ConcurrentHist.h
+//Brief: Universe storage for FlatHistWrapper<> and FlatHist2DWrapper<> that many threads
+//       can Fill() at the same time using the same signatures as HistWrapper<>.
+//
+//       Sharded<SUM> gives each thread its own copy of every universe's bins.  Copies are
+//       added up in shard order when the histogram is written, so results don't depend on
+//       which thread finished first.  Pick a shard at the top of each worker thread with
+//       a ShardScope.
+//
+//       Atomic shares one copy of every bin between all threads and adds weights with
+//       compare-and-swap.  It uses less memory and is fast when threads rarely fill the
+//       same bin, but the order of floating point sums can change from job to job.
+//
+//       Universe bookkeeping happens in the constructor, so make histograms before starting
+//       threads and SyncCVHistos() after joining them.  BenchmarkConcurrentHists compares
+//       both strategies.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_CONCURRENTHIST_H
+#define UTIL_CONCURRENTHIST_H
+
+//util includes
+#include "util/FlatHistWrapper.h"
+
+//c++ includes
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+
+namespace util
+{
+  //Use Sharded<SUM> in place of SUM to keep one copy of every bin per thread
+  template <class SUM = PlainSum<double>>
+  struct Sharded {};
+
+  //Use Atomic in place of SUM to share one copy of every bin between all threads
+  struct Atomic {};
+
+  //Which shard of Sharded<> histograms this thread fills until it's destroyed.
+  //Threads that never make one fill shard 0.
+  class ShardScope
+  {
+    public:
+      ShardScope(const size_t whichShard): fPrevious(current()) { current() = whichShard; }
+      ~ShardScope() { current() = fPrevious; }
+
+      static inline size_t& current()
+      {
+        thread_local size_t shard = 0;
+        return shard;
+      }
+
+      //Sharded<> histograms made after this get nShards shards.  Defaults to one per core.
+      static inline void setNShards(const size_t nShards) { shardCount() = std::max<size_t>(1, nShards); }
+      static inline size_t nShards() { return shardCount(); }
+
+    private:
+      size_t fPrevious;
+
+      static inline size_t& shardCount()
+      {
+        static size_t count = std::max(1u, std::thread::hardware_concurrency());
+        return count;
+      }
+  };
+
+  namespace detail
+  {
+    //One DenseStorage per shard.  Each shard is only allocated and filled by the thread using it.
+    template <class SUM>
+    class ShardedStorage
+    {
+      public:
+        ShardedStorage(const size_t nSlots, const size_t nBins): fNSlots(nSlots), fNBins(nBins), fShards(ShardScope::nShards()) {}
+
+        bool allocated() const
+        {
+          return std::any_of(fShards.begin(), fShards.end(), [](const auto& shard) { return shard && shard->allocated(); });
+        }
+
+        inline void add(const size_t whichSlot, const int bin, const double weight)
+        {
+          const size_t whichShard = ShardScope::current();
+          if(whichShard >= fShards.size())
+          {
+            throw std::runtime_error("Shard " + std::to_string(whichShard) + " doesn't exist in a histogram with " + std::to_string(fShards.size())
+                                     + " shards.  Call ShardScope::setNShards() before making histograms.");
+          }
+
+          auto& shard = fShards[whichShard];
+          if(!shard) shard.reset(new DenseStorage<SUM>(fNSlots, fNBins));
+          shard->add(whichSlot, bin, weight);
+        }
+
+        //Shards are always added in the same order
+        void write(TH1& target, const size_t whichSlot) const
+        {
+          std::vector<double> sumw(fNBins, 0), sumw2(fNBins, 0);
+          double entries = 0;
+          for(const auto& shard: fShards)
+          {
+            if(shard) shard->addTo(whichSlot, sumw, sumw2, entries);
+          }
+
+          for(size_t bin = 0; bin < fNBins; ++bin)
+          {
+            target.SetBinContent(bin, sumw[bin]);
+            target.SetBinError(bin, (0 < sumw2[bin])?std::sqrt(sumw2[bin]):0);
+          }
+          target.SetEntries(entries);
+        }
+
+        size_t bytes() const
+        {
+          size_t total = fShards.capacity() * sizeof(typename decltype(fShards)::value_type);
+          for(const auto& shard: fShards)
+          {
+            if(shard) total += shard->bytes();
+          }
+          return total;
+        }
+
+      private:
+        size_t fNSlots;
+        size_t fNBins; //Including underflow and overflow
+
+        std::vector<std::unique_ptr<DenseStorage<SUM>>> fShards; //Empty until a thread fills its shard
+    };
+
+    //One [universe][bin] array that every thread adds to atomically
+    class AtomicStorage
+    {
+      public:
+        AtomicStorage(const size_t nSlots, const size_t nBins): fNSlots(nSlots), fNBins(nBins), fAllocated(false) {}
+
+        bool allocated() const { return fAllocated.load(std::memory_order_acquire); }
+
+        inline void add(const size_t whichSlot, const int bin, const double weight)
+        {
+          if(!allocated()) allocate();
+
+          auto& sums = fBins[whichSlot * fNBins + bin];
+          add(sums.sumw, weight);
+          add(sums.sumw2, weight * weight);
+          sums.entries.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void write(TH1& target, const size_t whichSlot) const
+        {
+          double entries = 0;
+          for(size_t bin = 0; bin < fNBins; ++bin)
+          {
+            const auto& sums = fBins[whichSlot * fNBins + bin];
+            target.SetBinContent(bin, sums.sumw.load());
+            const double err2 = sums.sumw2.load();
+            target.SetBinError(bin, (0 < err2)?std::sqrt(err2):0);
+            entries += sums.entries.load();
+          }
+          target.SetEntries(entries);
+        }
+
+        size_t bytes() const { return allocated()?fNSlots * fNBins * sizeof(Bin):0; }
+
+      private:
+        //Entries are counted per bin so that threads filling different bins never share a counter
+        struct Bin
+        {
+          std::atomic<double> sumw;
+          std::atomic<double> sumw2;
+          std::atomic<unsigned long> entries;
+        };
+
+        size_t fNSlots;
+        size_t fNBins; //Including underflow and overflow
+
+        std::unique_ptr<Bin[]> fBins;
+        std::atomic<bool> fAllocated;
+        std::once_flag fAllocateOnce;
+
+        void allocate()
+        {
+          std::call_once(fAllocateOnce, [this]()
+                                        {
+                                          fBins.reset(new Bin[fNSlots * fNBins]());
+                                          fAllocated.store(true, std::memory_order_release);
+                                        });
+        }
+
+        static inline void add(std::atomic<double>& sum, const double weight)
+        {
+          double expected = sum.load(std::memory_order_relaxed);
+          while(!sum.compare_exchange_weak(expected, expected + weight, std::memory_order_relaxed)) {}
+        }
+    };
+
+    template <class SUM>
+    struct storage<Sharded<SUM>>
+    {
+      using type = ShardedStorage<SUM>;
+      static constexpr bool concurrent = true;
+    };
+
+    template <>
+    struct storage<Atomic>
+    {
+      using type = AtomicStorage;
+      static constexpr bool concurrent = true;
+    };
+  }
+}
+
+#endif //UTIL_CONCURRENTHIST_H
@@ -19,7 +19,7 @@
 namespace util  
 {
   //Define member functions out of class body for cleanliness
-  Directory::Directory(TFile& dir): fBaseDir(dir), fName("")
+  Directory::Directory(TFile& dir): fBaseDir(dir), fName(""), fBudget(nullptr), fWriter(nullptr), fIndex(nullptr)
   {
   }
                                                                                                                               
@@ -30,13 +30,18 @@ namespace util
   }
                                                                                                                               
   Directory::Directory(const std::string& name, Directory& parent): fBaseDir(parent.fBaseDir), 
-                                                                    fName(parent.fName+name+Separator)
+                                                                    fName(parent.fName+name+Separator),
+                                                                    fPath(parent.fPath), fBudget(parent.fBudget), fWriter(parent.fWriter), fIndex(parent.fIndex)
   {
+    fPath.push_back(name);
   }
 
   void Directory::mv(TH1* obj)
   {
-    obj->SetName((fName + obj->GetName()).c_str());
+    const std::string name = obj->GetName();
+    obj->SetName((fName + name).c_str());
     obj->SetDirectory(&fBaseDir);
+    if(fBudget) detail::account(*fBudget, fPath, obj->GetName(), obj);
+    if(fIndex) fIndex->add(fPath, name, obj->GetName(), detail::axisTitle(obj));
   }
 }
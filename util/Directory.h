@@ -12,8 +12,14 @@
 #ifndef UTIL_DIRECTORY_H
 #define UTIL_DIRECTORY_H
 
+//util includes
+#include "util/MemoryBudget.h"
+#include "util/AsyncWriter.h"
+#include "util/HistIndex.h"
+
 //c++ includes
 #include <string>
+#include <vector>
 
 //ROOT includes
 #include "TFile.h"
@@ -58,6 +64,81 @@ namespace util
     { 
       static void dir(PlotUtils::Hist2DWrapper<UNIV>& wrapper, TDirectory& dir) { wrapper.hist->SetDirectory(&dir); }
     };
+
+    //Machinery to tell a MemoryBudget about each object a Directory
+    //makes.  Overloads are picked by pointer conversions so that classes
+    //derived from HistWrapper<>, like units::WithUnits<>, are found too.
+    //Anything that isn't a histogram, like a TTree, doesn't count.
+    inline void account(MemoryBudget& /*budget*/, const std::vector<std::string>& /*path*/, const std::string& /*name*/, const void* /*obj*/) {}
+
+    //Plain TH1s are usually metadata like flux integrals, so they're never reported as unfilled
+    inline void account(MemoryBudget& budget, const std::vector<std::string>& path, const std::string& name, const TH1* hist)
+    {
+      budget.add(path, name, {{"cv", MemoryBudget::bytes(*hist)}});
+    }
+
+    template <class MNVHIST>
+    MemoryBudget::bands_t bandBytes(MNVHIST& hist)
+    {
+      MemoryBudget::bands_t bytes{{"cv", MemoryBudget::bytes(hist)}};
+      for(const auto& name: hist.GetVertErrorBandNames())
+      {
+        const auto band = hist.GetVertErrorBand(name);
+        bytes[name] = (band->GetNHists() + 1) * MemoryBudget::bytes(*band);
+      }
+      for(const auto& name: hist.GetLatErrorBandNames())
+      {
+        const auto band = hist.GetLatErrorBand(name);
+        bytes[name] = (band->GetNHists() + 1) * MemoryBudget::bytes(*band);
+      }
+      return bytes;
+    }
+
+    //Has any universe been filled?
+    template <class MNVHIST>
+    bool anyEntries(MNVHIST& hist)
+    {
+      if(hist.GetEntries() > 0) return true;
+      for(const auto& name: hist.GetVertErrorBandNames())
+      {
+        const auto band = hist.GetVertErrorBand(name);
+        for(unsigned int whichUniv = 0; whichUniv < band->GetNHists(); ++whichUniv)
+        {
+          if(band->GetHist(whichUniv)->GetEntries() > 0) return true;
+        }
+      }
+      for(const auto& name: hist.GetLatErrorBandNames())
+      {
+        const auto band = hist.GetLatErrorBand(name);
+        for(unsigned int whichUniv = 0; whichUniv < band->GetNHists(); ++whichUniv)
+        {
+          if(band->GetHist(whichUniv)->GetEntries() > 0) return true;
+        }
+      }
+      return false;
+    }
+
+    template <class UNIV>
+    void account(MemoryBudget& budget, const std::vector<std::string>& path, const std::string& name, PlotUtils::HistWrapper<UNIV>* wrapper)
+    {
+      budget.add(path, name, bandBytes(*wrapper->hist), [wrapper] { return anyEntries(*wrapper->hist); });
+    }
+
+    template <class UNIV>
+    void account(MemoryBudget& budget, const std::vector<std::string>& path, const std::string& name, PlotUtils::Hist2DWrapper<UNIV>* wrapper)
+    {
+      budget.add(path, name, bandBytes(*wrapper->hist), [wrapper] { return anyEntries(*wrapper->hist); });
+    }
+
+    //X axis title for a HistIndex.  Wrappers like HistWrapper<> keep their histogram in a member named hist.
+    inline std::string axisTitle(const void* /*obj*/) { return ""; }
+    inline std::string axisTitle(const TH1* hist) { return hist->GetXaxis()->GetTitle(); }
+
+    template <class WRAPPER>
+    auto axisTitle(const WRAPPER* wrapper) -> decltype(std::string(wrapper->hist->GetXaxis()->GetTitle()))
+    {
+      return wrapper->hist->GetXaxis()->GetTitle();
+    }
   }
 
   //Looks like art::TFileService.
@@ -88,6 +169,12 @@ namespace util
         detail::set<TOBJECT>::dir(*obj, fBaseDir); //This is redundant for normal TH1Ds, but it's necessary for
                                                    //PlotUtils::HistWrapper<> because HistWrapper<> calls SetDirectory(0)
                                                    //in its constructor.
+
+        //Unqualified so that histogram classes in other headers can provide their own account()
+        using detail::account;
+        if(fBudget) account(*fBudget, fPath, fName + name, obj);
+        if(fIndex) fIndex->add(fPath, name, fName + name, detail::axisTitle(obj));
+
         return obj;
       }
 
@@ -96,6 +183,19 @@ namespace util
       //Move a TH1 into this Directory.
       //Only TH1-derived classes have SetDirectory().
       void mv(TH1* obj);
+
+      //Tell budget about everything this Directory and its
+      //sub-directories make<>() from now on.
+      inline void track(MemoryBudget& budget) { fBudget = &budget; }
+
+      //Output work like TTree::Fill() for objects made by this Directory and its
+      //sub-directories goes through writer from now on.
+      inline void writeWith(AsyncWriter& writer) { fWriter = &writer; }
+      inline AsyncWriter& writer() const { return fWriter?*fWriter:AsyncWriter::synchronous(); }
+
+      //Record what every object this Directory and its sub-directories
+      //make<>() from now on is for in index.
+      inline void indexWith(HistIndex& index) { fIndex = &index; }
        
     private:
       TFile& fBaseDir; //Base directory in which this 
@@ -107,6 +207,11 @@ namespace util
                                //appended to the names of all child objects
                                //to create unique names.  
 
+      std::vector<std::string> fPath; //Names of this Directory and its parents
+      MemoryBudget* fBudget; //Told about every object made if not nullptr
+      AsyncWriter* fWriter; //Runs output work synchronously if nullptr
+      HistIndex* fIndex; //Told about every object made if not nullptr
+
       //Create a subdirectory of a given Directory.  This behavior is 
       //exposed to the user through mkdir.
       Directory(const std::string& name, Directory& parent);
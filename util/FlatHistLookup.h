@@ -0,0 +1,101 @@
+//File: FlatHistLookup.h
+//Brief: Read-only copies of ROOT histograms for looking up weights once per event.
+//       Bin contents live in one contiguous array with the same global bin numbering
+//       as ROOT, and axes with fixed bin widths find bins with TAxis's arithmetic
+//       instead of a search.  Axes are never extended like TAxis::FindBin()
+//       can do, so these are safe to share between threads once constructed.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_FLATHISTLOOKUP_H
+#define UTIL_FLATHISTLOOKUP_H
+
+//ROOT includes
+#include "TAxis.h"
+#include "TArrayD.h"
+#include "TH1.h"
+
+//c++ includes
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+namespace util
+{
+  class FlatAxis
+  {
+    public:
+      FlatAxis(const TAxis& axis): fNBins(axis.GetNbins()), fMin(axis.GetXmin()), fMax(axis.GetXmax()),
+                                   fRange(fMax - fMin), fUniform(axis.GetXbins()->GetSize() == 0)
+      {
+        if(!fUniform) fEdges.assign(axis.GetXbins()->GetArray(), axis.GetXbins()->GetArray() + fNBins + 1);
+      }
+
+      //Same answer as TAxis::FindBin(): 0 for underflow, fNBins + 1 for overflow
+      inline int FindBin(const double x) const
+      {
+        if(x < fMin) return 0;
+        if(!(x < fMax)) return fNBins + 1; //Also catches NaN like TAxis does
+
+        //Same arithmetic as TAxis so that weights don't change at bin edges.
+        //Rounding can put x just below fMax into bin fNBins + 1.  Guard against it.
+        if(fUniform) return 1 + std::min(static_cast<int>(fNBins * (x - fMin) / fRange), fNBins - 1);
+        return std::distance(fEdges.begin(), std::upper_bound(fEdges.begin(), fEdges.end(), x));
+      }
+
+      inline int GetNbins() const { return fNBins; }
+
+    private:
+      int fNBins;
+      double fMin;
+      double fMax;
+      double fRange;
+      bool fUniform;
+      std::vector<double> fEdges; //Only filled for variable bin widths
+  };
+
+  //Works for any TH1 including TH1D and MnvH1D
+  class FlatHist1D
+  {
+    public:
+      FlatHist1D(const TH1& hist): fAxis(*hist.GetXaxis())
+      {
+        fContents.reserve(fAxis.GetNbins() + 2);
+        for(int whichBin = 0; whichBin < fAxis.GetNbins() + 2; ++whichBin) fContents.push_back(hist.GetBinContent(whichBin));
+      }
+
+      inline double GetBinContent(const int bin) const { return fContents[bin]; }
+      inline double Lookup(const double x) const { return fContents[fAxis.FindBin(x)]; }
+      inline const FlatAxis& GetXaxis() const { return fAxis; }
+
+    private:
+      FlatAxis fAxis;
+      std::vector<double> fContents; //Includes underflow and overflow
+  };
+
+  //Works for any TH2 including TH2D and MnvH2D
+  class FlatHist2D
+  {
+    public:
+      FlatHist2D(const TH1& hist): fXAxis(*hist.GetXaxis()), fYAxis(*hist.GetYaxis()), fStride(fXAxis.GetNbins() + 2)
+      {
+        fContents.reserve(fStride * (fYAxis.GetNbins() + 2));
+        for(int yBin = 0; yBin < fYAxis.GetNbins() + 2; ++yBin)
+        {
+          for(int xBin = 0; xBin < fStride; ++xBin) fContents.push_back(hist.GetBinContent(xBin, yBin));
+        }
+      }
+
+      inline double GetBinContent(const int xBin, const int yBin) const { return fContents[xBin + fStride * yBin]; }
+      inline double Lookup(const double x, const double y) const { return GetBinContent(fXAxis.FindBin(x), fYAxis.FindBin(y)); }
+      inline const FlatAxis& GetXaxis() const { return fXAxis; }
+      inline const FlatAxis& GetYaxis() const { return fYAxis; }
+
+    private:
+      FlatAxis fXAxis;
+      FlatAxis fYAxis;
+      int fStride; //Number of x bins including underflow and overflow.  Same layout as TH1::GetBin().
+      std::vector<double> fContents;
+  };
+}
+
+#endif //UTIL_FLATHISTLOOKUP_H
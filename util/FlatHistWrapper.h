@@ -0,0 +1,650 @@
+//File: FlatHistWrapper.h
+//Brief: Drop-in replacements for PlotUtils::HistWrapper<> and Hist2DWrapper<> that
+//       keep every universe's bin contents in one contiguous [universe][bin] array
+//       instead of a TH1D per universe.  Universes get dense integer IDs once at
+//       construction, so a Fill() never looks up a histogram by name or pointer.
+//       The MnvH1D or MnvH2D with its error bands is only filled in by SyncCVHistos()
+//       or Materialize(), so output files look exactly like they came from a HistWrapper<>.
+//
+//       Universe contents aren't allocated until the first Fill(), and histograms
+//       made from the same universes share their universe bookkeeping, so Studies
+//       with many categories that are usually empty can use these directly.
+//
+//       Bin sums can be double precision or single precision with Kahan compensation
+//       through the SUM template parameter.  Sparse<SUM> only stores bins that were
+//       filled.  Build with -DFLAT_HISTOGRAMS=ON to use these in the cross section
+//       Studies through util::UnivHist<> and util::UnivHist2D<>.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_FLATHISTWRAPPER_H
+#define UTIL_FLATHISTWRAPPER_H
+
+//util includes
+#include "util/Directory.h"
+#include "util/FlatHistLookup.h"
+#include "util/MemoryBudget.h"
+#include "util/BatchModel.h"
+
+//PlotUtils includes
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverloaded-virtual"
+#include "PlotUtils/MnvH1D.h"
+#include "PlotUtils/MnvH2D.h"
+#include "PlotUtils/HistWrapper.h"
+#include "PlotUtils/Hist2DWrapper.h"
+#include "PlotUtils/Model.h"
+#pragma GCC diagnostic pop
+
+//c++ includes
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cmath>
+#include <cassert>
+#include <ostream>
+
+namespace util
+{
+  //Plain sum of weights in one bin
+  template <class FLOAT>
+  struct PlainSum
+  {
+    FLOAT sum = 0;
+
+    inline void add(const double weight) { sum += weight; }
+    inline double value() const { return sum; }
+  };
+
+  //Kahan-compensated sum so that single precision doesn't lose small weights
+  //added to large bins.
+  template <class FLOAT>
+  struct KahanSum
+  {
+    FLOAT sum = 0;
+    FLOAT compensation = 0;
+
+    inline void add(const double weight)
+    {
+      const FLOAT corrected = static_cast<FLOAT>(weight) - compensation;
+      const FLOAT total = sum + corrected;
+      compensation = (total - sum) - corrected;
+      sum = total;
+    }
+
+    inline double value() const { return sum; }
+  };
+
+  //Use Sparse<SUM> in place of SUM to only store bins that have been Fill()ed.  Good for
+  //histograms with many bins where each universe only sees a few of them.
+  template <class SUM = PlainSum<double>>
+  struct Sparse {};
+
+  namespace detail
+  {
+    //Every universe's bins in one [universe][bin] array.  Empty until the first add().
+    template <class SUM>
+    class DenseStorage
+    {
+      public:
+        DenseStorage(const size_t nSlots, const size_t nBins): fNSlots(nSlots), fNBins(nBins) {}
+
+        bool allocated() const { return !fSumw.empty(); }
+
+        inline void add(const size_t whichSlot, const int bin, const double weight)
+        {
+          if(fSumw.empty())
+          {
+            fSumw.resize(fNSlots * fNBins);
+            fSumw2.resize(fNSlots * fNBins);
+            fEntries.resize(fNSlots, 0);
+          }
+
+          const size_t index = whichSlot * fNBins + bin;
+          fSumw[index].add(weight);
+          fSumw2[index].add(weight * weight);
+          fEntries[whichSlot] += 1;
+        }
+
+        void write(TH1& target, const size_t whichSlot) const
+        {
+          for(size_t bin = 0; bin < fNBins; ++bin)
+          {
+            target.SetBinContent(bin, fSumw[whichSlot * fNBins + bin].value());
+            const double err2 = fSumw2[whichSlot * fNBins + bin].value();
+            target.SetBinError(bin, (0 < err2)?std::sqrt(err2):0);
+          }
+          target.SetEntries(fEntries[whichSlot]);
+        }
+
+        //Add one universe's contents to double precision totals with nBins entries
+        void addTo(const size_t whichSlot, std::vector<double>& sumw, std::vector<double>& sumw2, double& entries) const
+        {
+          if(!allocated()) return;
+
+          for(size_t bin = 0; bin < fNBins; ++bin)
+          {
+            sumw[bin] += fSumw[whichSlot * fNBins + bin].value();
+            sumw2[bin] += fSumw2[whichSlot * fNBins + bin].value();
+          }
+          entries += fEntries[whichSlot];
+        }
+
+        size_t bytes() const { return (fSumw.capacity() + fSumw2.capacity()) * sizeof(SUM) + fEntries.capacity() * sizeof(double); }
+
+      private:
+        size_t fNSlots;
+        size_t fNBins; //Including underflow and overflow
+
+        std::vector<SUM> fSumw;
+        std::vector<SUM> fSumw2;
+        std::vector<double> fEntries;
+    };
+
+    //Only bins that have been Fill()ed in each universe
+    template <class SUM>
+    class SparseStorage
+    {
+      public:
+        SparseStorage(const size_t nSlots, const size_t nBins): fNSlots(nSlots), fNBins(nBins) {}
+
+        bool allocated() const { return !fBins.empty(); }
+
+        inline void add(const size_t whichSlot, const int bin, const double weight)
+        {
+          if(fBins.empty())
+          {
+            fBins.resize(fNSlots);
+            fEntries.resize(fNSlots, 0);
+          }
+
+          auto& sums = fBins[whichSlot][bin];
+          sums.sumw.add(weight);
+          sums.sumw2.add(weight * weight);
+          fEntries[whichSlot] += 1;
+        }
+
+        //Bins that were never filled might have a copy of the CV in them
+        void write(TH1& target, const size_t whichSlot) const
+        {
+          for(size_t bin = 0; bin < fNBins; ++bin)
+          {
+            target.SetBinContent(bin, 0);
+            target.SetBinError(bin, 0);
+          }
+
+          for(const auto& bin: fBins[whichSlot])
+          {
+            target.SetBinContent(bin.first, bin.second.sumw.value());
+            const double err2 = bin.second.sumw2.value();
+            target.SetBinError(bin.first, (0 < err2)?std::sqrt(err2):0);
+          }
+          target.SetEntries(fEntries[whichSlot]);
+        }
+
+        //Estimate including each hash table node's pointers and buckets
+        size_t bytes() const
+        {
+          size_t total = fBins.capacity() * sizeof(map_t) + fEntries.capacity() * sizeof(double);
+          for(const auto& slot: fBins) total += slot.size() * (sizeof(typename map_t::value_type) + 2 * sizeof(void*)) + slot.bucket_count() * sizeof(void*);
+          return total;
+        }
+
+      private:
+        struct Sums
+        {
+          SUM sumw;
+          SUM sumw2;
+        };
+        using map_t = std::unordered_map<int, Sums>;
+
+        size_t fNSlots;
+        size_t fNBins; //Including underflow and overflow
+
+        std::vector<map_t> fBins; //[universe] -> bin -> sums
+        std::vector<double> fEntries;
+    };
+
+    //concurrent storage can be filled from many threads at once.  See ConcurrentHist.h.
+    template <class SUM>
+    struct storage
+    {
+      using type = DenseStorage<SUM>;
+      static constexpr bool concurrent = false;
+    };
+
+    template <class SUM>
+    struct storage<Sparse<SUM>>
+    {
+      using type = SparseStorage<SUM>;
+      static constexpr bool concurrent = false;
+    };
+
+    //Which slot of a flat array each universe's contents go in.  Every histogram
+    //made from the same universes shares one of these, so a histogram that's never
+    //filled costs about as much as its CV MnvH1D.
+    template <class UNIV>
+    struct UniverseLayout
+    {
+      struct Band
+      {
+        std::string name;
+        size_t firstSlot;
+        size_t nUnivs;
+        bool isVertical;
+      };
+
+      std::vector<Band> bands;
+      std::unordered_map<const UNIV*, size_t> slots;
+      size_t nSlots;
+
+      //Remember each group of compatible universes' slots.  Keyed by groupHash().
+      struct Group
+      {
+        std::vector<const UNIV*> univs;
+        std::vector<size_t> slots;
+      };
+      std::unordered_map<size_t, Group> groups;
+
+      //Depends on every universe in a group and their order
+      static size_t groupHash(const std::vector<UNIV*>& univs)
+      {
+        size_t hash = univs.size();
+        for(const auto univ: univs) hash = (hash ^ std::hash<const UNIV*>()(univ)) * 1099511628211ull;
+        return hash;
+      }
+
+      static std::shared_ptr<UniverseLayout> get(const std::map<std::string, std::vector<UNIV*>>& univs)
+      {
+        static std::map<std::vector<const UNIV*>, std::shared_ptr<UniverseLayout>> cache;
+
+        std::vector<const UNIV*> key;
+        for(const auto& band: univs) key.insert(key.end(), band.second.begin(), band.second.end());
+
+        auto& found = cache[key];
+        if(!found) found.reset(new UniverseLayout(univs));
+        return found;
+      }
+
+      private:
+        UniverseLayout(const std::map<std::string, std::vector<UNIV*>>& univs): nSlots(1) //0 is the CV
+        {
+          for(const auto& band: univs)
+          {
+            if(band.first == "cv")
+            {
+              for(const auto univ: band.second) slots[univ] = 0;
+              continue;
+            }
+
+            bands.push_back(Band{band.first, nSlots, band.second.size(), band.second.front()->IsVerticalOnly()});
+            for(const auto univ: band.second) slots[univ] = nSlots++;
+          }
+        }
+    };
+
+    //Everything that doesn't depend on the number of dimensions.  MNVHIST is MnvH1D or MnvH2D.
+    template <class UNIV, class MNVHIST, class SUM>
+    class FlatUniverseHists
+    {
+      public:
+        MNVHIST* hist; //Same name as HistWrapper<> so that Directory and GetFluxIntegral() can find it
+
+        //Put universe contents into hist's error bands and make every band's CV match hist
+        void SyncCVHistos() { materialize(true); }
+
+        //Put universe contents into hist's error bands without changing the bands' CVs.
+        //Same result as a HistWrapper<> that never had SyncCVHistos() called.
+        void Materialize() { materialize(false); }
+
+        //A copy of hist with every error band but no contents.  Some PlotUtils
+        //functions like flux integrals need to know about error bands up front.
+        std::unique_ptr<MNVHIST> Skeleton() const
+        {
+          std::unique_ptr<MNVHIST> skeleton(static_cast<MNVHIST*>(hist->Clone((std::string(hist->GetName()) + "_skeleton").c_str())));
+          skeleton->SetDirectory(nullptr);
+          addBands(*skeleton);
+          return skeleton;
+        }
+
+        void SetDirectory(TDirectory* dir) { hist->SetDirectory(dir); }
+
+        //Has anything been Fill()ed yet?  Universe contents aren't allocated until then.
+        bool IsAllocated() const { return fStorage.allocated(); }
+
+        //Bytes used by universe contents.  Doesn't count the CV MnvH1D.
+        size_t AllocatedBytes() const { return fStorage.bytes(); }
+
+        //Bytes a HistWrapper<> would use for the same universe contents: bin contents and sums of weights squared in double precision
+        size_t HistWrapperBytes() const { return fLayout->nSlots * fNBins * 2 * sizeof(double); }
+
+        //Bytes a HistWrapper<> would use for each error band including "cv".  Every histogram
+        //becomes one of those at the end of the job, so this is how much memory it will need.
+        MemoryBudget::bands_t BandBytes() const
+        {
+          const size_t univBytes = fNBins * 2 * sizeof(double);
+          MemoryBudget::bands_t bytes{{"cv", univBytes}};
+          for(const auto& band: fLayout->bands) bytes[band.name] = (band.nUnivs + 1) * univBytes;
+          return bytes;
+        }
+
+      protected:
+        FlatUniverseHists(MNVHIST* cv, const std::map<std::string, std::vector<UNIV*>>& univs, const size_t nBins): hist(cv), fNBins(nBins),
+                                                                                                                      fLayout(UniverseLayout<UNIV>::get(univs)),
+                                                                                                                      fStorage(fLayout->nSlots, nBins)
+        {
+        }
+
+        inline size_t slot(const UNIV* univ) const
+        {
+          const auto found = fLayout->slots.find(univ);
+          if(found == fLayout->slots.end()) throw std::runtime_error(std::string("Universe ") + univ->ShortName() + " wasn't set up for " + hist->GetName());
+          return found->second;
+        }
+
+        inline const std::vector<size_t>& slots(const std::vector<UNIV*>& univs)
+        {
+          auto& groups = fLayout->groups;
+          const auto key = UniverseLayout<UNIV>::groupHash(univs);
+          auto found = groups.find(key);
+          if(found == groups.end())
+          {
+            typename UniverseLayout<UNIV>::Group group;
+            group.univs.assign(univs.begin(), univs.end());
+            for(const auto univ: univs) group.slots.push_back(slot(univ));
+            found = groups.emplace(key, std::move(group)).first;
+          }
+          else if(!std::equal(univs.begin(), univs.end(), found->second.univs.begin(), found->second.univs.end()))
+          {
+            throw std::runtime_error(std::string("Two different groups of universes filled ") + hist->GetName() + " have the same hash.  I can't tell which slots they go in.");
+          }
+          return found->second.slots;
+        }
+
+        inline void add(const size_t whichSlot, const int bin, const double weight)
+        {
+          fStorage.add(whichSlot, bin, weight);
+        }
+
+        //Same as HistWrapper<>::Fill() for many compatible universes
+        template <class EVENT>
+        void add(const std::vector<UNIV*>& univs, const int bin, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+        {
+          //Remembering groups changes fLayout, so threads look up each universe instead
+          if(storage<SUM>::concurrent)
+          {
+            for(const auto univ: univs) add(slot(univ), bin, model.GetWeight(*univ, evt));
+            return;
+          }
+
+          const auto& groupSlots = slots(univs);
+          getWeights(model, univs, evt, fWeights);
+          for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv) add(groupSlots[whichUniv], bin, fWeights[whichUniv]);
+        }
+
+      private:
+        size_t fNBins; //Including underflow and overflow
+        std::shared_ptr<UniverseLayout<UNIV>> fLayout;
+
+        typename storage<SUM>::type fStorage; //Empty until the first Fill()
+        std::vector<double> fWeights; //Weights for the universes in the last add().  Kept so add() doesn't allocate.
+
+        //Same error bands HistWrapper<> would have made
+        void addBands(MNVHIST& target) const
+        {
+          for(const auto& band: fLayout->bands)
+          {
+            if(band.isVertical && !target.HasVertErrorBand(band.name)) target.AddVertErrorBand(band.name, band.nUnivs);
+            else if(!band.isVertical && !target.HasLatErrorBand(band.name)) target.AddLatErrorBand(band.name, band.nUnivs);
+          }
+        }
+
+        void materialize(const bool syncCV)
+        {
+          //Error bands copy the CV when they're created
+          if(!syncCV) addBands(*hist);
+          if(IsAllocated()) fStorage.write(*hist, 0);
+          if(syncCV) addBands(*hist);
+
+          //A histogram that was never filled still gets every error band, just empty
+          //or a copy of the CV, so merging and extraction code finds what it expects.
+          if(!IsAllocated()) return;
+
+          for(const auto& band: fLayout->bands)
+          {
+            for(size_t whichUniv = 0; whichUniv < band.nUnivs; ++whichUniv)
+            {
+              TH1* univHist = band.isVertical?static_cast<TH1*>(hist->GetVertErrorBand(band.name)->GetHist(whichUniv)):static_cast<TH1*>(hist->GetLatErrorBand(band.name)->GetHist(whichUniv));
+              fStorage.write(*univHist, band.firstSlot + whichUniv);
+            }
+          }
+        }
+    };
+  }
+
+  template <class UNIV, class SUM = PlainSum<double>>
+  class FlatHistWrapper: public detail::FlatUniverseHists<UNIV, PlotUtils::MnvH1D, SUM>
+  {
+    private:
+      using Base_t = detail::FlatUniverseHists<UNIV, PlotUtils::MnvH1D, SUM>;
+
+    public:
+      FlatHistWrapper(const char* name, const char* title, const std::vector<double>& bins, const std::map<std::string, std::vector<UNIV*>>& univs):
+        Base_t(new PlotUtils::MnvH1D(name, title, bins.size() - 1, bins.data()), univs, bins.size() + 1), fAxis(*Base_t::hist->GetXaxis())
+      {
+      }
+
+      FlatHistWrapper(const char* name, const char* title, const int nBins, const double min, const double max, const std::map<std::string, std::vector<UNIV*>>& univs):
+        Base_t(new PlotUtils::MnvH1D(name, title, nBins, min, max), univs, nBins + 2), fAxis(*Base_t::hist->GetXaxis())
+      {
+      }
+
+      virtual ~FlatHistWrapper() = default;
+
+      int Fill(const UNIV* univ, const double value, const double weight = 1)
+      {
+        const int bin = fAxis.FindBin(value);
+        Base_t::add(Base_t::slot(univ), bin, weight);
+        return bin;
+      }
+
+      //Same as HistWrapper<>::FillUniverse()
+      int FillUniverse(const UNIV* univ, const double value, const double weight = 1) { return Fill(univ, value, weight); }
+      int FillUniverse(const UNIV& univ, const double value, const double weight = 1) { return Fill(&univ, value, weight); }
+
+      template <class EVENT>
+      int Fill(const std::vector<UNIV*>& univs, const double value, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        assert(!univs.empty());
+        const int bin = fAxis.FindBin(value);
+        Base_t::add(univs, bin, model, evt);
+        return bin;
+      }
+
+      //Fill a bin that was already looked up, like a Linearizer's bin
+      int FillBin(const UNIV* univ, const int bin, const double weight = 1)
+      {
+        Base_t::add(Base_t::slot(univ), bin, weight);
+        return bin;
+      }
+
+      template <class EVENT>
+      int FillBin(const std::vector<UNIV*>& univs, const int bin, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        assert(!univs.empty());
+        Base_t::add(univs, bin, model, evt);
+        return bin;
+      }
+
+    private:
+      FlatAxis fAxis;
+  };
+
+  template <class UNIV, class SUM = PlainSum<double>>
+  class FlatHist2DWrapper: public detail::FlatUniverseHists<UNIV, PlotUtils::MnvH2D, SUM>
+  {
+    private:
+      using Base_t = detail::FlatUniverseHists<UNIV, PlotUtils::MnvH2D, SUM>;
+
+    public:
+      FlatHist2DWrapper(const char* name, const char* title, const std::vector<double>& xBins, const std::vector<double>& yBins,
+                        const std::map<std::string, std::vector<UNIV*>>& univs):
+        Base_t(new PlotUtils::MnvH2D(name, title, xBins.size() - 1, xBins.data(), yBins.size() - 1, yBins.data()), univs, (xBins.size() + 1) * (yBins.size() + 1)),
+        fXAxis(*Base_t::hist->GetXaxis()), fYAxis(*Base_t::hist->GetYaxis())
+      {
+      }
+
+      FlatHist2DWrapper(const char* name, const char* title, const int nXBins, const double xMin, const double xMax,
+                        const int nYBins, const double yMin, const double yMax, const std::map<std::string, std::vector<UNIV*>>& univs):
+        Base_t(new PlotUtils::MnvH2D(name, title, nXBins, xMin, xMax, nYBins, yMin, yMax), univs, (nXBins + 2) * (nYBins + 2)),
+        fXAxis(*Base_t::hist->GetXaxis()), fYAxis(*Base_t::hist->GetYaxis())
+      {
+      }
+
+      virtual ~FlatHist2DWrapper() = default;
+
+      int Fill(const UNIV* univ, const double x, const double y, const double weight = 1)
+      {
+        const int bin = globalBin(x, y);
+        Base_t::add(Base_t::slot(univ), bin, weight);
+        return bin;
+      }
+
+      //Same as Hist2DWrapper<>::FillUniverse()
+      int FillUniverse(const UNIV* univ, const double x, const double y, const double weight = 1) { return Fill(univ, x, y, weight); }
+      int FillUniverse(const UNIV& univ, const double x, const double y, const double weight = 1) { return Fill(&univ, x, y, weight); }
+
+      template <class EVENT>
+      int Fill(const std::vector<UNIV*>& univs, const double x, const double y, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        assert(!univs.empty());
+        const int bin = globalBin(x, y);
+        Base_t::add(univs, bin, model, evt);
+        return bin;
+      }
+
+      //Fill bins that were already looked up, like a Linearizer's bins
+      int FillBin(const UNIV* univ, const int xBin, const int yBin, const double weight = 1)
+      {
+        const int bin = xBin + (fXAxis.GetNbins() + 2) * yBin;
+        Base_t::add(Base_t::slot(univ), bin, weight);
+        return bin;
+      }
+
+      template <class EVENT>
+      int FillBin(const std::vector<UNIV*>& univs, const int xBin, const int yBin, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        assert(!univs.empty());
+        const int bin = xBin + (fXAxis.GetNbins() + 2) * yBin;
+        Base_t::add(univs, bin, model, evt);
+        return bin;
+      }
+
+    private:
+      FlatAxis fXAxis;
+      FlatAxis fYAxis;
+
+      //Same layout as TH1::GetBin()
+      inline int globalBin(const double x, const double y) const
+      {
+        return fXAxis.FindBin(x) + (fXAxis.GetNbins() + 2) * fYAxis.FindBin(y);
+      }
+  };
+
+  //Write out any histogram that SyncCVHistos() wasn't called on.  Does nothing for HistWrapper<>
+  //because its contents are already in its MnvH1D.
+  template <class UNIV>
+  void materialize(PlotUtils::HistWrapper<UNIV>& /*hist*/) {}
+
+  template <class UNIV>
+  void materialize(PlotUtils::Hist2DWrapper<UNIV>& /*hist*/) {}
+
+  template <class UNIV, class MNVHIST, class SUM>
+  void materialize(detail::FlatUniverseHists<UNIV, MNVHIST, SUM>& hist) { hist.Materialize(); }
+
+  //How much memory a Study's flat histograms use compared to the HistWrapper<>s they replace.
+  //add() every histogram at the end of the job, then print() one line about all of them.
+  class MemoryReport
+  {
+    public:
+      template <class HIST>
+      void add(const HIST& hist)
+      {
+        fUsed += hist.AllocatedBytes();
+        fHistWrapper += hist.HistWrapperBytes();
+        if(hist.IsAllocated()) ++fNFilled;
+
+        //Keep the part of the histograms' names that Directory added so
+        //that Studies in different Fiducials can be told apart
+        const std::string name = hist.hist->GetName();
+        if(fNHists == 0) fPrefix = name.substr(0, name.rfind('_') + 1);
+        else fPrefix.resize(std::mismatch(fPrefix.begin(), fPrefix.end(), name.begin(), name.end()).first - fPrefix.begin());
+        ++fNHists;
+      }
+
+      //who is prefixed with the name of the Directory the histograms are in
+      void print(std::ostream& os, const std::string& who) const
+      {
+        const double MB = 1024. * 1024.;
+        os << fPrefix.substr(0, fPrefix.rfind('_') + 1) << who << ": " << fNFilled << " of " << fNHists << " histograms were filled.  Universes used "
+           << fUsed / MB << " MB instead of " << fHistWrapper / MB << " MB with HistWrapper<>s.\n";
+      }
+
+    private:
+      size_t fUsed = 0;
+      size_t fHistWrapper = 0;
+      size_t fNHists = 0;
+      size_t fNFilled = 0;
+      std::string fPrefix; //Longest common beginning of every histogram's name
+  };
+
+  //Histogram backend for the cross section Studies
+  #ifdef FLAT_HISTOGRAMS
+    #ifdef FLAT_HISTOGRAMS_FLOAT
+      using UnivHistSum = KahanSum<float>;
+    #else
+      using UnivHistSum = PlainSum<double>;
+    #endif
+
+    template <class UNIV>
+    using UnivHist = FlatHistWrapper<UNIV, UnivHistSum>;
+
+    template <class UNIV>
+    using UnivHist2D = FlatHist2DWrapper<UNIV, UnivHistSum>;
+  #else
+    template <class UNIV>
+    using UnivHist = PlotUtils::HistWrapper<UNIV>;
+
+    template <class UNIV>
+    using UnivHist2D = PlotUtils::Hist2DWrapper<UNIV>;
+  #endif
+
+  //Directory::make<>() needs to know where the MnvH1D is
+  namespace detail
+  {
+    template <class UNIV, class SUM>
+    struct set<FlatHistWrapper<UNIV, SUM>>
+    {
+      static void dir(FlatHistWrapper<UNIV, SUM>& wrapper, TDirectory& dir) { wrapper.hist->SetDirectory(&dir); }
+    };
+
+    template <class UNIV, class SUM>
+    struct set<FlatHist2DWrapper<UNIV, SUM>>
+    {
+      static void dir(FlatHist2DWrapper<UNIV, SUM>& wrapper, TDirectory& dir) { wrapper.hist->SetDirectory(&dir); }
+    };
+
+    //Found by Directory::make<>() through argument-dependent lookup
+    template <class UNIV, class MNVHIST, class SUM>
+    void account(MemoryBudget& budget, const std::vector<std::string>& path, const std::string& name, const FlatUniverseHists<UNIV, MNVHIST, SUM>* hist)
+    {
+      budget.add(path, name, hist->BandBytes(), [hist] { return hist->IsAllocated(); });
+    }
+  }
+}
+
+#endif //UTIL_FLATHISTWRAPPER_H
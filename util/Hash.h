@@ -0,0 +1,40 @@
+//File: Hash.h
+//Brief: A 64-bit FNV-1a hash for recognizing files and configurations that haven't
+//       changed between jobs.  Unlike std::hash, it gives the same answer on every
+//       platform and compiler, so a cache written by one job can be trusted by another.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_HASH_H
+#define UTIL_HASH_H
+
+//c++ includes
+#include <string>
+#include <cstdint>
+#include <sstream>
+#include <iomanip>
+
+namespace util
+{
+  constexpr uint64_t fnv1aBasis = 14695981039346656037ull;
+
+  //Chain calls by passing the last hash as the second argument
+  inline uint64_t fnv1a(const std::string& data, uint64_t hash = fnv1aBasis)
+  {
+    for(const char byte: data)
+    {
+      hash ^= static_cast<unsigned char>(byte);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  //Fixed-width hexadecimal for putting hashes in file names and metadata
+  inline std::string toHex(const uint64_t hash)
+  {
+    std::stringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return hex.str();
+  }
+}
+
+#endif //UTIL_HASH_H
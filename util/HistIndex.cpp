@@ -0,0 +1,271 @@
+//File: HistIndex.cpp
+//Brief: A HistIndex lists every histogram a util::Directory make<>()s along with its
+//       Fiducial, Study, variable, and what it's for in a cross section extraction.
+//       Post-processing programs use it to look up histograms by role.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/HistIndex.h"
+#include "util/SafeROOTName.h"
+
+//ROOT includes
+#include "TDirectory.h"
+#include "TNamed.h"
+#include "TKey.h"
+#include "TList.h"
+
+//c++ includes
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+  using Role = util::HistIndex::Role;
+
+  //How each Role is spelled in the names of the histograms Studies make and in a stored HistIndex.
+  //Backgrounds are named Background_<category>.
+  const std::vector<std::pair<Role, std::string>> roleNames = {{Role::Signal, "Signal"},
+                                                               {Role::Migration, "Migration"},
+                                                               {Role::EfficiencyNumerator, "EfficiencyNumerator"},
+                                                               {Role::EfficiencyDenominator, "EfficiencyDenominator"},
+                                                               {Role::SelectedMCEvents, "SelectedMCEvents"},
+                                                               {Role::Background, "Background"},
+                                                               {Role::Data, "Data"},
+                                                               {Role::TruthSignal, "TruthSignal"},
+                                                               {Role::Flux, "reweightedflux_integrated"},
+                                                               {Role::FiducialNucleons, "FiducialNucleons"},
+                                                               {Role::Other, "Other"}};
+
+  const std::string backgroundTag = "Background_";
+
+  bool endsWith(const std::string& name, const std::string& suffix)
+  {
+    return name.length() >= suffix.length() && name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0;
+  }
+
+  //Histograms are usually titled "Reco <variable>" or "Truth <variable>" on the x axis
+  std::string variable(const std::string& axisTitle)
+  {
+    for(const std::string level: {"Reco ", "Truth "})
+    {
+      if(axisTitle.compare(0, level.length(), level) == 0) return axisTitle.substr(level.length());
+    }
+    return axisTitle;
+  }
+}
+
+namespace util
+{
+  HistIndex::HistIndex(TDirectory& file)
+  {
+    const auto stored = dynamic_cast<TNamed*>(file.Get(Name));
+    if(!stored)
+    {
+      std::cerr << file.GetName() << " doesn't have a " << Name << ", so I'm guessing what each histogram is for from its name.  "
+                << "Run ProcessAnaTuples again to make a file with a " << Name << ".\n";
+      indexKeyNames(file);
+      return;
+    }
+
+    std::istringstream lines(stored->GetTitle());
+    std::string line;
+    while(std::getline(lines, line))
+    {
+      std::istringstream fields(line);
+      std::vector<std::string> columns;
+      std::string column;
+      while(std::getline(fields, column, '\t')) columns.push_back(column);
+      if(columns.size() != 7) throw std::runtime_error("Expected 7 columns in each line of " + std::string(Name) + " in " + file.GetName() + ", but got this line:\n" + line);
+
+      insert(Entry{columns[0], columns[1], columns[2] == "selection", columns[3], toRole(columns[4]), columns[5], columns[6]});
+      if(columns[2] == "selection") fSelection = columns[1];
+    }
+  }
+
+  void HistIndex::add(const std::vector<std::string>& path, const std::string& name, const std::string& key, const std::string& axisTitle)
+  {
+    Entry entry{"", "", false, ::variable(axisTitle), Role::Other, "", key};
+    if(!path.empty())
+    {
+      entry.fiducial = path.front();
+      for(auto dir = std::next(path.begin()); dir != path.end(); ++dir) entry.study += (entry.study.empty()?"":"_") + *dir;
+    }
+    entry.isSelection = !entry.study.empty() && entry.study == fSelection;
+
+    if(name.compare(0, backgroundTag.length(), backgroundTag) == 0)
+    {
+      entry.role = Role::Background;
+      entry.category = name.substr(backgroundTag.length());
+    }
+    else
+    {
+      const auto found = std::find_if(roleNames.begin(), roleNames.end(), [&name](const auto& role) { return role.second == name; });
+      if(found != roleNames.end()) entry.role = found->first;
+    }
+
+    insert(std::move(entry));
+  }
+
+  void HistIndex::setSelection(const std::string& study)
+  {
+    fSelection = SafeROOTName(study);
+    for(auto& entry: fEntries) entry.isSelection = !entry.study.empty() && entry.study == fSelection;
+  }
+
+  void HistIndex::write(TDirectory& dir) const
+  {
+    std::ostringstream lines;
+    for(const auto& entry: fEntries)
+    {
+      const std::string region = entry.isSelection?"selection":(entry.study.empty()?"fiducial":"sideband");
+      lines << entry.fiducial << "\t" << entry.study << "\t" << region << "\t"
+            << entry.variable << "\t" << toString(entry.role) << "\t" << entry.category << "\t" << entry.key << "\n";
+    }
+
+    TNamed stored(Name, lines.str().c_str());
+    dir.WriteTObject(&stored);
+  }
+
+  const HistIndex::Entry& HistIndex::find(const std::string& fiducial, const std::string& study, const Role role, const std::string& category) const
+  {
+    const auto found = fByCategory.find(lookupKey(fiducial, study, role) + "\t" + category);
+    if(found == fByCategory.end())
+    {
+      throw std::runtime_error("Failed to find a " + toString(role) + (category.empty()?"":" for " + category)
+                               + " histogram for Study " + study + " in Fiducial " + fiducial);
+    }
+
+    return fEntries[found->second];
+  }
+
+  std::vector<const HistIndex::Entry*> HistIndex::findAll(const std::string& fiducial, const std::string& study, const Role role) const
+  {
+    std::vector<const Entry*> result;
+    const auto found = fByRole.find(lookupKey(fiducial, study, role));
+    if(found != fByRole.end())
+    {
+      for(const size_t whichEntry: found->second) result.push_back(&fEntries[whichEntry]);
+    }
+
+    return result;
+  }
+
+  std::vector<std::string> HistIndex::fiducials() const
+  {
+    std::vector<std::string> result;
+    for(const auto& entry: fEntries)
+    {
+      if(!entry.fiducial.empty() && std::find(result.begin(), result.end(), entry.fiducial) == result.end()) result.push_back(entry.fiducial);
+    }
+
+    return result;
+  }
+
+  std::string HistIndex::selection(const std::string& fiducial) const
+  {
+    const auto found = std::find_if(fEntries.begin(), fEntries.end(), [&fiducial](const auto& entry) { return entry.fiducial == fiducial && entry.isSelection; });
+    return (found == fEntries.end())?"":found->study;
+  }
+
+  std::vector<std::string> HistIndex::sidebands(const std::string& fiducial) const
+  {
+    std::vector<std::string> result;
+    for(const auto& entry: fEntries)
+    {
+      if(entry.fiducial == fiducial && !entry.isSelection && !entry.study.empty()
+         && std::find(result.begin(), result.end(), entry.study) == result.end()) result.push_back(entry.study);
+    }
+
+    return result;
+  }
+
+  std::string HistIndex::prefix(const std::string& fiducial, const std::string& study)
+  {
+    return fiducial + "_" + study; //Same separator as Directory
+  }
+
+  std::string HistIndex::toString(const Role role)
+  {
+    const auto found = std::find_if(roleNames.begin(), roleNames.end(), [role](const auto& name) { return name.first == role; });
+    return found->second;
+  }
+
+  void HistIndex::insert(Entry&& entry)
+  {
+    const std::string key = lookupKey(entry.fiducial, entry.study, entry.role);
+    fByCategory.emplace(key + "\t" + entry.category, fEntries.size());
+    fByRole[key].push_back(fEntries.size());
+    fEntries.push_back(std::move(entry));
+  }
+
+  //Objects are named <fiducial>_<study>_<name> by Directory.  Fiducials can
+  //be found from their numbers of nucleons, and Studies are whatever is between
+  //a Fiducial and a name from roleNames.
+  void HistIndex::indexKeyNames(TDirectory& file)
+  {
+    const std::string nucleonsTag = "_" + toString(Role::FiducialNucleons);
+
+    std::vector<std::string> keys, fiducials;
+    for(auto key: *file.GetListOfKeys())
+    {
+      keys.push_back(key->GetName());
+      if(endsWith(keys.back(), nucleonsTag)) fiducials.push_back(util::SafeROOTName(keys.back().substr(0, keys.back().length() - nucleonsTag.length())));
+    }
+
+    for(const auto& key: keys)
+    {
+      Entry entry{"", "", false, "", Role::Other, "", key};
+
+      //Longest Fiducial name that key starts with
+      for(const auto& fiducial: fiducials)
+      {
+        if(key.compare(0, fiducial.length() + 1, fiducial + "_") == 0 && fiducial.length() > entry.fiducial.length()) entry.fiducial = fiducial;
+      }
+
+      if(!entry.fiducial.empty())
+      {
+        const std::string rest = key.substr(entry.fiducial.length() + 1);
+        const size_t backgroundStart = rest.find("_" + backgroundTag);
+
+        if(rest == toString(Role::FiducialNucleons)) entry.role = Role::FiducialNucleons;
+        else if(backgroundStart != std::string::npos)
+        {
+          entry.study = rest.substr(0, backgroundStart);
+          entry.role = Role::Background;
+          entry.category = rest.substr(backgroundStart + backgroundTag.length() + 1);
+        }
+        else
+        {
+          for(const auto& role: roleNames)
+          {
+            if(role.first != Role::Background && role.first != Role::Other && endsWith(rest, "_" + role.second))
+            {
+              entry.study = rest.substr(0, rest.length() - role.second.length() - 1);
+              entry.role = role.first;
+              break;
+            }
+          }
+        }
+      }
+
+      if(entry.role == Role::Signal && fSelection.empty()) fSelection = entry.study;
+      insert(std::move(entry));
+    }
+
+    for(auto& entry: fEntries) entry.isSelection = !entry.study.empty() && entry.study == fSelection;
+  }
+
+  std::string HistIndex::lookupKey(const std::string& fiducial, const std::string& study, const Role role)
+  {
+    return fiducial + "\t" + study + "\t" + toString(role);
+  }
+
+  HistIndex::Role HistIndex::toRole(const std::string& name)
+  {
+    const auto found = std::find_if(roleNames.begin(), roleNames.end(), [&name](const auto& role) { return role.second == name; });
+    if(found == roleNames.end()) throw std::runtime_error("No histogram role named " + name);
+    return found->first;
+  }
+}
@@ -0,0 +1,108 @@
+//File: HistIndex.h
+//Brief: A HistIndex lists every histogram a util::Directory make<>()s along with its
+//       Fiducial, Study, variable, and what it's for in a cross section extraction.
+//       ProcessAnaTuples writes one to each output file as a TNamed whose title has
+//       one tab-separated line per histogram.  Post-processing programs read it back
+//       to look up histograms by role instead of scanning every key for substrings.
+//
+//       Files from before HistIndex existed are indexed from their key names instead.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_HISTINDEX_H
+#define UTIL_HISTINDEX_H
+
+//c++ includes
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class TDirectory;
+
+namespace util
+{
+  class HistIndex
+  {
+    public:
+      //What a histogram is used for.  Named after the histograms the CrossSection Studies make.
+      enum class Role
+      {
+        Signal, //Data in the selected region
+        Migration,
+        EfficiencyNumerator,
+        EfficiencyDenominator,
+        SelectedMCEvents,
+        Background, //One per Background category
+        Data, //Data in a sideband
+        TruthSignal, //Signal events in a sideband
+        Flux, //Flux integral
+        FiducialNucleons,
+        Other
+      };
+
+      struct Entry
+      {
+        std::string fiducial;
+        std::string study; //Empty for objects that belong to a whole Fiducial like FiducialNucleons
+        bool isSelection; //Otherwise, study is a sideband
+        std::string variable;
+        Role role;
+        std::string category; //Which Background for Role::Background
+        std::string key; //Name in the file
+      };
+
+      HistIndex() = default;
+
+      //Read the HistIndex in file
+      HistIndex(TDirectory& file);
+
+      //Record an object a Directory made.  path is the names of the Directories it
+      //was made in starting with its Fiducial.  name is relative to the deepest
+      //Directory.  axisTitle is the x axis title that the variable is taken from.
+      void add(const std::vector<std::string>& path, const std::string& name, const std::string& key,
+               const std::string& axisTitle = "");
+
+      //Studies named study are the selected region.  All others are sidebands.
+      void setSelection(const std::string& study);
+
+      //Save as a TNamed called Name
+      void write(TDirectory& dir) const;
+
+      //Throws std::runtime_error if no histogram matches
+      const Entry& find(const std::string& fiducial, const std::string& study, const Role role,
+                        const std::string& category = "") const;
+
+      //Every histogram with a role, like all Backgrounds.  Empty if there are none.
+      std::vector<const Entry*> findAll(const std::string& fiducial, const std::string& study, const Role role) const;
+
+      //Fiducials in the order their histograms were made
+      std::vector<std::string> fiducials() const;
+
+      //Name of the selected region's Study for a Fiducial.  Empty if it didn't make any histograms.
+      std::string selection(const std::string& fiducial) const;
+      std::vector<std::string> sidebands(const std::string& fiducial) const;
+
+      inline const std::vector<Entry>& entries() const { return fEntries; }
+
+      //Beginning of the names of every object a Study makes
+      static std::string prefix(const std::string& fiducial, const std::string& study);
+
+      static std::string toString(const Role role);
+
+      static constexpr auto Name = "HistIndex";
+
+    private:
+      std::vector<Entry> fEntries;
+      std::string fSelection;
+
+      std::unordered_map<std::string, size_t> fByCategory; //Fiducial, study, role, and category to the index of an Entry
+      std::unordered_map<std::string, std::vector<size_t>> fByRole; //Fiducial, study, and role to the index of every Entry
+
+      void insert(Entry&& entry);
+      void indexKeyNames(TDirectory& file); //For files from before HistIndex
+
+      static std::string lookupKey(const std::string& fiducial, const std::string& study, const Role role);
+      static Role toRole(const std::string& name);
+  };
+}
+
+#endif //UTIL_HISTINDEX_H
@@ -7,7 +7,7 @@
 
 namespace util
 {
-  Interpolation::Interpolation(std::ifstream& file)
+  Interpolation::Interpolation(std::istream& file)
   {
     std::pair<double, double> nextEntry{-1, -1};
     while(file >> nextEntry.first)
@@ -38,4 +38,24 @@ namespace util
   {
     return fTable.empty();
   }
+
+  double Interpolation::minKey() const
+  {
+    return fTable.begin()->first;
+  }
+
+  double Interpolation::minValue() const
+  {
+    return fTable.begin()->second;
+  }
+
+  double Interpolation::maxKey() const
+  {
+    return fTable.rbegin()->first;
+  }
+
+  size_t Interpolation::size() const
+  {
+    return fTable.size();
+  }
 }
@@ -7,19 +7,27 @@
 
 //c++ includes
 #include <map>
-#include <fstream>
+#include <istream>
 
 namespace util
 {
   class Interpolation
   {
     public:
-      Interpolation(std::ifstream& file);
+      Interpolation(std::istream& file);
       Interpolation();
   
       double operator [](const double key) const;
   
       bool empty() const;
+
+      //Range of keys this table knows about.  Not meaningful when empty().
+      double minKey() const;
+      double maxKey() const;
+
+      //operator [] returns 1 at exactly minKey(), so this is the only way to get the value stored there.
+      double minValue() const;
+      size_t size() const;
   
     private:
       std::map<double, double> fTable;
@@ -0,0 +1,53 @@
+//File: Linearizer.cpp
+//Brief: A Linearizer numbers the bins of an N dimensional binning so that an N dimensional
+//       distribution fits in a 1D histogram.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/Linearizer.h"
+
+//ROOT includes
+#include "TAxis.h"
+
+//c++ includes
+#include <stdexcept>
+
+namespace util
+{
+  Linearizer::Linearizer(const std::vector<std::vector<double>>& edges): fNBins(1)
+  {
+    if(edges.empty()) throw std::runtime_error("A Linearizer needs at least 1 axis.");
+
+    for(const auto& axisEdges: edges)
+    {
+      if(axisEdges.size() < 2) throw std::runtime_error("Every axis of a Linearizer needs at least 1 bin, but one has " + std::to_string(axisEdges.size()) + " edges.");
+
+      fAxes.emplace_back(TAxis(axisEdges.size() - 1, axisEdges.data()));
+      fStrides.push_back(fNBins);
+      fNBins *= axisEdges.size() - 1;
+    }
+
+    fLinearEdges.reserve(fNBins + 1);
+    fLinearEdges.push_back(0);
+    for(int linear = 1; linear <= fNBins; ++linear)
+    {
+      const auto bins = Unlinearize(linear);
+      double volume = 1;
+      for(size_t whichAxis = 0; whichAxis < edges.size(); ++whichAxis) volume *= edges[whichAxis][bins[whichAxis]] - edges[whichAxis][bins[whichAxis] - 1];
+      fLinearEdges.push_back(fLinearEdges.back() + volume);
+    }
+  }
+
+  std::vector<int> Linearizer::Unlinearize(const int linearBin) const
+  {
+    std::vector<int> bins(fAxes.size());
+    int remainder = linearBin - 1;
+    for(size_t whichAxis = fAxes.size(); whichAxis > 0; --whichAxis)
+    {
+      bins[whichAxis - 1] = remainder / fStrides[whichAxis - 1] + 1;
+      remainder %= fStrides[whichAxis - 1];
+    }
+
+    return bins;
+  }
+}
@@ -0,0 +1,68 @@
+//File: Linearizer.h
+//Brief: A Linearizer numbers the bins of an N dimensional binning so that an N dimensional
+//       distribution fits in a 1D histogram.  Then N dimensional cross sections can use
+//       the same 1D histograms, 2D migration matrices, and ExtractCrossSection as a 1D
+//       cross section.  Only bins inside every axis get their own linear bin.  Entries
+//       outside any axis go in the linear overflow bin.
+//
+//       The first axis changes fastest like TH1::GetBin().  Each linear bin's width is
+//       the volume of its N dimensional bin, so Scale(1., "width") on a linearized
+//       histogram still makes a differential cross section.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_LINEARIZER_H
+#define UTIL_LINEARIZER_H
+
+//util includes
+#include "util/FlatHistLookup.h"
+
+//c++ includes
+#include <vector>
+#include <array>
+#include <string>
+#include <cassert>
+
+namespace util
+{
+  class Linearizer
+  {
+    public:
+      //One set of bin edges for each axis
+      Linearizer(const std::vector<std::vector<double>>& edges);
+
+      //Linear bin for one value per axis.  0 is never used.  NBins() + 1 is overflow.
+      //Looks up each axis's bin exactly once.
+      template <size_t N>
+      inline int FindBin(const std::array<double, N>& values) const
+      {
+        assert(N == fAxes.size() && "Wrong number of values for this Linearizer!");
+
+        int linear = 1;
+        for(size_t whichAxis = 0; whichAxis < N; ++whichAxis)
+        {
+          const int bin = fAxes[whichAxis].FindBin(values[whichAxis]);
+          if(bin < 1 || bin > fAxes[whichAxis].GetNbins()) return fNBins + 1;
+          linear += (bin - 1) * fStrides[whichAxis];
+        }
+
+        return linear;
+      }
+
+      inline int NBins() const { return fNBins; }
+      inline size_t NDims() const { return fAxes.size(); }
+
+      //Bin edges of the linearized axis.  Bin widths are N dimensional bin volumes.
+      inline const std::vector<double>& Edges() const { return fLinearEdges; }
+
+      //Bin on each axis, starting from 1, for a linear bin
+      std::vector<int> Unlinearize(const int linearBin) const;
+
+    private:
+      std::vector<FlatAxis> fAxes;
+      std::vector<int> fStrides; //Number of linear bins to skip per bin on each axis
+      int fNBins; //Not counting under/overflow
+      std::vector<double> fLinearEdges;
+  };
+}
+
+#endif //UTIL_LINEARIZER_H
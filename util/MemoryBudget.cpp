@@ -0,0 +1,126 @@
+//File: MemoryBudget.cpp
+//Brief: A MemoryBudget keeps track of every histogram a util::Directory make<>()s.
+//       It can project how much memory they'll need and list the ones that were never filled.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/MemoryBudget.h"
+
+//ROOT includes
+#include "TH1.h"
+
+//c++ includes
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+  constexpr double MB = 1024. * 1024.;
+
+  //Print one line per key in a breakdown, biggest first
+  void printBreakdown(std::ostream& os, const std::string& title, const std::map<std::string, std::pair<size_t, size_t>>& bytesAndCounts)
+  {
+    std::vector<std::pair<std::string, std::pair<size_t, size_t>>> sorted(bytesAndCounts.begin(), bytesAndCounts.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.first > rhs.second.first; });
+
+    os << "#" << title << ":\n";
+    for(const auto& line: sorted) os << "  " << line.first << ": " << line.second.first / MB << " MB in " << line.second.second << " histograms\n";
+  }
+}
+
+namespace util
+{
+  void MemoryBudget::add(const std::vector<std::string>& path, const std::string& name, bands_t&& bytes,
+                         std::function<bool()>&& filled)
+  {
+    fEntries.push_back(Entry{path, name, std::move(bytes), std::move(filled)});
+  }
+
+  void MemoryBudget::printProjection(std::ostream& os) const
+  {
+    std::map<std::string, std::pair<size_t, size_t>> byStudy, byFiducial, byBand;
+    size_t total = 0;
+
+    for(const auto& entry: fEntries)
+    {
+      size_t entryBytes = 0;
+      for(const auto& band: entry.bytes)
+      {
+        const auto scale = fBandScales.find(band.first);
+        const size_t bandBytes = (scale != fBandScales.end())?band.second * scale->second:band.second;
+
+        auto& forBand = byBand[band.first];
+        forBand.first += bandBytes;
+        ++forBand.second;
+        entryBytes += bandBytes;
+      }
+
+      auto& forStudy = byStudy[study(entry)];
+      forStudy.first += entryBytes;
+      ++forStudy.second;
+
+      auto& forFiducial = byFiducial[fiducial(entry)];
+      forFiducial.first += entryBytes;
+      ++forFiducial.second;
+
+      total += entryBytes;
+    }
+
+    os << "#Projected histogram memory once every histogram is filled: " << total / MB << " MB in " << fEntries.size() << " histograms\n";
+    printBreakdown(os, "By Study", byStudy);
+    printBreakdown(os, "By Fiducial", byFiducial);
+    printBreakdown(os, "By error band", byBand);
+  }
+
+  void MemoryBudget::freezeFilled()
+  {
+    for(auto& entry: fEntries)
+    {
+      if(!entry.filled) continue;
+      const bool wasFilled = entry.filled();
+      entry.filled = [wasFilled] { return wasFilled; };
+    }
+  }
+
+  size_t MemoryBudget::printNeverFilled(std::ostream& os) const
+  {
+    std::map<std::string, std::vector<std::string>> byStudy;
+    size_t nNeverFilled = 0;
+
+    for(const auto& entry: fEntries)
+    {
+      if(entry.filled && !entry.filled())
+      {
+        byStudy[study(entry)].push_back(entry.name);
+        ++nNeverFilled;
+      }
+    }
+
+    for(const auto& forStudy: byStudy)
+    {
+      os << "#" << forStudy.first << ": " << forStudy.second.size() << " histograms were never filled\n";
+      for(const auto& name: forStudy.second) os << name << "\n";
+    }
+
+    return nNeverFilled;
+  }
+
+  size_t MemoryBudget::bytes(const TH1& hist)
+  {
+    return hist.GetNcells() * sizeof(double) * (hist.GetSumw2N() > 0?2:1);
+  }
+
+  std::string MemoryBudget::study(const Entry& entry)
+  {
+    if(entry.path.empty()) return "(top level)";
+
+    std::string result = entry.path.front();
+    for(auto dir = std::next(entry.path.begin()); dir != entry.path.end(); ++dir) result += "/" + *dir;
+    return result;
+  }
+
+  std::string MemoryBudget::fiducial(const Entry& entry)
+  {
+    return entry.path.empty()?"(top level)":entry.path.front();
+  }
+}
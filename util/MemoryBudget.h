@@ -0,0 +1,69 @@
+//File: MemoryBudget.h
+//Brief: A MemoryBudget keeps track of every histogram a util::Directory make<>()s.
+//       Before the event loop, it can project how much memory a job's histograms
+//       will need once they're filled, broken down by Study, by Fiducial, and by
+//       error band.  After the event loop, it can list histograms that were never
+//       filled so that configurations can be pruned.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_MEMORYBUDGET_H
+#define UTIL_MEMORYBUDGET_H
+
+//c++ includes
+#include <map>
+#include <vector>
+#include <string>
+#include <functional>
+#include <ostream>
+
+class TH1;
+
+namespace util
+{
+  class MemoryBudget
+  {
+    public:
+      //Bytes one histogram needs for each error band, including "cv", once it's filled
+      using bands_t = std::map<std::string, size_t>;
+
+      //path is the names of the Directories a histogram was made in starting with its Fiducial.
+      //filled tells whether a histogram has been filled yet.  Leave it empty for objects
+      //that aren't supposed to be Fill()ed like flux integrals.
+      void add(const std::vector<std::string>& path, const std::string& name, bands_t&& bytes,
+               std::function<bool()>&& filled = std::function<bool()>());
+
+      //Histograms were made with fewer universes than a real job would have.  printProjection()
+      //multiplies each error band's bytes by its entry in scales.  Bands not in scales are left alone.
+      inline void scaleBands(const std::map<std::string, double>& scales) { fBandScales = scales; }
+
+      //Projected bytes per Study, per Fiducial, and per error band, biggest first
+      void printProjection(std::ostream& os) const;
+
+      //Check whether each histogram has been filled yet and remember the answer.  printNeverFilled()
+      //doesn't need the histograms themselves after this, so they can be written and deleted.
+      void freezeFilled();
+
+      //Names of histograms that were never filled grouped by Study.  Returns how many there were.
+      size_t printNeverFilled(std::ostream& os) const;
+
+      //Bytes a TH1 uses for its contents and sums of weights squared
+      static size_t bytes(const TH1& hist);
+
+    private:
+      struct Entry
+      {
+        std::vector<std::string> path;
+        std::string name;
+        bands_t bytes;
+        std::function<bool()> filled;
+      };
+
+      std::vector<Entry> fEntries;
+      std::map<std::string, double> fBandScales;
+
+      static std::string study(const Entry& entry);
+      static std::string fiducial(const Entry& entry);
+  };
+}
+
+#endif //UTIL_MEMORYBUDGET_H
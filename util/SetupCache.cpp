@@ -0,0 +1,129 @@
+//File: SetupCache.cpp
+//Brief: SetupCache keeps products of setting up a job on disk between jobs in one
+//       .root file per product named by a hash of everything it depends on.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "util/SetupCache.h"
+#include "util/Hash.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TNamed.h"
+#include "TH1.h"
+#include "TSystem.h"
+#include "TDirectory.h"
+
+//c++ includes
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+  //Names of the objects in each cache file
+  constexpr auto keyName = "key"; //Guards against hash collisions
+  constexpr auto objName = "name"; //Name of the cached object when it was store()d
+  constexpr auto productName = "product";
+
+  //Part of every key.  Change it when products that were already stored can't be trusted,
+  //like flux integrals from multiplePlaylists jobs before they checked that every playlist
+  //had the same flux.  Every file stored with the old version is just a cache miss after that.
+  constexpr auto formatVersion = "SetupCache format 2";
+
+  std::string versioned(const std::string& key)
+  {
+    return std::string(formatVersion) + "\n" + key;
+  }
+}
+
+namespace util
+{
+  std::string SetupCache::fDirectory;
+
+  void SetupCache::setDirectory(const std::string& directory)
+  {
+    fDirectory = directory;
+    if(enabled()) gSystem->mkdir(fDirectory.c_str(), true);
+  }
+
+  bool SetupCache::enabled()
+  {
+    return !fDirectory.empty();
+  }
+
+  std::string SetupCache::libraryTag()
+  {
+    #ifdef MAT_MINERVA_TAG
+      return "MAT-MINERvA " MAT_MINERVA_TAG;
+    #else
+      return "MAT-MINERvA unknown";
+    #endif
+  }
+
+  std::string SetupCache::fileName(const std::string& key)
+  {
+    return fDirectory + "/" + util::toHex(util::fnv1a(key)) + ".root";
+  }
+
+  TObject* SetupCache::find(const std::string& callerKey)
+  {
+    if(!enabled()) return nullptr;
+
+    const auto key = ::versioned(callerKey);
+    const auto name = fileName(key);
+    if(gSystem->AccessPathName(name.c_str())) return nullptr; //N.B.: AccessPathName() returns true when a file does NOT exist
+
+    TDirectory::TContext restoreDirectory; //Callers write to whatever directory was current before
+    try
+    {
+      std::unique_ptr<TFile> file(TFile::Open(name.c_str(), "READ"));
+      if(!file) return nullptr;
+
+      const auto storedKey = dynamic_cast<TNamed*>(file->Get(keyName));
+      const auto storedName = dynamic_cast<TNamed*>(file->Get(objName));
+      const auto product = file->Get(productName);
+      if(!storedKey || !storedName || !product || key != storedKey->GetTitle()) return nullptr;
+
+      auto copy = product->Clone(storedName->GetTitle());
+      if(auto hist = dynamic_cast<TH1*>(copy)) hist->SetDirectory(nullptr);
+      return copy;
+    }
+    catch(const std::exception& e)
+    {
+      std::cerr << "Ignoring cached setup product in " << name << " because I couldn't read it:\n" << e.what() << "\n";
+      return nullptr;
+    }
+  }
+
+  void SetupCache::store(const std::string& callerKey, const TObject& obj)
+  {
+    if(!enabled()) return;
+
+    const auto key = ::versioned(callerKey);
+
+    //Write somewhere else first so that other jobs sharing this directory never read a partial file
+    const auto name = fileName(key);
+    const auto tempName = name + "." + gSystem->HostName() + "." + std::to_string(gSystem->GetPid()) + ".tmp";
+
+    TDirectory::TContext restoreDirectory; //Callers write to whatever directory was current before
+    try
+    {
+      {
+        std::unique_ptr<TFile> file(TFile::Open(tempName.c_str(), "RECREATE"));
+        if(!file) return;
+
+        TNamed(keyName, key.c_str()).Write();
+        TNamed(objName, obj.GetName()).Write();
+        obj.Write(productName);
+      }
+
+      if(gSystem->Rename(tempName.c_str(), name.c_str())) gSystem->Unlink(tempName.c_str());
+    }
+    catch(const std::exception& e)
+    {
+      std::cerr << "Failed to cache a setup product in " << name << ":\n" << e.what() << "\nIt will be recalculated next time.\n";
+      gSystem->Unlink(tempName.c_str());
+    }
+  }
+}
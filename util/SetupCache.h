@@ -0,0 +1,58 @@
+//File: SetupCache.h
+//Brief: Products of setting up a job, like flux integrals and numbers of nucleons,
+//       only depend on things like playlist, binning, and geometry.  SetupCache keeps
+//       them on disk between jobs in one .root file per product named by a hash of
+//       everything it depends on.  Callers describe those inputs in a key string and
+//       check the cache before calculating anything.
+//
+//       The cache is off until setDirectory() is called.  A key that's not in the
+//       cache, or a file that can't be read, is never an error.  The caller just
+//       calculates the product like usual and store()s it for the next job.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_SETUPCACHE_H
+#define UTIL_SETUPCACHE_H
+
+//ROOT includes
+#include "TObject.h"
+
+//c++ includes
+#include <string>
+
+namespace util
+{
+  class SetupCache
+  {
+    public:
+      //Turn the cache on and keep it in directory.  An empty directory turns it off.
+      static void setDirectory(const std::string& directory);
+
+      static bool enabled();
+
+      //Which MAT-MINERvA this package was built against.  Put it in the key of
+      //anything that comes from MAT-MINERvA, like flux integrals and numbers of nucleons.
+      static std::string libraryTag();
+
+      //A new copy of the object stored with key, or nullptr if there isn't one.
+      //The caller owns it.
+      template <class T>
+      static T* get(const std::string& key)
+      {
+        auto obj = find(key);
+        auto typed = dynamic_cast<T*>(obj);
+        if(!typed) delete obj;
+        return typed;
+      }
+
+      //Save a copy of obj for future jobs.  Safe for several jobs sharing a directory.
+      static void store(const std::string& key, const TObject& obj);
+
+    private:
+      static TObject* find(const std::string& key);
+
+      static std::string fileName(const std::string& key);
+      static std::string fDirectory;
+  };
+}
+
+#endif //UTIL_SETUPCACHE_H
@@ -0,0 +1,103 @@
+//File: UniformInterpolation.cpp
+//Brief: A linear interpolation sampled on a uniform grid of keys.  Finding the
+//       neighboring points is a single multiplication instead of a tree search,
+//       and all values live in one contiguous block of memory.  Can be saved to
+//       and loaded from a binary file so that resampling only happens once.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Local includes
+#include "util/UniformInterpolation.h"
+#include "util/Interpolation.h"
+
+//c++ includes
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+  //Binary layout: magic, number of values as uint64_t, min, max, then the values.
+  //Everything is in the native byte order of the machine that wrote the file.
+  //Bump the last character if the layout ever changes.
+  constexpr char magic[] = "UNIFINT1";
+  constexpr size_t magicLength = sizeof(magic) - 1;
+}
+
+namespace util
+{
+  UniformInterpolation::UniformInterpolation(const Interpolation& source, const size_t nPoints): fMin(0)
+  {
+    if(source.empty()) throw std::runtime_error("UniformInterpolation: asked to resample an empty table.");
+    if(nPoints < 2) throw std::runtime_error("UniformInterpolation: need at least 2 points to interpolate.");
+
+    fMin = source.minKey();
+    const double max = source.maxKey(),
+                 step = (max - fMin) / (nPoints - 1);
+
+    fValues.reserve(nPoints);
+    fValues.push_back(source.minValue()); //source[fMin] would be 1
+    for(size_t whichPoint = 1; whichPoint < nPoints - 1; ++whichPoint) fValues.push_back(source[fMin + whichPoint * step]);
+    fValues.push_back(source[max]); //Don't let rounding push the last key past the end of source
+
+    fInverseStep = 1./step;
+    fMaxPosition = nPoints - 1;
+    checkValues();
+  }
+
+  UniformInterpolation::UniformInterpolation(const double min, const double max, std::vector<double>&& values): fMin(min), fValues(std::move(values))
+  {
+    fInverseStep = (fValues.size() - 1) / (max - min);
+    fMaxPosition = fValues.size() - 1;
+    checkValues();
+  }
+
+  UniformInterpolation::UniformInterpolation(std::istream& binaryFile)
+  {
+    char fileMagic[magicLength];
+    uint64_t nValues = 0;
+    double max = 0;
+
+    binaryFile.read(fileMagic, magicLength);
+    if(!binaryFile || std::strncmp(fileMagic, magic, magicLength) != 0) throw std::runtime_error("UniformInterpolation: not a uniform interpolation table.  Maybe it was written by a different version of this code?");
+
+    binaryFile.read(reinterpret_cast<char*>(&nValues), sizeof(nValues));
+    binaryFile.read(reinterpret_cast<char*>(&fMin), sizeof(fMin));
+    binaryFile.read(reinterpret_cast<char*>(&max), sizeof(max));
+    if(!binaryFile) throw std::runtime_error("UniformInterpolation: table ends in the middle of its header.");
+
+    fValues.resize(nValues);
+    binaryFile.read(reinterpret_cast<char*>(fValues.data()), nValues * sizeof(double));
+    if(!binaryFile) throw std::runtime_error("UniformInterpolation: expected " + std::to_string(nValues) + " values, but the table ended early.");
+
+    fInverseStep = (nValues - 1) / (max - fMin);
+    fMaxPosition = nValues - 1;
+    checkValues();
+  }
+
+  UniformInterpolation::UniformInterpolation(): UniformInterpolation(0, 1, {1, 1})
+  {
+  }
+
+  void UniformInterpolation::write(std::ostream& binaryFile) const
+  {
+    const uint64_t nValues = fValues.size();
+    const double max = fMin + fMaxPosition / fInverseStep;
+
+    binaryFile.write(magic, magicLength);
+    binaryFile.write(reinterpret_cast<const char*>(&nValues), sizeof(nValues));
+    binaryFile.write(reinterpret_cast<const char*>(&fMin), sizeof(fMin));
+    binaryFile.write(reinterpret_cast<const char*>(&max), sizeof(max));
+    binaryFile.write(reinterpret_cast<const char*>(fValues.data()), nValues * sizeof(double));
+  }
+
+  size_t UniformInterpolation::size() const
+  {
+    return fValues.size();
+  }
+
+  void UniformInterpolation::checkValues() const
+  {
+    if(fValues.size() < 2) throw std::runtime_error("UniformInterpolation: need at least 2 points to interpolate, but got " + std::to_string(fValues.size()) + ".");
+    if(!(fInverseStep > 0)) throw std::runtime_error("UniformInterpolation: the largest key must be greater than the smallest key.");
+  }
+}
@@ -0,0 +1,62 @@
+//File: UniformInterpolation.h
+//Brief: A linear interpolation sampled on a uniform grid of keys.  Finding the
+//       neighboring points is a single multiplication instead of a tree search,
+//       and all values live in one contiguous block of memory.  Can be saved to
+//       and loaded from a binary file so that resampling only happens once.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef UTIL_UNIFORMINTERPOLATION_H
+#define UTIL_UNIFORMINTERPOLATION_H
+
+//c++ includes
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+namespace util
+{
+  class Interpolation;
+
+  class UniformInterpolation
+  {
+    public:
+      //Resample an arbitrary table onto nPoints evenly spaced keys between its first and last keys.
+      UniformInterpolation(const Interpolation& source, const size_t nPoints);
+
+      //Adopt values that were already calculated at evenly spaced keys from min to max inclusive.
+      UniformInterpolation(const double min, const double max, std::vector<double>&& values);
+
+      //Read a table written by write().  Throws std::runtime_error on a malformed file.
+      UniformInterpolation(std::istream& binaryFile);
+
+      //A UniformInterpolation that always returns 1
+      UniformInterpolation();
+
+      //Same out of range behavior as Interpolation: 1 outside [min, max].
+      inline double operator [](const double key) const
+      {
+        const double position = (key - fMin) * fInverseStep;
+        if(!(position >= 0) || position > fMaxPosition) return 1;
+
+        //position == fMaxPosition would read past the end of fValues, so let the last bin handle it
+        const size_t lower = std::min(static_cast<size_t>(position), fValues.size() - 2);
+        const double fraction = position - lower;
+        return fValues[lower] + fraction * (fValues[lower + 1] - fValues[lower]);
+      }
+
+      void write(std::ostream& binaryFile) const;
+
+      size_t size() const;
+
+    private:
+      double fMin;
+      double fInverseStep;
+      double fMaxPosition; //fValues.size() - 1 as a double so operator [] doesn't have to convert it
+      std::vector<double> fValues;
+
+      void checkValues() const;
+  };
+}
+
+#endif //UTIL_UNIFORMINTERPOLATION_H
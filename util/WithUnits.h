@@ -13,6 +13,10 @@
 #include "PlotUtils/Hist2DWrapper.h"
 #include "PlotUtils/Model.h"
 
+//util includes
+#include "util/FlatHistWrapper.h"
+#include "util/BatchModel.h"
+
 //unit library includes
 #include "units/units.h"
 
@@ -192,10 +196,11 @@ namespace units
         assert(!univs.empty());
         const int whichBin = Base_t::univHist(univs.front())->FindBin(value.template in<XUNIT>());
 
-        for(const auto univ: univs)
+        util::getWeights(model, univs, evt, fWeights);
+        for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv)
         {
-          auto hist = Base_t::univHist(univ);
-          const double weight = model.GetWeight(*univ, evt);
+          auto hist = Base_t::univHist(univs[whichUniv]);
+          const double weight = fWeights[whichUniv];
           hist->AddBinContent(whichBin, weight);
           hist->SetEntries(hist->GetEntries()+1);
 
@@ -211,6 +216,9 @@ namespace units
       {
         Base_t::hist->SetDirectory(dir);
       }
+
+    private:
+      std::vector<double> fWeights; //Weights for the universes in the last Fill().  Kept so Fill() doesn't allocate.
   };
 
 
@@ -255,10 +263,11 @@ namespace units
         assert(!univs.empty());
         const int whichBin = Base_t::univHist(univs.front())->FindBin(x.template in<XUNIT>(), y.template in<YUNIT>());
                                                                                                                            
-        for(const auto univ: univs)
+        util::getWeights(model, univs, evt, fWeights);
+        for(size_t whichUniv = 0; whichUniv < univs.size(); ++whichUniv)
         {
-          auto hist = Base_t::univHist(univ);
-          const double weight = model.GetWeight(*univ, evt);
+          auto hist = Base_t::univHist(univs[whichUniv]);
+          const double weight = fWeights[whichUniv];
           hist->AddBinContent(whichBin, weight);
           hist->SetEntries(hist->GetEntries()+1);
                                                                                                                            
@@ -274,6 +283,82 @@ namespace units
       {
         Base_t::hist->SetDirectory(dir);
       }
+
+    private:
+      std::vector<double> fWeights; //Weights for the universes in the last Fill().  Kept so Fill() doesn't allocate.
+  };
+
+  //Specialization to use with util::FlatHistWrapper<>
+  template <class UNIV, class SUM, class XUNIT, class YUNIT>
+  class WithUnits<util::FlatHistWrapper<UNIV, SUM>, XUNIT, YUNIT>: public util::FlatHistWrapper<UNIV, SUM>
+  {
+    private:
+      using Base_t = util::FlatHistWrapper<UNIV, SUM>;
+
+    public:
+      template <class ...ARGS>
+      WithUnits(ARGS... args): Base_t(args...)
+      {
+        Base_t::hist->GetXaxis()->SetTitle((std::string(Base_t::hist->GetXaxis()->GetTitle()) + " [" + detail::unit<XUNIT>::name() + "]").c_str());
+        Base_t::hist->GetYaxis()->SetTitle((std::string(Base_t::hist->GetYaxis()->GetTitle()) + " [" + detail::unit<YUNIT>::name() + "]").c_str());
+      }
+
+      virtual ~WithUnits() = default;
+
+      template <class OTHERX>
+      int Fill(const UNIV* univ, const OTHERX value)
+      {
+        return Base_t::Fill(univ, value.template in<XUNIT>());
+      }
+
+      template <class OTHERX, class OTHERY>
+      int Fill(const UNIV* univ, const OTHERX value, const OTHERY weight)
+      {
+        return Base_t::Fill(univ, value.template in<XUNIT>(), weight.template in<YUNIT>());
+      }
+
+      template <class OTHERX, class EVENT>
+      int Fill(const std::vector<UNIV*>& univs, const OTHERX value, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        return Base_t::Fill(univs, value.template in<XUNIT>(), model, evt);
+      }
+  };
+
+  //Specialization to use with util::FlatHist2DWrapper<>
+  template <class UNIV, class SUM, class XUNIT, class YUNIT, class ZUNIT>
+  class WithUnits<util::FlatHist2DWrapper<UNIV, SUM>, XUNIT, YUNIT, ZUNIT>: public util::FlatHist2DWrapper<UNIV, SUM>
+  {
+    private:
+      using Base_t = util::FlatHist2DWrapper<UNIV, SUM>;
+
+    public:
+      template <class ...ARGS>
+      WithUnits(ARGS... args): Base_t(args...)
+      {
+        Base_t::hist->GetXaxis()->SetTitle((std::string(Base_t::hist->GetXaxis()->GetTitle()) + " [" + detail::unit<XUNIT>::name() + "]").c_str());
+        Base_t::hist->GetYaxis()->SetTitle((std::string(Base_t::hist->GetYaxis()->GetTitle()) + " [" + detail::unit<YUNIT>::name() + "]").c_str());
+        Base_t::hist->GetZaxis()->SetTitle((std::string(Base_t::hist->GetZaxis()->GetTitle()) + " [" + detail::unit<ZUNIT>::name() + "]").c_str());
+      }
+
+      virtual ~WithUnits() = default;
+
+      template <class OTHERX, class OTHERY>
+      int Fill(const UNIV* univ, const OTHERX x, const OTHERY y)
+      {
+        return Base_t::Fill(univ, x.template in<XUNIT>(), y.template in<YUNIT>());
+      }
+
+      template <class OTHERX, class OTHERY, class OTHERZ>
+      int Fill(const UNIV* univ, const OTHERX x, const OTHERY y, const OTHERZ weight)
+      {
+        return Base_t::Fill(univ, x.template in<XUNIT>(), y.template in<YUNIT>(), weight.template in<ZUNIT>());
+      }
+
+      template <class OTHERX, class OTHERY, class EVENT>
+      int Fill(const std::vector<UNIV*>& univs, const OTHERX x, const OTHERY y, const PlotUtils::Model<UNIV>& model, const EVENT& evt)
+      {
+        return Base_t::Fill(univs, x.template in<XUNIT>(), y.template in<YUNIT>(), model, evt);
+      }
   };
 }
 